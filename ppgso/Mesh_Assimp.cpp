@@ -76,6 +76,14 @@ void ppgso::Mesh_Assimp::processMesh(aiMesh *mesh) {
         // Enable and set up vertex attribute pointer for positions
         glEnableVertexAttribArray(0);
         glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+        // Grow the bounding box (node transforms are not applied, same as the vertex data)
+        for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+            glm::vec3 position(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
+            boundsMin = hasBounds ? glm::min(boundsMin, position) : position;
+            boundsMax = hasBounds ? glm::max(boundsMax, position) : position;
+            hasBounds = true;
+        }
     }
 
     // Process texture coordinates
@@ -139,3 +147,32 @@ void ppgso::Mesh_Assimp::render() {
         glDrawElements(GL_TRIANGLES, buffer.size, GL_UNSIGNED_INT, nullptr);
     }
 }
+
+void ppgso::Mesh_Assimp::setInstanceBuffer(GLuint instanceBuffer, GLuint location, size_t offset) {
+    instanceLocation = (GLint) location;
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    for (auto &buffer : buffers) {
+        glBindVertexArray(buffer.vao);
+
+        // One mat4 per instance, a column per attribute
+        for (GLuint column = 0; column < 4; column++) {
+            glVertexAttribPointer(location + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                                  (const void *) (offset + column * sizeof(glm::vec4)));
+            glVertexAttribDivisor(location + column, 1);
+        }
+    }
+}
+
+void ppgso::Mesh_Assimp::renderInstanced(GLsizei count) {
+    if (instanceLocation < 0) return;
+
+    for (auto &buffer : buffers) {
+        glBindVertexArray(buffer.vao);
+
+        // Instance attributes are off again after the draw, so plain renders of the mesh
+        // do not read matrices from a buffer that may have been overwritten since
+        for (GLuint column = 0; column < 4; column++) glEnableVertexAttribArray(instanceLocation + column);
+        glDrawElementsInstanced(GL_TRIANGLES, buffer.size, GL_UNSIGNED_INT, nullptr, count);
+        for (GLuint column = 0; column < 4; column++) glDisableVertexAttribArray(instanceLocation + column);
+    }
+}
@@ -35,6 +35,13 @@ namespace ppgso {
         std::vector<glm::vec3> diffuse;
         std::vector<glm::vec3> specular;
 
+        // Model space bounding box, hasBounds until the first vertex
+        glm::vec3 boundsMin{0.0f}, boundsMax{0.0f};
+        bool hasBounds = false;
+
+        // First attribute of the instance matrix, enabled only while renderInstanced draws
+        GLint instanceLocation = -1;
+
     public:
 
         /*!
@@ -59,6 +66,31 @@ namespace ppgso {
          * Render the geometry associated with the mesh using glDrawElements.
          */
         void render();
+
+        /*!
+         * Read per instance model matrices from a buffer, for renderInstanced.
+         * Matrix columns are vertex attributes location .. location + 3 with divisor 1.
+         * The attributes are only enabled during renderInstanced, render() never sees them.
+         *
+         * @param buffer - Buffer with tightly packed glm::mat4 values.
+         * @param location - First attribute location of the matrix.
+         * @param offset - Byte offset of the first instance in the buffer.
+         */
+        void setInstanceBuffer(GLuint buffer, GLuint location, size_t offset = 0);
+
+        /*!
+         * Render the geometry count times using glDrawElementsInstanced.
+         *
+         * @param count - Number of instances.
+         */
+        void renderInstanced(GLsizei count);
+
+        /*!
+         * Axis aligned bounding box of all vertex positions in model space.
+         * Both corners are zero for a mesh without vertices.
+         */
+        const glm::vec3& getBoundsMin() const { return boundsMin; }
+        const glm::vec3& getBoundsMax() const { return boundsMax; }
     };
 }
 
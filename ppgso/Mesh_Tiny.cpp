@@ -19,6 +19,18 @@ ppgso::Mesh_Tiny::Mesh_Tiny(const std::string &obj_file) {
     throw std::runtime_error(msg.str());
   }
 
+  // Bounding box of all shapes
+  bool first = true;
+  for(auto& shape : shapes) {
+    auto& positions = shape.mesh.positions;
+    for(size_t i = 0; i + 2 < positions.size(); i += 3) {
+      glm::vec3 position{positions[i], positions[i + 1], positions[i + 2]};
+      boundsMin = first ? position : glm::min(boundsMin, position);
+      boundsMax = first ? position : glm::max(boundsMax, position);
+      first = false;
+    }
+  }
+
   // Initialize OpenGL Buffers
   for(auto& shape : shapes) {
     gl_buffer buffer;
@@ -89,3 +101,32 @@ void ppgso::Mesh_Tiny::render() {
     glDrawElements(GL_TRIANGLES, buffer.size, GL_UNSIGNED_INT, nullptr);
   }
 }
+
+void ppgso::Mesh_Tiny::setInstanceBuffer(GLuint instanceBuffer, GLuint location, size_t offset) {
+  instanceLocation = (GLint) location;
+  glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+  for(auto& buffer : buffers) {
+    glBindVertexArray(buffer.vao);
+
+    // One mat4 per instance, a column per attribute
+    for(GLuint column = 0; column < 4; column++) {
+      glVertexAttribPointer(location + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                            (const void *) (offset + column * sizeof(glm::vec4)));
+      glVertexAttribDivisor(location + column, 1);
+    }
+  }
+}
+
+void ppgso::Mesh_Tiny::renderInstanced(GLsizei count) {
+  if (instanceLocation < 0) return;
+
+  for(auto& buffer : buffers) {
+    glBindVertexArray(buffer.vao);
+
+    // Instance attributes are off again after the draw, so plain renders of the mesh
+    // do not read matrices from a buffer that may have been overwritten since
+    for(GLuint column = 0; column < 4; column++) glEnableVertexAttribArray(instanceLocation + column);
+    glDrawElementsInstanced(GL_TRIANGLES, buffer.size, GL_UNSIGNED_INT, nullptr, count);
+    for(GLuint column = 0; column < 4; column++) glDisableVertexAttribArray(instanceLocation + column);
+  }
+}
@@ -24,6 +24,10 @@ namespace ppgso {
     std::vector<tinyobj::shape_t> shapes;
     std::vector<tinyobj::material_t> materials;
     std::vector<gl_buffer> buffers;
+    glm::vec3 boundsMin{0.0f}, boundsMax{0.0f};
+
+    // First attribute of the instance matrix, enabled only while renderInstanced draws
+    GLint instanceLocation = -1;
 
   public:
 
@@ -45,6 +49,31 @@ namespace ppgso {
      * Render the geometry associated with the mesh using glDrawElements.
      */
     void render();
+
+    /*!
+     * Read per instance model matrices from a buffer, for renderInstanced.
+     * Matrix columns are vertex attributes location .. location + 3 with divisor 1.
+     * The attributes are only enabled during renderInstanced, render() never sees them.
+     *
+     * @param buffer - Buffer with tightly packed glm::mat4 values.
+     * @param location - First attribute location of the matrix.
+     * @param offset - Byte offset of the first instance in the buffer.
+     */
+    void setInstanceBuffer(GLuint buffer, GLuint location, size_t offset = 0);
+
+    /*!
+     * Render the geometry count times using glDrawElementsInstanced.
+     *
+     * @param count - Number of instances.
+     */
+    void renderInstanced(GLsizei count);
+
+    /*!
+     * Axis aligned bounding box of all vertex positions in model space.
+     * Both corners are zero for a mesh without vertices.
+     */
+    const glm::vec3& getBoundsMin() const { return boundsMin; }
+    const glm::vec3& getBoundsMax() const { return boundsMax; }
   };
 }
 
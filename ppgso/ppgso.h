@@ -24,6 +24,7 @@ namespace ppgso {
 #include "image_raw.h"
 #include "texture.h"
 #include "window.h"
+#include "timing.h"
 
 namespace ppgso {
   /*!
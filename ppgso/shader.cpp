@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
@@ -9,7 +10,8 @@
 #include "shader.h"
 
 
-ppgso::Shader::Shader(const std::string &vertex_shader_code, const std::string &fragment_shader_code) {
+ppgso::Shader::Shader(const std::string &vertex_shader_code, const std::string &fragment_shader_code,
+                      const std::vector<std::string> &feedback_varyings) {
   // Create shaders
   auto vertex_shader_id = glCreateShader(GL_VERTEX_SHADER);
   auto fragment_shader_id = glCreateShader(GL_FRAGMENT_SHADER);
@@ -57,6 +59,14 @@ ppgso::Shader::Shader(const std::string &vertex_shader_code, const std::string &
   glAttachShader(program_id, vertex_shader_id);
   glAttachShader(program_id, fragment_shader_id);
   glBindFragDataLocation(program_id, 0, "FragmentColor");
+
+  // Transform feedback outputs have to be declared before linking
+  if (!feedback_varyings.empty()) {
+    std::vector<const char *> varyings;
+    for (auto &varying : feedback_varyings) varyings.push_back(varying.c_str());
+    glTransformFeedbackVaryings(program_id, (GLsizei) varyings.size(), varyings.data(), GL_INTERLEAVED_ATTRIBS);
+  }
+
   glLinkProgram(program_id);
 
   // Check program log
@@ -74,82 +84,186 @@ ppgso::Shader::Shader(const std::string &vertex_shader_code, const std::string &
   glDeleteShader(fragment_shader_id);
 
   program = program_id;
+  introspectUniforms();
   use();
 }
 
 ppgso::Shader::~Shader() {
+  // The name of a deleted program can be reused, so it must not stay marked as current
+  if (currentProgram == program) {
+    glUseProgram(0);
+    currentProgram = 0;
+  }
   glDeleteProgram( program );
 }
 
-void ppgso::Shader::use() const {
+GLuint ppgso::Shader::currentProgram = 0;
+ppgso::Shader::Stats ppgso::Shader::stats;
+
+void ppgso::Shader::introspectUniforms() {
+  GLint count = 0, max_length = 0;
+  glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+  glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+  std::vector<char> buffer((size_t) std::max(max_length, 1));
+
+  for (GLint i = 0; i < count; i++) {
+    GLint size = 0;
+    GLenum type = 0;
+    GLsizei length = 0;
+    glGetActiveUniform(program, (GLuint) i, (GLsizei) buffer.size(), &length, &size, &type, buffer.data());
+    std::string name(buffer.data(), (size_t) length);
+
+    // Members of uniform blocks have no location
+    auto location = glGetUniformLocation(program, name.c_str());
+    stats.locationQueries++;
+    if (location < 0) continue;
+    uniforms[name] = location;
+
+    // Arrays are reported as "name[0]", register the bare name and every element too
+    if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+      auto base = name.substr(0, name.size() - 3);
+      uniforms[base] = location;
+      for (GLint element = 1; element < size; element++) {
+        auto element_name = base + "[" + std::to_string(element) + "]";
+        auto element_location = glGetUniformLocation(program, element_name.c_str());
+        stats.locationQueries++;
+        if (element_location >= 0) uniforms[element_name] = element_location;
+      }
+    }
+  }
+}
+
+GLint ppgso::Shader::findUniform(const std::string &name) const {
+  auto it = uniforms.find(name);
+  return it == uniforms.end() ? -1 : it->second;
+}
+
+void ppgso::Shader::bind() const {
+  if (currentProgram == program) return;
   glUseProgram(program);
+  currentProgram = program;
+  stats.programSwitches++;
+}
+
+void ppgso::Shader::use() const {
+  stats.useCalls++;
+  bind();
+}
+
+void ppgso::Shader::invalidateCurrentProgram() {
+  currentProgram = 0;
+}
+
+const ppgso::Shader::Stats &ppgso::Shader::getStats() {
+  return stats;
+}
+
+void ppgso::Shader::resetStats() {
+  stats = Stats();
 }
 
 GLuint ppgso::Shader::getAttribLocation(const std::string &name) const {
-  use();
   return (GLuint) glGetAttribLocation(program, name.c_str());
 }
 
 GLuint ppgso::Shader::getUniformLocation(const std::string &name) const {
-  use();
-  return (GLuint) glGetUniformLocation(program, name.c_str());
+  return (GLuint) findUniform(name);
+}
+
+GLuint ppgso::Shader::getProgram() const {
+  return program;
+}
+
+void ppgso::Shader::upload(GLint location, float value) {
+  glUniform1f(location, value);
+}
+
+void ppgso::Shader::upload(GLint location, int value) {
+  glUniform1i(location, value);
+}
+
+void ppgso::Shader::upload(GLint location, bool value) {
+  glUniform1i(location, value ? 1 : 0);
+}
+
+void ppgso::Shader::upload(GLint location, const glm::vec2 &vector) {
+  glUniform2fv(location, 1, value_ptr(vector));
+}
+
+void ppgso::Shader::upload(GLint location, const glm::vec3 &vector) {
+  glUniform3fv(location, 1, value_ptr(vector));
+}
+
+void ppgso::Shader::upload(GLint location, const glm::vec4 &vector) {
+  glUniform4fv(location, 1, value_ptr(vector));
+}
+
+void ppgso::Shader::upload(GLint location, const glm::mat3 &matrix) {
+  glUniformMatrix3fv(location, 1, GL_FALSE, value_ptr(matrix));
+}
+
+void ppgso::Shader::upload(GLint location, const glm::mat4 &matrix) {
+  glUniformMatrix4fv(location, 1, GL_FALSE, value_ptr(matrix));
 }
 
 void ppgso::Shader::setUniform(const std::string &name, const Texture &texture, const int id) const {
-  use();
-  auto uniform = getUniformLocation(name.c_str());
-  glUniform1i(uniform, id);
+  stats.namedSets++;
+  bind();
+  upload(findUniform(name), id);
   texture.bind(id);
 }
 
 void ppgso::Shader::setUniform(const std::string &name, glm::mat4 matrix) const {
-  use();
-  auto uniform = getUniformLocation(name.c_str());
-  glUniformMatrix4fv(uniform, 1, GL_FALSE, value_ptr(matrix));
+  stats.namedSets++;
+  bind();
+  upload(findUniform(name), matrix);
 }
 
 void ppgso::Shader::setUniform(const std::string &name, glm::mat3 matrix) const {
-  use();
-  auto uniform = getUniformLocation(name.c_str());
-  glUniformMatrix3fv(uniform, 1, GL_FALSE, value_ptr(matrix));
+  stats.namedSets++;
+  bind();
+  upload(findUniform(name), matrix);
 }
 
 void ppgso::Shader::setUniform(const std::string &name, float value) const {
-  use();
-  auto uniform = getUniformLocation(name.c_str());
-  glUniform1f(uniform, value);
-}
-
-GLuint ppgso::Shader::getProgram() const {
-  return program;
+  stats.namedSets++;
+  bind();
+  upload(findUniform(name), value);
 }
 
 void ppgso::Shader::setUniform(const std::string &name, glm::vec2 vector) const {
-  use();
-  auto uniform = getUniformLocation(name.c_str());
-  glUniform2fv(uniform, 1, value_ptr(vector));
+  stats.namedSets++;
+  bind();
+  upload(findUniform(name), vector);
 }
 
 void ppgso::Shader::setUniform(const std::string &name, glm::vec3 vector) const {
-  use();
-  auto uniform = getUniformLocation(name.c_str());
-  glUniform3fv(uniform, 1, value_ptr(vector));
+  stats.namedSets++;
+  bind();
+  upload(findUniform(name), vector);
 }
 
 void ppgso::Shader::setUniform(const std::string &name, glm::vec4 vector) const {
-  use();
-  auto uniform = getUniformLocation(name.c_str());
-  glUniform4fv(uniform, 1, value_ptr(vector));
+  stats.namedSets++;
+  bind();
+  upload(findUniform(name), vector);
 }
 
 void ppgso::Shader::setUniform(const std::string &name, int value) const {
-  use();
-  auto uniform = getUniformLocation(name.c_str());
-  glUniform1i(uniform, value);
+  stats.namedSets++;
+  bind();
+  upload(findUniform(name), value);
 }
 
 void ppgso::Shader::setUniform(const std::string &name, bool value) const {
-  use();
-  auto uniform = getUniformLocation(name.c_str());
-  glUniform1i(uniform, value ? 1 : 0);
+  stats.namedSets++;
+  bind();
+  upload(findUniform(name), value);
+}
+
+bool ppgso::Shader::setUniformBlockBinding(const std::string &name, GLuint binding) const {
+  auto index = glGetUniformBlockIndex(program, name.c_str());
+  if (index == GL_INVALID_INDEX) return false;
+  glUniformBlockBinding(program, index, binding);
+  return true;
 }
@@ -1,6 +1,8 @@
 #pragma once
 #include <string>
 #include <memory>
+#include <vector>
+#include <unordered_map>
 
 #include <GL/glew.h>
 #include <glm/glm.hpp>
@@ -12,21 +14,66 @@ namespace ppgso {
   class Shader {
   public:
 
+    /*!
+     * Uniform location resolved once, for setting values in hot loops without any name lookup.
+     * Like setUniform, setting a uniform the program does not have is silently ignored.
+     */
+    template<typename T>
+    class Uniform {
+    public:
+      Uniform() = default;
+
+      /*!
+       * Make the owning program current (if it is not already) and upload the value.
+       *
+       * @param value - Value to set the uniform to.
+       */
+      void set(const T &value) const;
+
+      bool isValid() const { return location >= 0; }
+
+    private:
+      friend class Shader;
+      Uniform(const Shader *shader, GLint location) : shader(shader), location(location) {}
+
+      const Shader *shader = nullptr;
+      GLint location = -1;
+    };
+
+    /*!
+     * GL calls issued by all shaders since the last resetStats().
+     */
+    struct Stats {
+      size_t useCalls = 0;          // Explicit use() calls
+      size_t namedSets = 0;         // setUniform calls (looked up by name in the cache)
+      size_t handleSets = 0;        // Uniform<T>::set calls
+      size_t programSwitches = 0;   // glUseProgram actually issued
+      size_t locationQueries = 0;   // glGetUniformLocation issued (only while linking)
+    };
+
     /*!
      * Compile and manage an GLSL program and its inputs.
      *
      * @param vertex_shader_code - String containing the source of the vertex shader.
      * @param fragment_shader_code - String containing the source of the fragment shader.
+     * @param feedback_varyings - Vertex shader outputs captured (interleaved) when transform feedback is active.
      */
-    Shader(const std::string &vertex_shader_code, const std::string &fragment_shader_code);
+    Shader(const std::string &vertex_shader_code, const std::string &fragment_shader_code,
+           const std::vector<std::string> &feedback_varyings = {});
 
     ~Shader();
 
     /*!
      * Set up the program for use in OpenGL state.
+     * glUseProgram is skipped when the program is already current.
      */
     void use() const;
 
+    /*!
+     * Forget which program is current, for code that calls glUseProgram directly.
+     */
+    static void invalidateCurrentProgram();
+
     /*!
      * Get OpenGL attribute location for for the input specified by "name"
      *
@@ -37,12 +84,24 @@ namespace ppgso {
 
     /*!
      * Get OpenGL uniform location for for the input specified by "name"
+     * Locations of all active uniforms are cached when the program is linked.
      *
      * @param name - Name of the shader program input variable.
      * @return - OpenGL attribute location number.
      */
     GLuint getUniformLocation(const std::string &name) const;
 
+    /*!
+     * Get a typed handle for the uniform "name"
+     *
+     * @param name - Name of the shader program uniform input variable.
+     * @return - Handle, invalid when the program has no active uniform of that name.
+     */
+    template<typename T>
+    Uniform<T> getUniform(const std::string &name) const {
+      return Uniform<T>(this, findUniform(name));
+    }
+
     /*!
      * Get OpenGL program identifier number.
      *
@@ -110,9 +169,52 @@ namespace ppgso {
     void setUniform(const std::string &name, int value) const;
     void setUniform(const std::string &name, bool value) const;
 
+    /*!
+     * Connect the uniform block "name" to a uniform buffer binding point
+     *
+     * @param name - Name of the uniform block in the shader program.
+     * @param binding - Binding point the buffer is attached to with glBindBufferBase.
+     * @return - False when the program has no active block of that name.
+     */
+    bool setUniformBlockBinding(const std::string &name, GLuint binding) const;
+
+    /*!
+     * Counters of GL calls issued by all shaders, for comparing frames.
+     */
+    static const Stats &getStats();
+    static void resetStats();
+
   private:
     GLuint program;
+
+    // Active uniform locations by name, filled once after linking
+    std::unordered_map<std::string, GLint> uniforms;
+
+    // Program current in the (single) GL context used by ppgso
+    static GLuint currentProgram;
+    static Stats stats;
+
+    void introspectUniforms();
+    GLint findUniform(const std::string &name) const;
+    void bind() const;
+
+    static void upload(GLint location, float value);
+    static void upload(GLint location, int value);
+    static void upload(GLint location, bool value);
+    static void upload(GLint location, const glm::vec2 &vector);
+    static void upload(GLint location, const glm::vec3 &vector);
+    static void upload(GLint location, const glm::vec4 &vector);
+    static void upload(GLint location, const glm::mat3 &matrix);
+    static void upload(GLint location, const glm::mat4 &matrix);
   };
 
+  template<typename T>
+  void Shader::Uniform<T>::set(const T &value) const {
+    if (location < 0) return;
+    Shader::stats.handleSets++;
+    shader->bind();
+    Shader::upload(location, value);
+  }
+
 }
 
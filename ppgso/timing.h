@@ -0,0 +1,22 @@
+#pragma once
+#include <chrono>
+#include <ratio>
+#include <utility>
+
+namespace ppgso {
+
+  /*!
+   * Run work repeatedly and measure the average time of one run, for benchmarks.
+   *
+   * @param repeats - Number of runs, work is called with the index of the run.
+   * @param work - Callable taking the run index (int).
+   * @return Average time of one run in Unit (milliseconds by default, std::micro for microseconds).
+   */
+  template<typename Unit = std::milli, typename Work>
+  float averageTime(int repeats, Work &&work) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < repeats; i++) work(i);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<float, Unit>(end - start).count() / repeats;
+  }
+}
@@ -0,0 +1,13 @@
+#version 330 core
+
+in vec3 vNormal;
+
+uniform vec3 color;
+
+out vec4 FragColor;
+
+void main() {
+    vec3 lightDir = normalize(vec3(0.3, 1.0, 0.5));
+    float diff = max(dot(normalize(vNormal), lightDir), 0.0);
+    FragColor = vec4(color * (0.4 + 0.6*diff), 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#version 330 core
+
+layout(location = 0) in vec3 inPos;
+layout(location = 2) in vec3 inNormal;
+
+// Model matrix of the instance (locations 3 - 6, one per instance)
+layout(location = 3) in mat4 instanceMatrix;
+
+uniform mat4 viewMatrix;
+uniform mat4 projectionMatrix;
+
+out vec3 vNormal;
+
+void main() {
+    vNormal = mat3(transpose(inverse(instanceMatrix))) * inNormal;
+    gl_Position = projectionMatrix * viewMatrix * instanceMatrix * vec4(inPos, 1.0);
+}
\ No newline at end of file
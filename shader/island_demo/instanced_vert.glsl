@@ -1 +1,27 @@
- 
+#version 330 core
+
+// Atributy podla ppgso::Mesh (pozicia 0, UV 1, normala 2)
+layout(location = 0) in vec3 aPosition;
+layout(location = 1) in vec2 aTexCoord;
+layout(location = 2) in vec3 aNormal;
+
+// Model matica instancie z instance bufferu (lokacie 3 - 6, divisor 1)
+layout(location = 3) in mat4 aModelMatrix;
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoord;
+
+uniform mat4 ViewMatrix;
+uniform mat4 ProjectionMatrix;
+
+void main() {
+    FragPos = vec3(aModelMatrix * vec4(aPosition, 1.0));
+
+    // Normal matica pre kazdu instanciu zvlast (aj pri nerovnomernej skale)
+    mat3 normalMatrix = transpose(inverse(mat3(aModelMatrix)));
+    Normal = normalize(normalMatrix * aNormal);
+    TexCoord = aTexCoord;
+
+    gl_Position = ProjectionMatrix * ViewMatrix * vec4(FragPos, 1.0);
+}
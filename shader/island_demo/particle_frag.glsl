@@ -1 +1,13 @@
- 
+#version 330 core
+
+in vec2 Corner;
+in vec4 Color;
+
+out vec4 FragColor;
+
+void main() {
+    // Okruhla castica s makkym okrajom
+    float alpha = Color.a * (1.0 - smoothstep(0.5, 1.0, length(Corner)));
+    if (alpha < 0.01) discard;
+    FragColor = vec4(Color.rgb, alpha);
+}
@@ -1 +1,29 @@
- 
+#version 330 core
+
+// Stav castic priamo zo SoA poli systemu, jedna instancia = jedna castica (divisor 1)
+layout(location = 0) in float aPositionX;
+layout(location = 1) in float aPositionY;
+layout(location = 2) in float aPositionZ;
+layout(location = 3) in float aSize;
+layout(location = 4) in float aAge;       // 0 pri zrode, 1 pri zaniku
+layout(location = 5) in vec4 aColor;      // RGBA8, normalizovane
+
+out vec2 Corner;
+out vec4 Color;
+
+uniform mat4 ViewMatrix;
+uniform mat4 ProjectionMatrix;
+
+void main() {
+    // Stvorec z gl_VertexID (triangle strip so 4 vrcholmi), bez vertex bufferu
+    Corner = vec2(gl_VertexID & 1, gl_VertexID >> 1) * 2.0 - 1.0;
+
+    // Billboard otoceny ku kamere: roh sa posunie az v priestore kamery
+    vec4 viewPosition = ViewMatrix * vec4(aPositionX, aPositionY, aPositionZ, 1.0);
+    viewPosition.xy += Corner * aSize;
+    gl_Position = ProjectionMatrix * viewPosition;
+
+    // Plynuly nabeh a vyhasnutie podla veku
+    Color = aColor;
+    Color.a *= smoothstep(0.0, 0.1, aAge) * (1.0 - smoothstep(0.6, 1.0, aAge));
+}
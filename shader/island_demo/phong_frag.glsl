@@ -20,50 +20,110 @@ out vec4 FragColor;
 uniform vec3 viewPos;
 uniform Material material;
 
-uniform int light0_type;
-uniform int light0_enabled;
-uniform vec3 light0_ambient;
-uniform vec3 light0_diffuse;
-uniform vec3 light0_specular;
-uniform vec3 light0_direction;
-uniform vec3 light0_position;
-uniform float light0_constantAttenuation;
-uniform float light0_linearAttenuation;
-uniform float light0_quadraticAttenuation;
-uniform float light0_innerCutoff;
-uniform float light0_outerCutoff;
-
-uniform int light1_type;
-uniform int light1_enabled;
-uniform vec3 light1_ambient;
-uniform vec3 light1_diffuse;
-uniform vec3 light1_specular;
-uniform vec3 light1_direction;
-uniform vec3 light1_position;
-uniform float light1_constantAttenuation;
-uniform float light1_linearAttenuation;
-uniform float light1_quadraticAttenuation;
-uniform float light1_innerCutoff;
-uniform float light1_outerCutoff;
-
-uniform int light2_type;
-uniform int light2_enabled;
-uniform vec3 light2_ambient;
-uniform vec3 light2_diffuse;
-uniform vec3 light2_specular;
-uniform vec3 light2_direction;
-uniform vec3 light2_position;
-uniform float light2_constantAttenuation;
-uniform float light2_linearAttenuation;
-uniform float light2_quadraticAttenuation;
-uniform float light2_innerCutoff;
-uniform float light2_outerCutoff;
-
-uniform int numLights;
+struct Light {
+    vec3 position;
+    int type;
+    vec3 direction;
+    float range;
+    vec3 ambient;
+    float constantAttenuation;
+    vec3 diffuse;
+    float linearAttenuation;
+    vec3 specular;
+    float quadraticAttenuation;
+    float innerCutoff;
+    float outerCutoff;
+};
+
+// Parametre clustrov, naplnene raz za frame (LightBuffer)
+layout(std140) uniform Lights {
+    mat4 clusterView;
+    ivec4 clusterGrid;      // tilesX, tilesY, slices, pocet smerovych svetiel
+    vec4 clusterDepth;      // near, far, slice scale, slice bias
+    vec4 clusterViewport;   // x, y, sirka, vyska
+};
+
+// GpuLight po 6 texeloch, najprv smerove svetla
+uniform samplerBuffer lightData;
+// Pre kazdy cluster (offset, pocet) do clusterIndices
+uniform usamplerBuffer clusterRanges;
+uniform usamplerBuffer clusterIndices;
+
 uniform sampler2D Texture;
 uniform bool useTexture;
 uniform bool useBlinnPhong;
 
+Light fetchLight(int index) {
+    int base = index * 6;
+    vec4 t0 = texelFetch(lightData, base);
+    vec4 t1 = texelFetch(lightData, base + 1);
+    vec4 t2 = texelFetch(lightData, base + 2);
+    vec4 t3 = texelFetch(lightData, base + 3);
+    vec4 t4 = texelFetch(lightData, base + 4);
+    vec4 t5 = texelFetch(lightData, base + 5);
+
+    Light light;
+    light.position = t0.xyz;
+    light.type = floatBitsToInt(t0.w);
+    light.direction = t1.xyz;
+    light.range = t1.w;
+    light.ambient = t2.xyz;
+    light.constantAttenuation = t2.w;
+    light.diffuse = t3.xyz;
+    light.linearAttenuation = t3.w;
+    light.specular = t4.xyz;
+    light.quadraticAttenuation = t4.w;
+    light.innerCutoff = t5.x;
+    light.outerCutoff = t5.y;
+    return light;
+}
+
+// Index clustra, do ktoreho patri tento fragment (rovnake delenie ako LightClusters)
+int clusterIndex() {
+    vec2 tile = (gl_FragCoord.xy - clusterViewport.xy) / clusterViewport.zw * vec2(clusterGrid.xy);
+    int x = clamp(int(tile.x), 0, clusterGrid.x - 1);
+    int y = clamp(int(tile.y), 0, clusterGrid.y - 1);
+
+    float depth = max(-(clusterView * vec4(FragPos, 1.0)).z, clusterDepth.x);
+    int z = clamp(int(floor(log(depth) * clusterDepth.z + clusterDepth.w)), 0, clusterGrid.z - 1);
+
+    return (z * clusterGrid.y + y) * clusterGrid.x + x;
+}
+
+// Utlm bodoveho a reflektoroveho svetla, na hranici dosahu plynulo klesne na nulu
+float attenuation(Light light) {
+    float dist = length(light.position - FragPos);
+    float falloff = 1.0 / (light.constantAttenuation + light.linearAttenuation * dist + light.quadraticAttenuation * dist * dist);
+    float window = clamp(1.0 - pow(dist / light.range, 4.0), 0.0, 1.0);
+    return falloff * window * window;
+}
+
+vec3 shadeLight(Light light, vec3 norm, vec3 viewDir) {
+    vec3 lightDir = light.type == LIGHT_DIRECTIONAL ? normalize(-light.direction)
+                                                    : normalize(light.position - FragPos);
+    vec3 ambient = light.ambient * material.ambient;
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = light.diffuse * (diff * material.diffuse);
+    vec3 specular = vec3(0.0);
+    if (diff > 0.0) {
+        vec3 halfwayDir = normalize(lightDir + viewDir);
+        float spec = pow(max(dot(norm, halfwayDir), 0.0), material.shininess);
+        specular = light.specular * (spec * material.specular);
+    }
+
+    if (light.type == LIGHT_DIRECTIONAL) {
+        return ambient + diffuse + specular;
+    }
+    if (light.type == LIGHT_POINT) {
+        return (ambient + diffuse + specular) * attenuation(light);
+    }
+
+    float theta = dot(lightDir, normalize(-light.direction));
+    float epsilon = light.innerCutoff - light.outerCutoff;
+    float intensity = clamp((theta - light.outerCutoff) / epsilon, 0.0, 1.0);
+    return (ambient + (diffuse + specular) * intensity) * attenuation(light);
+}
+
 void main() {
     vec3 norm = normalize(Normal);
     // DEBUG: Vizualizujte normaly ako farbu
@@ -71,166 +131,16 @@ void main() {
     vec3 viewDir = normalize(viewPos - FragPos);
     vec3 result = vec3(0.0);
 
-    // Light 0
-    if (numLights > 0 && light0_enabled == 1) {
-        vec3 lightResult = vec3(0.0);
-
-        if (light0_type == LIGHT_DIRECTIONAL) {
-            vec3 lightDir = normalize(-light0_direction);
-            vec3 ambient = light0_ambient * material.ambient;
-            float diff = max(dot(norm, lightDir), 0.0);
-            vec3 diffuse = light0_diffuse * (diff * material.diffuse);
-            vec3 specular = vec3(0.0);
-            if (diff > 0.0) {
-                vec3 halfwayDir = normalize(lightDir + viewDir);
-                float spec = pow(max(dot(norm, halfwayDir), 0.0), material.shininess);
-                specular = light0_specular * (spec * material.specular);
-            }
-            lightResult = ambient + diffuse + specular;
-        }
-        else if (light0_type == LIGHT_POINT) {
-            vec3 lightDir = normalize(light0_position - FragPos);
-            vec3 ambient = light0_ambient * material.ambient;
-            float diff = max(dot(norm, lightDir), 0.0);
-            vec3 diffuse = light0_diffuse * (diff * material.diffuse);
-            vec3 specular = vec3(0.0);
-            if (diff > 0.0) {
-                vec3 halfwayDir = normalize(lightDir + viewDir);
-                float spec = pow(max(dot(norm, halfwayDir), 0.0), material.shininess);
-                specular = light0_specular * (spec * material.specular);
-            }
-            float distance = length(light0_position - FragPos);
-            float attenuation = 1.0 / (light0_constantAttenuation + light0_linearAttenuation * distance + light0_quadraticAttenuation * distance * distance);
-            lightResult = (ambient + diffuse + specular) * attenuation;
-        }
-        else if (light0_type == LIGHT_SPOT) {
-            vec3 lightDir = normalize(light0_position - FragPos);
-            vec3 ambient = light0_ambient * material.ambient;
-            float theta = dot(lightDir, normalize(-light0_direction));
-            float epsilon = light0_innerCutoff - light0_outerCutoff;
-            float intensity = clamp((theta - light0_outerCutoff) / epsilon, 0.0, 1.0);
-            float diff = max(dot(norm, lightDir), 0.0);
-            vec3 diffuse = light0_diffuse * (diff * material.diffuse);
-            vec3 specular = vec3(0.0);
-            if (diff > 0.0) {
-                vec3 halfwayDir = normalize(lightDir + viewDir);
-                float spec = pow(max(dot(norm, halfwayDir), 0.0), material.shininess);
-                specular = light0_specular * (spec * material.specular);
-            }
-            float distance = length(light0_position - FragPos);
-            float attenuation = 1.0 / (light0_constantAttenuation + light0_linearAttenuation * distance + light0_quadraticAttenuation * distance * distance);
-            lightResult = (ambient + (diffuse + specular) * intensity) * attenuation;
-        }
-
-        result += lightResult;
-    }
-
-    // Light 1
-    if (numLights > 1 && light1_enabled == 1) {
-        vec3 lightResult = vec3(0.0);
-
-        if (light1_type == LIGHT_DIRECTIONAL) {
-            vec3 lightDir = normalize(-light1_direction);
-            vec3 ambient = light1_ambient * material.ambient;
-            float diff = max(dot(norm, lightDir), 0.0);
-            vec3 diffuse = light1_diffuse * (diff * material.diffuse);
-            vec3 specular = vec3(0.0);
-            if (diff > 0.0) {
-                vec3 halfwayDir = normalize(lightDir + viewDir);
-                float spec = pow(max(dot(norm, halfwayDir), 0.0), material.shininess);
-                specular = light1_specular * (spec * material.specular);
-            }
-            lightResult = ambient + diffuse + specular;
-        }
-        else if (light1_type == LIGHT_POINT) {
-            vec3 lightDir = normalize(light1_position - FragPos);
-            vec3 ambient = light1_ambient * material.ambient;
-            float diff = max(dot(norm, lightDir), 0.0);
-            vec3 diffuse = light1_diffuse * (diff * material.diffuse);
-            vec3 specular = vec3(0.0);
-            if (diff > 0.0) {
-                vec3 halfwayDir = normalize(lightDir + viewDir);
-                float spec = pow(max(dot(norm, halfwayDir), 0.0), material.shininess);
-                specular = light1_specular * (spec * material.specular);
-            }
-            float distance = length(light1_position - FragPos);
-            float attenuation = 1.0 / (light1_constantAttenuation + light1_linearAttenuation * distance + light1_quadraticAttenuation * distance * distance);
-            lightResult = (ambient + diffuse + specular) * attenuation;
-        }
-        else if (light1_type == LIGHT_SPOT) {
-            vec3 lightDir = normalize(light1_position - FragPos);
-            vec3 ambient = light1_ambient * material.ambient;
-            float theta = dot(lightDir, normalize(-light1_direction));
-            float epsilon = light1_innerCutoff - light1_outerCutoff;
-            float intensity = clamp((theta - light1_outerCutoff) / epsilon, 0.0, 1.0);
-            float diff = max(dot(norm, lightDir), 0.0);
-            vec3 diffuse = light1_diffuse * (diff * material.diffuse);
-            vec3 specular = vec3(0.0);
-            if (diff > 0.0) {
-                vec3 halfwayDir = normalize(lightDir + viewDir);
-                float spec = pow(max(dot(norm, halfwayDir), 0.0), material.shininess);
-                specular = light1_specular * (spec * material.specular);
-            }
-            float distance = length(light1_position - FragPos);
-            float attenuation = 1.0 / (light1_constantAttenuation + light1_linearAttenuation * distance + light1_quadraticAttenuation * distance * distance);
-            lightResult = (ambient + (diffuse + specular) * intensity) * attenuation;
-        }
-
-        result += lightResult;
+    // Smerove svetla ovplyvnuju kazdy fragment
+    for (int i = 0; i < clusterGrid.w; i++) {
+        result += shadeLight(fetchLight(i), norm, viewDir);
     }
 
-    // Light 2
-    if (numLights > 2 && light2_enabled == 1) {
-        vec3 lightResult = vec3(0.0);
-
-        if (light2_type == LIGHT_DIRECTIONAL) {
-            vec3 lightDir = normalize(-light2_direction);
-            vec3 ambient = light2_ambient * material.ambient;
-            float diff = max(dot(norm, lightDir), 0.0);
-            vec3 diffuse = light2_diffuse * (diff * material.diffuse);
-            vec3 specular = vec3(0.0);
-            if (diff > 0.0) {
-                vec3 halfwayDir = normalize(lightDir + viewDir);
-                float spec = pow(max(dot(norm, halfwayDir), 0.0), material.shininess);
-                specular = light2_specular * (spec * material.specular);
-            }
-            lightResult = ambient + diffuse + specular;
-        }
-        else if (light2_type == LIGHT_POINT) {
-            vec3 lightDir = normalize(light2_position - FragPos);
-            vec3 ambient = light2_ambient * material.ambient;
-            float diff = max(dot(norm, lightDir), 0.0);
-            vec3 diffuse = light2_diffuse * (diff * material.diffuse);
-            vec3 specular = vec3(0.0);
-            if (diff > 0.0) {
-                vec3 halfwayDir = normalize(lightDir + viewDir);
-                float spec = pow(max(dot(norm, halfwayDir), 0.0), material.shininess);
-                specular = light2_specular * (spec * material.specular);
-            }
-            float distance = length(light2_position - FragPos);
-            float attenuation = 1.0 / (light2_constantAttenuation + light2_linearAttenuation * distance + light2_quadraticAttenuation * distance * distance);
-            lightResult = (ambient + diffuse + specular) * attenuation;
-        }
-        else if (light2_type == LIGHT_SPOT) {
-            vec3 lightDir = normalize(light2_position - FragPos);
-            vec3 ambient = light2_ambient * material.ambient;
-            float theta = dot(lightDir, normalize(-light2_direction));
-            float epsilon = light2_innerCutoff - light2_outerCutoff;
-            float intensity = clamp((theta - light2_outerCutoff) / epsilon, 0.0, 1.0);
-            float diff = max(dot(norm, lightDir), 0.0);
-            vec3 diffuse = light2_diffuse * (diff * material.diffuse);
-            vec3 specular = vec3(0.0);
-            if (diff > 0.0) {
-                vec3 halfwayDir = normalize(lightDir + viewDir);
-                float spec = pow(max(dot(norm, halfwayDir), 0.0), material.shininess);
-                specular = light2_specular * (spec * material.specular);
-            }
-            float distance = length(light2_position - FragPos);
-            float attenuation = 1.0 / (light2_constantAttenuation + light2_linearAttenuation * distance + light2_quadraticAttenuation * distance * distance);
-            lightResult = (ambient + (diffuse + specular) * intensity) * attenuation;
-        }
-
-        result += lightResult;
+    // Bodove a reflektorove svetla len z clustra fragmentu
+    uvec2 range = texelFetch(clusterRanges, clusterIndex()).xy;
+    for (uint i = 0u; i < range.y; i++) {
+        int index = int(texelFetch(clusterIndices, int(range.x + i)).x);
+        result += shadeLight(fetchLight(index), norm, viewDir);
     }
 
     if (useTexture) {
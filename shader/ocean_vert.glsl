@@ -8,22 +8,105 @@ uniform mat4 modelMatrix;
 uniform mat4 viewMatrix;
 uniform mat4 projectionMatrix;
 
+// Wave displacement on the GPU (otherwise position/normal already hold the CPU result)
+uniform bool gpuDisplacement;
+uniform float time;
+
+// Projected grid: position.xy is a screen position (NDC) that gets projected onto the sea plane
+uniform bool projectedGrid;
+uniform mat4 inverseViewProjection;
+uniform vec2 gridStep;          // NDC distance between neighbouring grid vertices
+uniform float viewDistance;     // Rays that miss the sea plane end this far away
+uniform float surfaceSize;      // World size the regular mesh spreads its texture coordinates over
+
+#define MAX_WAVES 16
+
+struct Wave {
+    vec2 direction;
+    float k;            // 2 pi / wavelength
+    float speed;        // wave speed, scaled by the ocean wave speed
+    float amplitude;    // amplitude, scaled by the ocean wave height
+};
+
+layout(std140) uniform OceanWaves {
+    Wave waves[MAX_WAVES];
+    int waveCount;
+};
+
 out vec3 fragPosition;
 out vec3 fragNormal;
 out vec2 fragTexCoord;
 out float fragWaveHeight;
 
+// Same sum of waves as Ocean::gerstnerWaveHeight / gerstnerWaveNormal. With a footprint
+// (world distance between neighbouring vertices) waves too short for the grid to
+// resolve fade out instead of aliasing.
+void sumWaves(vec2 p, float footprint, out float height, out vec3 surfaceNormal) {
+    height = 0.0;
+    surfaceNormal = vec3(0.0, 1.0, 0.0);
+
+    for (int i = 0; i < waveCount; i++) {
+        float weight = 1.0;
+        if (footprint > 0.0) {
+            weight = smoothstep(2.0 * footprint, 4.0 * footprint, 6.28318530718 / waves[i].k);
+        }
+
+        float phi = waves[i].k * (dot(waves[i].direction, p) - waves[i].speed * time);
+        height += weight * waves[i].amplitude * sin(phi);
+
+        float slope = weight * waves[i].k * waves[i].amplitude * cos(phi);
+        surfaceNormal.x -= slope * waves[i].direction.x;
+        surfaceNormal.z -= slope * waves[i].direction.y;
+    }
+
+    surfaceNormal = normalize(surfaceNormal);
+}
+
+// Point where the view ray through a screen position meets the sea plane (y = 0)
+vec2 projectToSurface(vec2 ndc) {
+    vec4 nearPoint = inverseViewProjection * vec4(ndc, -1.0, 1.0);
+    vec4 farPoint = inverseViewProjection * vec4(ndc, 1.0, 1.0);
+    vec3 origin = nearPoint.xyz / nearPoint.w;
+    vec3 direction = farPoint.xyz / farPoint.w - origin;
+
+    float horizontal = length(direction.xz);
+    float reach = viewDistance;
+    if (direction.y * origin.y < 0.0) {
+        reach = min(-origin.y / direction.y * horizontal, viewDistance);
+    }
+
+    return origin.xz + direction.xz * (reach / max(horizontal, 1e-6));
+}
+
 void main() {
+    vec3 surfacePosition = position;
+    vec3 surfaceNormal = normal;
+    vec2 surfaceTexCoord = texCoord;
+
+    if (projectedGrid) {
+        vec2 p = projectToSurface(position.xy);
+        float footprint = max(distance(projectToSurface(position.xy + vec2(gridStep.x, 0.0)), p),
+                              distance(projectToSurface(position.xy + vec2(0.0, gridStep.y)), p));
+
+        // Texture coordinates continue the mapping of the regular mesh
+        surfaceTexCoord = (p / surfaceSize + 0.5) * 10.0;
+        surfacePosition = vec3(p.x, 0.0, p.y);
+        sumWaves(p, footprint, surfacePosition.y, surfaceNormal);
+    } else if (gpuDisplacement) {
+        surfacePosition.y = 0.0;
+        sumWaves(position.xz, 0.0, surfacePosition.y, surfaceNormal);
+    }
+
     // Transform position
-    vec4 worldPos = modelMatrix * vec4(position, 1.0);
+    vec4 worldPos = modelMatrix * vec4(surfacePosition, 1.0);
     fragPosition = worldPos.xyz;
 
     // Transform normal
     mat3 normalMatrix = transpose(inverse(mat3(modelMatrix)));
-    fragNormal = normalize(normalMatrix * normal);
+    fragNormal = normalize(normalMatrix * surfaceNormal);
 
-    fragTexCoord = texCoord;
-    fragWaveHeight = position.y;
+    fragTexCoord = surfaceTexCoord;
+    fragWaveHeight = surfacePosition.y;
 
     gl_Position = projectionMatrix * viewMatrix * worldPos;
-}
\ No newline at end of file
+}
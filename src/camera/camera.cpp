@@ -44,6 +44,11 @@ namespace ppgso {
         return getProjectionMatrix() * getViewMatrix();
     }
 
+    // Frustum
+    Frustum Camera::getFrustum() const {
+        return Frustum(getViewProjectionMatrix());
+    }
+
     // Pozicia
     void Camera::setPosition(const glm::vec3& position) {
         transform.setPosition(position);
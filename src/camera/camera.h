@@ -5,6 +5,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include "../scene_graph/transform.h"
+#include "frustum.h"
 
 namespace ppgso {
 
@@ -27,6 +28,9 @@ namespace ppgso {
         // Kombinovana ViewProjection matica
         glm::mat4 getViewProjectionMatrix() const;
 
+        // Sest rovin pohladoveho ihlanu vo svetovom priestore (pre frustum culling)
+        Frustum getFrustum() const;
+
         // Pozicia a orientacia kamery
         void setPosition(const glm::vec3& position);
         glm::vec3 getPosition() const;
@@ -0,0 +1,59 @@
+#include "frustum.h"
+
+namespace ppgso {
+
+    Frustum::Frustum() {
+        // Bez matice je frustum cely priestor
+        for (auto& plane : planes) plane = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    Frustum::Frustum(const glm::mat4& viewProjection) {
+        setViewProjection(viewProjection);
+    }
+
+    void Frustum::setViewProjection(const glm::mat4& viewProjection) {
+        // glm je column-major, riadok i je (m[0][i], m[1][i], m[2][i], m[3][i])
+        glm::mat4 rows = glm::transpose(viewProjection);
+
+        planes[LEFT_PLANE] = rows[3] + rows[0];
+        planes[RIGHT_PLANE] = rows[3] - rows[0];
+        planes[BOTTOM_PLANE] = rows[3] + rows[1];
+        planes[TOP_PLANE] = rows[3] - rows[1];
+        planes[NEAR_PLANE] = rows[3] + rows[2];
+        planes[FAR_PLANE] = rows[3] - rows[2];
+
+        for (auto& plane : planes) {
+            plane /= glm::length(glm::vec3(plane));
+        }
+    }
+
+    Frustum::Containment Frustum::classify(const glm::vec3& boundsMin, const glm::vec3& boundsMax) const {
+        glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+        glm::vec3 extent = (boundsMax - boundsMin) * 0.5f;
+
+        Containment result = INSIDE;
+        for (const auto& plane : planes) {
+            glm::vec3 normal(plane);
+            float distance = glm::dot(normal, center) + plane.w;
+            float radius = glm::dot(glm::abs(normal), extent);
+
+            // Aj najblizsi roh je za rovinou
+            if (distance + radius < 0.0f) return OUTSIDE;
+            // Najvzdialenejsi roh je za rovinou, box ju pretina
+            if (distance - radius < 0.0f) result = INTERSECTS;
+        }
+        return result;
+    }
+
+    bool Frustum::intersects(const glm::vec3& boundsMin, const glm::vec3& boundsMax) const {
+        return classify(boundsMin, boundsMax) != OUTSIDE;
+    }
+
+    bool Frustum::intersects(const glm::vec3& center, float radius) const {
+        for (const auto& plane : planes) {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) return false;
+        }
+        return true;
+    }
+
+} // namespace ppgso
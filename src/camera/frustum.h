@@ -0,0 +1,41 @@
+#ifndef PPGSO_FRUSTUM_H
+#define PPGSO_FRUSTUM_H
+
+#include <glm/glm.hpp>
+
+namespace ppgso {
+
+    /**
+     * Frustum - Sest rovin pohladoveho ihlanu kamery vo svetovom priestore
+     *
+     * Roviny sa vytiahnu priamo z riadkov view-projection matice (Gribb / Hartmann),
+     * normaly smeruju dovnutra a su normalizovane, takze dot(plane, (p, 1)) je
+     * vzdialenost bodu od roviny.
+     */
+    class Frustum {
+    public:
+        enum Plane { LEFT_PLANE = 0, RIGHT_PLANE, BOTTOM_PLANE, TOP_PLANE, NEAR_PLANE, FAR_PLANE, PLANE_COUNT };
+
+        // Vysledok testu obalky proti frustu
+        enum Containment { OUTSIDE = 0, INTERSECTS, INSIDE };
+
+        Frustum();
+        explicit Frustum(const glm::mat4& viewProjection);
+
+        void setViewProjection(const glm::mat4& viewProjection);
+        const glm::vec4& getPlane(int plane) const { return planes[plane]; }
+
+        // AABB (min, max) vo svetovom priestore
+        Containment classify(const glm::vec3& boundsMin, const glm::vec3& boundsMax) const;
+        bool intersects(const glm::vec3& boundsMin, const glm::vec3& boundsMax) const;
+
+        // Gula vo svetovom priestore
+        bool intersects(const glm::vec3& center, float radius) const;
+
+    private:
+        glm::vec4 planes[PLANE_COUNT];
+    };
+
+} // namespace ppgso
+
+#endif // PPGSO_FRUSTUM_H
@@ -1,17 +1,27 @@
 #include <iostream>
+#include <algorithm>
 #include <ppgso/ppgso.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
 #include "../terrain/Terrain.h"
+#include "../terrain/ChunkedTerrain.h"
+#include "../terrain/HeightfieldCollider.h"
 #include "../ocean/Ocean.h"
+#include "../ocean/FloatingObjects.h"
 
 const unsigned int SIZE = 1024;
 
 class OceanScene {
 private:
     std::unique_ptr<Terrain> terrain;
+    std::unique_ptr<ChunkedTerrain> chunkedTerrain;
+    std::shared_ptr<HeightfieldCollider> heightfield;
     std::unique_ptr<Ocean> ocean;
+    std::unique_ptr<FloatingObjects> floating;
+
+    // Streamed chunks around the camera instead of the single terrain mesh
+    bool useChunkedTerrain = false;
 
     // Camera modes
     enum CameraMode { ORBIT, FREE };
@@ -38,6 +48,9 @@ private:
     float rotateSpeed = 90.0f;
     float mouseSensitivity = 0.1f;
 
+    // Free camera stays at least this high above the ground
+    float groundClearance = 2.0f;
+
     // Auto-rotation (orbit mode only)
     bool autoRotate = false;
     float autoRotateSpeed = 0.2f;
@@ -59,6 +72,12 @@ public:
             TerrainType::ISLAND       // type
         );
 
+        // Chunked terrain streams the same height function around the camera
+        chunkedTerrain = std::make_unique<ChunkedTerrain>(*terrain);
+
+        // Collision copy of the terrain grid for ground queries
+        heightfield = std::make_shared<HeightfieldCollider>(*terrain);
+
         // Initialize ocean (larger than island)
         ocean = std::make_unique<Ocean>(
             1024.0f,          // size
@@ -71,6 +90,11 @@ public:
         ocean->setFoamColor(glm::vec3(0.9f, 0.95f, 1.0f));
         ocean->setTransparency(0.85f);
         ocean->setWaveSpeed(1.0f);
+        ocean->setViewDistance(1900.0f); // Projected grid horizon, inside the far plane
+
+        // Debris, crates, boats and leaves drifting on the waves
+        floating = std::make_unique<FloatingObjects>(*ocean, heightfield);
+        floating->scatter(300);
 
         // Setup orbit mode
         orbitTarget = glm::vec3(0.0f, cameraHeight * 0.3f, 0.0f);
@@ -223,6 +247,11 @@ public:
                 pitch = glm::clamp(pitch, -89.0f, 89.0f);
                 updateFreeCameraVectors();
             }
+
+            // Keep the camera above the terrain
+            heightfield->sync();
+            cameraPosition.y = glm::max(cameraPosition.y,
+                                        heightfield->height(cameraPosition.x, cameraPosition.z) + groundClearance);
         }
 
         updateCamera();
@@ -230,6 +259,13 @@ public:
         // Update ocean waves
         ocean->update(dt);
         terrain->update(dt);
+
+        if (useChunkedTerrain) {
+            chunkedTerrain->update(cameraPosition);
+        }
+
+        // After the ocean, buoyancy samples the waves at the new time
+        floating->update(dt);
     }
 
     void render() {
@@ -240,7 +276,13 @@ public:
         glEnable(GL_DEPTH_TEST);
 
         // Render terrain first (opaque)
-        terrain->render(view, projection);
+        if (useChunkedTerrain) {
+            chunkedTerrain->render(view, projection);
+        } else {
+            terrain->render(view, projection);
+        }
+
+        floating->render(view, projection);
 
         // Render ocean last (transparent)
         ocean->render(view, projection);
@@ -277,6 +319,20 @@ public:
                     terrain->setType(TerrainType::PLATEAUS);
                     std::cout << "Terrain: PLATEAUS\n";
                     break;
+                case GLFW_KEY_T:
+                    useChunkedTerrain = !useChunkedTerrain;
+                    std::cout << "Terrain mode: " << (useChunkedTerrain ? "CHUNKED" : "SINGLE MESH") << "\n";
+                    break;
+                case GLFW_KEY_G:
+                    std::cout << "Chunks - Drawn: " << chunkedTerrain->getDrawnChunks()
+                              << " Resident: " << chunkedTerrain->getResidentChunks()
+                              << " (" << chunkedTerrain->getResidentBytes() / (1024 * 1024) << " MB)"
+                              << " Pending: " << chunkedTerrain->getPendingChunks()
+                              << " Last build: " << chunkedTerrain->getLastBuildTime() << " ms\n";
+                    break;
+                case GLFW_KEY_H:
+                    HeightfieldCollider::benchmark(*terrain);
+                    break;
                 case GLFW_KEY_TAB:
                     // Toggle camera mode
                     if (cameraMode == ORBIT) {
@@ -326,6 +382,35 @@ public:
                     ocean->setWaveSpeed(1.5f);
                     std::cout << "Wave speed increased\n";
                     break;
+                case GLFW_KEY_V:
+                    ocean->setGpuDisplacement(!ocean->isGpuDisplacement());
+                    std::cout << "Ocean waves: " << (ocean->isGpuDisplacement() ? "GPU" : "CPU") << "\n";
+                    if (ocean->isGpuDisplacement()) {
+                        std::cout << "  Read-back error vs CPU: " << ocean->measureGpuError() << "\n";
+                    }
+                    break;
+                case GLFW_KEY_B:
+                    ocean->benchmarkUpdate();
+                    break;
+                case GLFW_KEY_P:
+                    ocean->setProjectedGrid(!ocean->isProjectedGrid());
+                    std::cout << "Ocean mesh: "
+                              << (ocean->isProjectedGrid() ? "Projected grid (" + std::to_string(ocean->getProjectedGridVertexCount()) + " vertices)" : "Regular grid") << "\n";
+                    break;
+                case GLFW_KEY_M:
+                    ocean->setWaveModel(ocean->getWaveModel() == WaveModel::GERSTNER ?
+                                        WaveModel::SPECTRAL : WaveModel::GERSTNER);
+                    std::cout << "Ocean wave model: "
+                              << (ocean->getWaveModel() == WaveModel::SPECTRAL ? "Spectral (FFT)" : "Gerstner") << "\n";
+                    break;
+                case GLFW_KEY_O:
+                    floating->scatter(100);
+                    std::cout << "Floating objects: " << floating->getObjectCount() << "\n";
+                    break;
+                case GLFW_KEY_K:
+                    floating->printStats();
+                    Buoyancy::benchmark(*ocean, std::max(floating->getBuoyancy().getFloaterCount(), 100));
+                    break;
                 case GLFW_KEY_C:
                     // Print camera info
                     if (cameraMode == ORBIT) {
@@ -400,10 +485,19 @@ int main() {
     std::cout << "  CTRL:       Move down\n";
     std::cout << "  Arrow Keys: Look around\n\n";
     std::cout << "TERRAIN:\n";
-    std::cout << "  1-5:        Change terrain type\n\n";
+    std::cout << "  1-5:        Change terrain type\n";
+    std::cout << "  T:          Toggle chunked streaming terrain\n";
+    std::cout << "  G:          Print chunk statistics\n";
+    std::cout << "  H:          Benchmark heightfield collision queries\n\n";
     std::cout << "OCEAN:\n";
     std::cout << "  Z:          Increase wave height\n";
-    std::cout << "  X:          Increase wave speed\n\n";
+    std::cout << "  X:          Increase wave speed\n";
+    std::cout << "  V:          Toggle GPU wave displacement\n";
+    std::cout << "  B:          Benchmark CPU wave update\n";
+    std::cout << "  M:          Toggle Gerstner / spectral (FFT) ocean\n";
+    std::cout << "  P:          Toggle screen-space projected grid ocean\n";
+    std::cout << "  O:          Drop 100 more floating objects\n";
+    std::cout << "  K:          Floating object statistics and wave query benchmark\n\n";
     std::cout << "OTHER:\n";
     std::cout << "  ESC:        Exit\n";
     std::cout << "==============================================\n\n";
@@ -5,14 +5,18 @@
 
 #include <shaders/diffuse_vert_glsl.h>
 #include <shaders/diffuse_frag_glsl.h>
+#include <shaders/diffuse_instanced_vert_glsl.h>
 
 
 // Static resources
 std::unique_ptr<ppgso::Mesh> Asteroid::mesh;
 std::unique_ptr<ppgso::Texture> Asteroid::texture;
 std::unique_ptr<ppgso::Shader> Asteroid::shader;
+std::unique_ptr<ppgso::Shader> Asteroid::instancedShader;
 
 Asteroid::Asteroid() {
+  tags = ASTEROID_TAG;
+
   // Set random scale speed and rotation
   scale *= glm::linearRand(1.0f, 3.0f);
   speed = {glm::linearRand(-2.0f, 2.0f), glm::linearRand(-5.0f, -10.0f), 0.0f};
@@ -21,6 +25,7 @@ Asteroid::Asteroid() {
 
   // Initialize static resources if needed
   if (!shader) shader = std::make_unique<ppgso::Shader>(diffuse_vert_glsl, diffuse_frag_glsl);
+  if (!instancedShader) instancedShader = std::make_unique<ppgso::Shader>(diffuse_instanced_vert_glsl, diffuse_frag_glsl);
   if (!texture) texture = std::make_unique<ppgso::Texture>(ppgso::image::loadBMP("asteroid.bmp"));
   if (!mesh) mesh = std::make_unique<ppgso::Mesh>("asteroid.obj");
 }
@@ -38,37 +43,35 @@ bool Asteroid::update(Scene &scene, float dt) {
   // Delete when alive longer than 10s or out of visibility
   if (age > 10.0f || position.y < -10) return false;
 
-  // Collide with scene
-  for (auto &obj : scene.objects) {
+  // Collide with nearby asteroids and projectiles, ignore other objects
+  // When colliding with other asteroids make sure the object is older than .5s
+  // This prevents excessive collisions when asteroids explode.
+  uint32_t mask = age < 0.5f ? PROJECTILE_TAG : ASTEROID_TAG | PROJECTILE_TAG;
+  bool hit = false;
+  scene.spatialHash.query(position, scale.y * 0.7f, mask, [&](Object &obj) {
     // Ignore self in scene
-    if (obj.get() == this) continue;
+    if (&obj == this) return true;
 
-    // We only need to collide with asteroids and projectiles, ignore other objects
-    auto asteroid = dynamic_cast<Asteroid*>(obj.get()); // dynamic_pointer_cast<Asteroid>(obj);
-    auto projectile = dynamic_cast<Projectile*>(obj.get()); //dynamic_pointer_cast<Projectile>(obj);
-    if (!asteroid && !projectile) continue;
+    // Compare distance to approximate size of the asteroid estimated from scale.
+    if (distance(position, obj.position) >= (obj.scale.y + scale.y) * 0.7f) return true;
 
-    // When colliding with other asteroids make sure the object is older than .5s
-    // This prevents excessive collisions when asteroids explode.
-    if (asteroid && age < 0.5f) continue;
+    int pieces = 3;
 
-    // Compare distance to approximate size of the asteroid estimated from scale.
-    if (distance(position, obj->position) < (obj->scale.y + scale.y) * 0.7f) {
-      int pieces = 3;
+    // Too small to split into pieces
+    if (scale.y < 0.5) pieces = 0;
 
-      // Too small to split into pieces
-      if (scale.y < 0.5) pieces = 0;
+    // The projectile will be destroyed
+    if (obj.tags & PROJECTILE_TAG) static_cast<Projectile&>(obj).destroy();
 
-      // The projectile will be destroyed
-      if (projectile) projectile->destroy();
+    // Generate smaller asteroids
+    explode(scene, (obj.position + position) / 2.0f, (obj.scale + scale) / 2.0f, pieces);
 
-      // Generate smaller asteroids
-      explode(scene, (obj->position + position) / 2.0f, (obj->scale + scale) / 2.0f, pieces);
+    hit = true;
+    return false;
+  });
 
-      // Destroy self
-      return false;
-    }
-  }
+  // Destroy self
+  if (hit) return false;
 
   // Generate modelMatrix from position, rotation and scale
   generateModelMatrix();
@@ -78,38 +81,25 @@ bool Asteroid::update(Scene &scene, float dt) {
 
 void Asteroid::explode(Scene &scene, glm::vec3 explosionPosition, glm::vec3 explosionScale, int pieces) {
   // Generate explosion
-  auto explosion = std::make_unique<Explosion>();
-  explosion->position = explosionPosition;
-  explosion->scale = explosionScale;
-  explosion->speed = speed / 2.0f;
-  scene.objects.push_back(move(explosion));
+  auto &explosion = scene.spawn<Explosion>();
+  explosion.position = explosionPosition;
+  explosion.scale = explosionScale;
+  explosion.speed = speed / 2.0f;
 
   // Generate smaller asteroids
   for (int i = 0; i < pieces; i++) {
-    auto asteroid = std::make_unique<Asteroid>();
-    asteroid->speed = speed + glm::vec3(glm::linearRand(-3.0f, 3.0f), glm::linearRand(0.0f, -5.0f), 0.0f);;
-    asteroid->position = position;
-    asteroid->rotMomentum = rotMomentum;
+    auto &asteroid = scene.spawn<Asteroid>();
+    asteroid.speed = speed + glm::vec3(glm::linearRand(-3.0f, 3.0f), glm::linearRand(0.0f, -5.0f), 0.0f);;
+    asteroid.position = position;
+    asteroid.rotMomentum = rotMomentum;
     float factor = (float) pieces / 2.0f;
-    asteroid->scale = scale / factor;
-    scene.objects.push_back(move(asteroid));
+    asteroid.scale = scale / factor;
   }
 }
 
 void Asteroid::render(Scene &scene) {
-  shader->use();
-
-  // Set up light
-  shader->setUniform("LightDirection", scene.lightDirection);
-
-  // use camera
-  shader->setUniform("ProjectionMatrix", scene.camera->projectionMatrix);
-  shader->setUniform("ViewMatrix", scene.camera->viewMatrix);
-
-  // render mesh
-  shader->setUniform("ModelMatrix", modelMatrix);
-  shader->setUniform("Texture", *texture);
-  mesh->render();
+  // Light, camera and modelMatrix are set by the queue, all asteroids are drawn with one instanced draw
+  scene.renderQueue.submit(RenderQueue::OPAQUE_PASS, *this, *shader, *texture, *mesh, instancedShader.get());
 }
 
 void Asteroid::onClick(Scene &scene) {
@@ -17,6 +17,7 @@ private:
   // Static resources (Shared between instances)
   static std::unique_ptr<ppgso::Mesh> mesh;
   static std::unique_ptr<ppgso::Shader> shader;
+  static std::unique_ptr<ppgso::Shader> instancedShader;
   static std::unique_ptr<ppgso::Texture> texture;
 
   // Age of the object in seconds
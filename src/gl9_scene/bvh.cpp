@@ -0,0 +1,317 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <numeric>
+
+#include <glm/gtc/random.hpp>
+#include <ppgso/timing.h>
+
+#include "bvh.h"
+#include "object.h"
+
+static const float INFINITE_DISTANCE = std::numeric_limits<float>::infinity();
+
+/*!
+ * Same sphere test as the original linear pick, a ray starting inside counts as a hit at distance 0
+ */
+static bool raySphere(const glm::vec3 &origin, const glm::vec3 &direction, const glm::vec4 &sphere, float &distance) {
+  auto oc = origin - glm::vec3(sphere);
+  auto a = glm::dot(direction, direction);
+  auto b = glm::dot(oc, direction);
+  auto c = glm::dot(oc, oc) - sphere.w * sphere.w;
+  auto dis = b * b - a * c;
+  if (!(dis > 0)) return false;
+
+  auto e = std::sqrt(dis);
+  if ((-b + e) / a <= 0) return false;
+  distance = std::max((-b - e) / a, 0.0f);
+  return true;
+}
+
+static float area(const glm::vec3 &min, const glm::vec3 &max) {
+  auto size = max - min;
+  return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+void Bvh::beginUpdate() {
+  // Pending objects get new entries when they are inserted again
+  objects.resize(built);
+  spheres.resize(built);
+  seen.resize(built);
+  frame++;
+}
+
+void Bvh::insert(Object &object) {
+  auto sphere = glm::vec4(object.position, std::abs(object.scale.x));
+  auto entry = object.bvhEntry;
+  if (entry < built && objects[entry] == &object) {
+    spheres[entry] = sphere;
+    seen[entry] = frame;
+    return;
+  }
+
+  // New object, or one that was moved to another address
+  object.bvhEntry = (uint32_t) objects.size();
+  objects.push_back(&object);
+  spheres.push_back(sphere);
+  seen.push_back(frame);
+}
+
+void Bvh::endUpdate() {
+  for (size_t entry = 0; entry < built; entry++) {
+    if (!objects[entry] || seen[entry] == frame) continue;
+    objects[entry] = nullptr;
+    spheres[entry].w = -1.0f;
+    removed++;
+  }
+
+  size_t pending = objects.size() - built;
+  if (pending > std::max<size_t>(16, built / 8) || removed > built / 4) {
+    rebuild();
+  } else if (!nodes.empty()) {
+    // Boxes of moving objects drift apart, rebuild once they cost twice as much as after the build
+    if (refit() > 2.0f * builtArea) rebuild();
+    else stats.refits++;
+  }
+
+  stats.objects = objects.size() - removed;
+  stats.nodes = nodes.size();
+  stats.pending = objects.size() - built;
+  stats.removed = removed;
+}
+
+void Bvh::clear() {
+  nodes.clear();
+  objects.clear();
+  spheres.clear();
+  seen.clear();
+  order.clear();
+  built = 0;
+  removed = 0;
+  builtArea = 0.0f;
+  stats = Stats();
+}
+
+void Bvh::rebuild() {
+  // Drop removed entries, the objects learn their new entry
+  size_t count = 0;
+  for (size_t entry = 0; entry < objects.size(); entry++) {
+    if (!objects[entry]) continue;
+    objects[count] = objects[entry];
+    objects[count]->bvhEntry = (uint32_t) count;
+    spheres[count] = spheres[entry];
+    seen[count] = seen[entry];
+    count++;
+  }
+  objects.resize(count);
+  spheres.resize(count);
+  seen.resize(count);
+  built = count;
+  removed = 0;
+
+  order.resize(count);
+  std::iota(order.begin(), order.end(), 0);
+  nodes.clear();
+  if (count) buildNode(0, (uint32_t) count);
+
+  builtArea = refit();
+  stats.rebuilds++;
+}
+
+uint32_t Bvh::buildNode(uint32_t begin, uint32_t end) {
+  auto index = (uint32_t) nodes.size();
+  nodes.push_back({});
+  if (end - begin <= LEAF_SIZE) {
+    nodes[index].index = begin;
+    nodes[index].count = end - begin;
+    return index;
+  }
+
+  // Median split along the longest axis of the centers keeps the depth at log2(n / LEAF_SIZE)
+  glm::vec3 min{INFINITE_DISTANCE}, max{-INFINITE_DISTANCE};
+  for (auto i = begin; i < end; i++) {
+    min = glm::min(min, glm::vec3(spheres[order[i]]));
+    max = glm::max(max, glm::vec3(spheres[order[i]]));
+  }
+  auto size = max - min;
+  int axis = size.x > size.y ? (size.x > size.z ? 0 : 2) : (size.y > size.z ? 1 : 2);
+
+  auto middle = begin + (end - begin) / 2;
+  std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+                   [this, axis](uint32_t a, uint32_t b) { return spheres[a][axis] < spheres[b][axis]; });
+
+  // Boxes are filled in by refit
+  buildNode(begin, middle);
+  auto right = buildNode(middle, end);
+  nodes[index].index = right;
+  nodes[index].count = 0;
+  return index;
+}
+
+float Bvh::refit() {
+  // Children are stored after their parent, one reverse sweep updates every box
+  float total = 0.0f;
+  for (auto i = nodes.size(); i-- > 0;) {
+    auto &node = nodes[i];
+    node.min = glm::vec3{INFINITE_DISTANCE};
+    node.max = glm::vec3{-INFINITE_DISTANCE};
+    if (node.count) {
+      for (auto j = node.index; j < node.index + node.count; j++) {
+        auto &sphere = spheres[order[j]];
+        if (sphere.w < 0) continue;
+        node.min = glm::min(node.min, glm::vec3(sphere) - sphere.w);
+        node.max = glm::max(node.max, glm::vec3(sphere) + sphere.w);
+      }
+    } else {
+      auto &left = nodes[i + 1], &right = nodes[node.index];
+      node.min = glm::min(left.min, right.min);
+      node.max = glm::max(left.max, right.max);
+      if (node.min.x <= node.max.x) total += area(node.min, node.max);
+    }
+  }
+  return total;
+}
+
+template<typename Visitor>
+void Bvh::traverse(const glm::vec3 &origin, const glm::vec3 &direction, float &maxDistance, Visitor visit) const {
+  auto test = [&](uint32_t entry) {
+    float distance;
+    if (spheres[entry].w < 0 || !raySphere(origin, direction, spheres[entry], distance)) return true;
+    if (distance >= maxDistance) return true;
+    return visit(entry, distance);
+  };
+
+  auto inverse = 1.0f / direction;
+  uint32_t stack[STACK_SIZE];
+  int top = 0;
+  if (!nodes.empty()) stack[top++] = 0;
+
+  while (top) {
+    auto &node = nodes[stack[--top]];
+
+    // Slab test, empty boxes of removed objects are skipped first
+    if (node.min.x > node.max.x) continue;
+    auto t0 = (node.min - origin) * inverse;
+    auto t1 = (node.max - origin) * inverse;
+    auto slabEnter = glm::min(t0, t1), slabLeave = glm::max(t0, t1);
+    auto enter = std::max(std::max(slabEnter.x, slabEnter.y), std::max(slabEnter.z, 0.0f));
+    auto leave = std::min(std::min(slabLeave.x, slabLeave.y), std::min(slabLeave.z, maxDistance));
+    if (enter > leave) continue;
+
+    if (node.count) {
+      for (auto i = node.index; i < node.index + node.count; i++)
+        if (!test(order[i])) return;
+    } else {
+      stack[top++] = node.index;
+      stack[top++] = (uint32_t) (&node - nodes.data()) + 1;
+    }
+  }
+
+  for (auto entry = (uint32_t) built; entry < objects.size(); entry++)
+    if (!test(entry)) return;
+}
+
+bool Bvh::closestHit(const glm::vec3 &origin, const glm::vec3 &direction, Hit &hit) const {
+  float maxDistance = INFINITE_DISTANCE;
+  bool found = false;
+  traverse(origin, direction, maxDistance, [&](uint32_t entry, float distance) {
+    hit = {objects[entry], distance};
+    maxDistance = distance;
+    found = true;
+    return true;
+  });
+  return found;
+}
+
+bool Bvh::anyHit(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance, const Object *ignore) const {
+  bool found = false;
+  traverse(origin, direction, maxDistance, [&](uint32_t entry, float distance) {
+    if (objects[entry] == ignore) return true;
+    found = true;
+    return false;
+  });
+  return found;
+}
+
+size_t Bvh::intersect(const glm::vec3 &origin, const glm::vec3 &direction, Hit *hits, size_t maxHits) const {
+  if (!maxHits) return 0;
+  float maxDistance = INFINITE_DISTANCE;
+  size_t count = 0;
+  traverse(origin, direction, maxDistance, [&](uint32_t entry, float distance) {
+    // Insertion into the sorted array, the farthest hit drops out when it is full
+    size_t i = count < maxHits ? count++ : maxHits - 1;
+    for (; i > 0 && hits[i - 1].distance > distance; i--) hits[i] = hits[i - 1];
+    hits[i] = {objects[entry], distance};
+    if (count == maxHits) maxDistance = hits[maxHits - 1].distance;
+    return true;
+  });
+  return count;
+}
+
+namespace {
+  // Pickable object without GPU resources
+  class BenchSphere final : public Object {
+  public:
+    bool update(Scene &scene, float dt) override { return true; }
+    void render(Scene &scene) override {}
+  };
+}
+
+void Bvh::benchmark(int count, int rays) {
+  // Asteroid sized spheres, spread so that a ray passes a few dozen of them
+  std::vector<std::unique_ptr<Object>> objects;
+  auto extent = 10.0f * std::cbrt((float) count);
+  for (int i = 0; i < count; i++) {
+    auto object = std::make_unique<BenchSphere>();
+    object->position = glm::linearRand(glm::vec3{-extent}, glm::vec3{extent});
+    object->scale *= glm::linearRand(0.25f, 3.0f);
+    objects.push_back(move(object));
+  }
+
+  std::vector<glm::vec3> origins(rays), directions(rays);
+  for (int i = 0; i < rays; i++) {
+    origins[i] = glm::sphericalRand(2.0f * extent);
+    directions[i] = glm::linearRand(glm::vec3{-extent}, glm::vec3{extent}) - origins[i];
+  }
+
+  Bvh bvh;
+  std::vector<Object*> scanHits(rays), treeHits(rays);
+  float scan = 0.0f, tree = 0.0f;
+
+  // Second frame moves every object, so the tree is refit and queried again
+  for (int frame = 0; frame < 2; frame++) {
+    if (frame) for (auto &object : objects) object->position += glm::ballRand(1.0f);
+    bvh.beginUpdate();
+    for (auto &object : objects) bvh.insert(*object);
+    bvh.endUpdate();
+
+    scan = ppgso::averageTime<std::micro>(rays, [&](int i) {
+      Object *nearest = nullptr;
+      float nearestDistance = INFINITE_DISTANCE;
+      for (auto &object : objects) {
+        float distance;
+        auto sphere = glm::vec4(object->position, std::abs(object->scale.x));
+        if (raySphere(origins[i], directions[i], sphere, distance) && distance < nearestDistance) {
+          nearest = object.get();
+          nearestDistance = distance;
+        }
+      }
+      scanHits[i] = nearest;
+    });
+
+    tree = ppgso::averageTime<std::micro>(rays, [&](int i) {
+      Hit hit{nullptr, 0.0f};
+      bvh.closestHit(origins[i], directions[i], hit);
+      treeHits[i] = hit.object;
+    });
+  }
+
+  size_t hits = std::count_if(scanHits.begin(), scanHits.end(), [](Object *hit) { return hit != nullptr; });
+  std::cout << "Ray picking, " << count << " objects, " << rays << " rays (" << hits << " hit)" << std::endl;
+  std::cout << "  linear scan: " << scan << " us per ray" << std::endl;
+  std::cout << "  bvh:         " << tree << " us per ray (" << bvh.stats.nodes << " nodes, "
+            << bvh.stats.refits << " refits)" << std::endl;
+  std::cout << "  closest hits " << (scanHits == treeHits ? "same" : "DIFFERENT") << std::endl;
+}
@@ -0,0 +1,141 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class Object;
+
+/*!
+ * Bounding volume hierarchy over the bounding spheres of scene objects, used for ray queries
+ *
+ * Nodes are stored in one array in depth first order with at most LEAF_SIZE objects per leaf,
+ * children always come after their parent. The scene objects are inserted once per frame and every
+ * object remembers its entry (Object::bvhEntry): moved objects only refit the boxes bottom up in one
+ * reverse sweep. Objects not inserted again become empty leaves, new objects are kept in a short list
+ * next to the tree and tested one by one. The tree is rebuilt when too many objects changed or the
+ * refitted boxes grew too much.
+ *
+ * Queries use a fixed stack and write into caller memory, they never allocate and can run from
+ * several threads at once.
+ */
+class Bvh {
+public:
+  /*!
+   * Object hit by a ray, distance in units of the ray direction (0 when the ray starts inside)
+   */
+  struct Hit {
+    Object *object;
+    float distance;
+  };
+
+  /*!
+   * Counters of the last update
+   */
+  struct Stats {
+    size_t objects = 0;
+    size_t nodes = 0;
+    size_t pending = 0;
+    size_t removed = 0;
+    size_t rebuilds = 0;   // Since the tree was created
+    size_t refits = 0;     // Since the tree was created
+  };
+
+  /*!
+   * Start following the objects of a new frame, every live object is inserted after this
+   */
+  void beginUpdate();
+
+  /*!
+   * Add an object or update its sphere, which is its position and scale.x
+   * @param object - Live object, must stay at the same address until the next update
+   */
+  void insert(Object &object);
+
+  /*!
+   * Drop objects that were not inserted since beginUpdate, then refit or rebuild the tree
+   */
+  void endUpdate();
+
+  /*!
+   * Drop all objects, needed before the objects of the last update are destroyed outside of it
+   */
+  void clear();
+
+  /*!
+   * Nearest object hit by a ray
+   * @param origin - Ray origin
+   * @param direction - Ray direction, does not need to be normalized
+   * @param hit - Filled with the nearest hit
+   * @return true when anything was hit
+   */
+  bool closestHit(const glm::vec3 &origin, const glm::vec3 &direction, Hit &hit) const;
+
+  /*!
+   * Whether anything blocks a ray, stops at the first hit found (line of sight)
+   * @param origin - Ray origin
+   * @param direction - Ray direction, does not need to be normalized
+   * @param maxDistance - Only hits closer than this count, in units of direction
+   * @param ignore - Object to skip, usually the one casting the ray
+   * @return true when the ray is blocked
+   */
+  bool anyHit(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance,
+              const Object *ignore = nullptr) const;
+
+  /*!
+   * All objects hit by a ray, nearest first
+   * @param origin - Ray origin
+   * @param direction - Ray direction, does not need to be normalized
+   * @param hits - Array receiving the hits sorted by distance
+   * @param maxHits - Size of the array, only the nearest maxHits hits are kept
+   * @return Number of hits written
+   */
+  size_t intersect(const glm::vec3 &origin, const glm::vec3 &direction, Hit *hits, size_t maxHits) const;
+
+  /*!
+   * Counters of the last update
+   */
+  const Stats &getStats() const { return stats; }
+
+  /*!
+   * Compare a linear scan over all spheres with the tree for closest hit picking
+   * Prints the time per ray for both and checks they return the same objects.
+   * @param count - Number of objects
+   * @param rays - Rays to cast
+   */
+  static void benchmark(int count, int rays = 10000);
+
+private:
+  struct Node {
+    glm::vec3 min;
+    uint32_t index;   // Leaf: first entry in order, inner node: right child (left child is the next node)
+    glm::vec3 max;
+    uint32_t count;   // Objects in a leaf, 0 for inner nodes
+  };
+
+  static const uint32_t LEAF_SIZE = 4;
+  static const int STACK_SIZE = 64;
+
+  std::vector<Node> nodes;
+
+  // Objects by entry, entries [0, built) are in the tree, the rest are pending
+  std::vector<Object*> objects;
+  std::vector<glm::vec4> spheres;   // Center and radius, negative radius for removed objects
+  std::vector<uint32_t> seen;       // Update in which the entry was last inserted
+  std::vector<uint32_t> order;      // Entries of the tree sorted into leaves
+  size_t built = 0;
+  size_t removed = 0;
+  uint32_t frame = 0;
+
+  // Sum of inner node areas after the last build, refit trees that grow past twice this are rebuilt
+  float builtArea = 0.0f;
+
+  Stats stats;
+
+  void rebuild();
+  uint32_t buildNode(uint32_t begin, uint32_t end);
+  float refit();
+
+  template<typename Visitor>
+  void traverse(const glm::vec3 &origin, const glm::vec3 &direction, float &maxDistance, Visitor visit) const;
+};
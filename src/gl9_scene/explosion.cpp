@@ -11,6 +11,8 @@ std::unique_ptr<ppgso::Texture> Explosion::texture;
 std::unique_ptr<ppgso::Shader> Explosion::shader;
 
 Explosion::Explosion() {
+  tags = EXPLOSION_TAG;
+
   // Random rotation and momentum
   rotation = glm::ballRand(ppgso::PI)*3.0f;
   rotMomentum = glm::ballRand(ppgso::PI)*3.0f;
@@ -23,33 +25,13 @@ Explosion::Explosion() {
 }
 
 void Explosion::render(Scene &scene) {
-  shader->use();
+  // Transparent pass disables depth testing and uses additive blending
+  scene.renderQueue.submit(RenderQueue::TRANSPARENT_PASS, *this, *shader, *texture, *mesh);
+}
 
+void Explosion::prepareDraw(ppgso::Shader &shader) {
   // Transparency, interpolate from 1.0f -> 0.0f
-  shader->setUniform("Transparency", 1.0f - age / maxAge);
-
-  // use camera
-  shader->setUniform("ProjectionMatrix", scene.camera->projectionMatrix);
-  shader->setUniform("ViewMatrix", scene.camera->viewMatrix);
-
-  // render mesh
-  shader->setUniform("ModelMatrix", modelMatrix);
-  shader->setUniform("Texture", *texture);
-
-  // Disable depth testing
-  glDisable(GL_DEPTH_TEST);
-
-  // Enable blending
-  glEnable(GL_BLEND);
-  // Additive blending
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-
-  mesh->render();
-
-  // Disable blending
-  glDisable(GL_BLEND);
-  // Enable depth test
-  glEnable(GL_DEPTH_TEST);
+  shader.setUniform("Transparency", 1.0f - age / maxAge);
 }
 
 bool Explosion::update(Scene &scene, float dt) {
@@ -36,5 +36,11 @@ public:
    * @param scene Scene to render in
    */
   void render(Scene &scene) override;
+
+  /*!
+   * Set transparency of the explosion
+   * @param shader Program the explosion is drawn with
+   */
+  void prepareDraw(ppgso::Shader &shader) override;
 };
 
@@ -10,10 +10,9 @@ bool Generator::update(Scene &scene, float dt) {
 
   // Add object to scene when time reaches certain level
   if (time > .3) {
-    auto obj = std::make_unique<Asteroid>();
-    obj->position = position;
-    obj->position.x += glm::linearRand(-20.0f, 20.0f);
-    scene.objects.push_back(move(obj));
+    auto &obj = scene.spawn<Asteroid>();
+    obj.position = position;
+    obj.position.x += glm::linearRand(-20.0f, 20.0f);
     time = 0;
   }
 
@@ -4,7 +4,12 @@
 // - Creates a simple game scene with Player, Asteroid and Space objects
 // - Contains a generator object that does not render but adds Asteroids to the scene
 // - Some objects use shared resources and all object deallocations are handled automatically
-// - Controls: LEFT, RIGHT, "R" to reset, SPACE to fire
+// - Objects live in contiguous per type pools, spawns and removals are applied between frames
+// - Draws are queued and submitted sorted by program, texture and mesh (see RenderQueue)
+// - Collisions query a spatial hash rebuilt every frame instead of testing every object (see SpatialHash)
+// - Mouse picking traverses a bounding volume hierarchy refit every frame (see Bvh)
+// - Controls: LEFT, RIGHT, "R" to reset, SPACE to fire, "I" to print render queue statistics,
+//   "B" to benchmark the collision broadphase and ray picking
 
 #include <iostream>
 #include <map>
@@ -30,10 +35,10 @@ private:
 
   /*!
    * Reset and initialize the game scene
-   * Creating unique smart pointers to objects that are stored in the scene object list
+   * Spawning objects that are stored in the per type pools of the scene
    */
   void initScene() {
-    scene.objects.clear();
+    scene.clear();
 
     // Create a camera
     auto camera = std::make_unique<Camera>(60.0f, 1.0f, 0.1f, 100.0f);
@@ -41,17 +46,15 @@ private:
     scene.camera = move(camera);
 
     // Add space background
-    scene.objects.push_back(std::make_unique<Space>());
+    scene.spawn<Space>();
 
     // Add generator to scene
-    auto generator = std::make_unique<Generator>();
-    generator->position.y = 10.0f;
-    scene.objects.push_back(move(generator));
+    auto &generator = scene.spawn<Generator>();
+    generator.position.y = 10.0f;
 
     // Add player to the scene
-    auto player = std::make_unique<Player>();
-    player->position.y = -6;
-    scene.objects.push_back(move(player));
+    auto &player = scene.spawn<Player>();
+    player.position.y = -6;
   }
 
 public:
@@ -94,6 +97,17 @@ public:
     if (key == GLFW_KEY_P && action == GLFW_PRESS) {
       animate = !animate;
     }
+
+    // State changes of the last frame
+    if (key == GLFW_KEY_I && action == GLFW_PRESS) {
+      scene.renderQueue.printStats();
+    }
+
+    // Linear loops against the spatial hash and the bvh with 10k objects
+    if (key == GLFW_KEY_B && action == GLFW_PRESS) {
+      SpatialHash::benchmark(10000);
+      Bvh::benchmark(10000);
+    }
   }
 
   /*!
@@ -125,13 +139,14 @@ public:
         auto direction = scene.camera->cast(u, v);
         auto position = scene.camera->position;
 
-        // Get all objects in scene intersected by ray
-        auto picked = scene.intersect(position, direction);
+        // Get objects in scene intersected by ray, nearest first
+        Bvh::Hit picked[16];
+        auto count = scene.intersect(position, direction, picked, 16);
 
         // Go through all objects that have been picked
-        for (auto &obj: picked) {
+        for (size_t i = 0; i < count; i++) {
           // Pass on the click event
-          obj->onClick(scene);
+          picked[i].object->onClick(scene);
         }
       }
     }
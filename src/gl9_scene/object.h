@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <memory>
 #include <list>
 #include <map>
@@ -8,6 +9,10 @@
 // Forward declare a scene
 class Scene;
 
+namespace ppgso {
+  class Shader;
+}
+
 /*!
  *  Abstract scene object interface
  *  All objects in the scene should be able to update and render
@@ -19,6 +24,8 @@ public:
   Object() = default;
   Object(const Object&) = default;
   Object(Object&&) = default;
+  Object &operator=(const Object&) = default;
+  Object &operator=(Object&&) = default;
   virtual ~Object() {};
 
   /*!
@@ -32,10 +39,18 @@ public:
 
   /*!
    * Render the object in the scene
+   * Objects queue their geometry in scene.renderQueue, the queue draws it sorted by state
    * @param scene
    */
   virtual void render(Scene &scene) = 0;
 
+  /*!
+   * Set per draw uniforms right before the queued mesh is drawn
+   * Camera, ModelMatrix and Texture are set by the queue
+   * @param shader - Program the mesh is drawn with, already in use
+   */
+  virtual void prepareDraw(ppgso::Shader &shader) {}
+
 
   /*!
    * Event to be called when the object is clicked
@@ -43,12 +58,26 @@ public:
    */
   virtual void onClick(Scene &scene) {};
 
+  /*!
+   * Type bits of an object, collision queries filter by them instead of using dynamic_cast
+   */
+  enum Tag : uint32_t {
+    ASTEROID_TAG = 1 << 0,
+    PROJECTILE_TAG = 1 << 1,
+    PLAYER_TAG = 1 << 2,
+    EXPLOSION_TAG = 1 << 3
+  };
+
   // Object properties
+  uint32_t tags{0};
   glm::vec3 position{0,0,0};
   glm::vec3 rotation{0,0,0};
   glm::vec3 scale{1,1,1};
   glm::mat4 modelMatrix{1};
 
+  // Entry of the object in the scene Bvh, maintained by the Bvh
+  uint32_t bvhEntry{0xffffffffu};
+
 protected:
   /*!
    * Generate modelMatrix from position, rotation and scale
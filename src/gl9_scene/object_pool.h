@@ -0,0 +1,142 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "object.h"
+#include "spatial_hash.h"
+
+/*!
+ * Type erased interface of an ObjectPool, lets the scene walk pools of all object types
+ */
+class ObjectPoolBase {
+public:
+  virtual ~ObjectPoolBase() = default;
+
+  /*!
+   * Number of live objects
+   */
+  virtual size_t size() const = 0;
+
+  /*!
+   * Live object by index, indices change when objects are destroyed
+   */
+  virtual Object &at(size_t index) = 0;
+
+  /*!
+   * Update all live objects, objects returning false are queued for destruction
+   * @param scene - Scene passed to the objects
+   * @param dt - Time delta
+   * @param hash - Broadphase built from the same walk, destroyed objects are removed from it right away
+   * @param entry - Hash entry of the first object, advanced past the objects of this pool
+   */
+  virtual void update(Scene &scene, float dt, SpatialHash &hash, size_t &entry) = 0;
+
+  /*!
+   * Render all live objects
+   */
+  virtual void render(Scene &scene) = 0;
+
+  /*!
+   * Add queued spawns to the live objects
+   */
+  virtual void applySpawns() = 0;
+
+  /*!
+   * Remove objects queued for destruction
+   */
+  virtual void applyDestroys() = 0;
+
+  /*!
+   * Drop all live and queued objects, the storage is kept for reuse
+   */
+  virtual void clear() = 0;
+
+  /*!
+   * Dense index of type T, used to find its pool
+   */
+  template<typename T>
+  static size_t typeIndex() {
+    static const size_t index = nextTypeIndex()++;
+    return index;
+  }
+
+private:
+  static size_t &nextTypeIndex() {
+    static size_t next = 0;
+    return next;
+  }
+};
+
+/*!
+ * Contiguous storage of all objects of one type
+ *
+ * Live objects are packed at the front of one array and updated and rendered in a linear walk, the
+ * final type lets the compiler call update and render directly. A destroyed object is replaced by
+ * the last live one and its storage joins the unused tail, which the next spawn reuses, so once
+ * the pool has grown to its peak size spawning and destroying does not allocate.
+ *
+ * Spawns and destructions are queued and applied between frames, the array never changes while
+ * it is being walked.
+ */
+template<typename T>
+class ObjectPool final : public ObjectPoolBase {
+public:
+  /*!
+   * Queue a new object, valid until the next spawn of the same type
+   * @return Object to set up, it joins the scene at the next applySpawns
+   */
+  T &spawn() {
+    spawned.emplace_back();
+    return spawned.back();
+  }
+
+  size_t size() const override { return count; }
+
+  Object &at(size_t index) override { return objects[index]; }
+
+  void update(Scene &scene, float dt, SpatialHash &hash, size_t &entry) override {
+    for (size_t i = 0; i < count; i++, entry++) {
+      if (objects[i].update(scene, dt)) continue;
+      hash.remove(entry);
+      destroyed.push_back((uint32_t) i);
+    }
+  }
+
+  void render(Scene &scene) override {
+    for (size_t i = 0; i < count; i++)
+      objects[i].render(scene);
+  }
+
+  void applySpawns() override {
+    for (auto &object : spawned) {
+      if (count < objects.size()) objects[count] = std::move(object);
+      else objects.push_back(std::move(object));
+      count++;
+    }
+    spawned.clear();
+  }
+
+  void applyDestroys() override {
+    // Highest index first, so the last object moved into a hole is never itself queued
+    for (auto i = destroyed.size(); i-- > 0;) {
+      auto index = destroyed[i];
+      if (index != count - 1) objects[index] = std::move(objects[count - 1]);
+      count--;
+    }
+    destroyed.clear();
+  }
+
+  void clear() override {
+    count = 0;
+    spawned.clear();
+    destroyed.clear();
+  }
+
+private:
+  // Live objects are [0, count), the rest is storage of destroyed objects kept for reuse
+  std::vector<T> objects;
+  size_t count = 0;
+
+  std::vector<T> spawned;
+  std::vector<uint32_t> destroyed;
+};
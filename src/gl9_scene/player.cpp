@@ -13,6 +13,8 @@ std::unique_ptr<ppgso::Texture> Player::texture;
 std::unique_ptr<ppgso::Shader> Player::shader;
 
 Player::Player() {
+  tags = PLAYER_TAG;
+
   // Scale the default model
   scale *= 3.0f;
 
@@ -26,26 +28,21 @@ bool Player::update(Scene &scene, float dt) {
   // Fire delay increment
   fireDelay += dt;
 
-  // Hit detection
-  for ( auto& obj : scene.objects ) {
-    // Ignore self in scene
-    if (obj.get() == this)
-      continue;
-
-    // We only need to collide with asteroids, ignore other objects
-    auto asteroid = dynamic_cast<Asteroid*>(obj.get());
-    if (!asteroid) continue;
-
-    if (distance(position, asteroid->position) < asteroid->scale.y) {
-      // Explode
-      auto explosion = std::make_unique<Explosion>();
-      explosion->position = position;
-      explosion->scale = scale * 3.0f;
-      scene.objects.push_back(move(explosion));
-
-      // Die
-      return false;
-    }
+  // Hit detection, we only need to collide with asteroids
+  bool hit = false;
+  scene.spatialHash.query(position, 0.0f, ASTEROID_TAG, [&](Object &asteroid) {
+    hit = distance(position, asteroid.position) < asteroid.scale.y;
+    return !hit;
+  });
+
+  if (hit) {
+    // Explode
+    auto &explosion = scene.spawn<Explosion>();
+    explosion.position = position;
+    explosion.scale = scale * 3.0f;
+
+    // Die
+    return false;
   }
 
   // Keyboard controls
@@ -66,9 +63,8 @@ bool Player::update(Scene &scene, float dt) {
     // Invert file offset
     fireOffset = -fireOffset;
 
-    auto projectile = std::make_unique<Projectile>();
-    projectile->position = position + glm::vec3(0.0f, 0.0f, 0.3f) + fireOffset;
-    scene.objects.push_back(move(projectile));
+    auto &projectile = scene.spawn<Projectile>();
+    projectile.position = position + glm::vec3(0.0f, 0.0f, 0.3f) + fireOffset;
   }
 
   generateModelMatrix();
@@ -76,19 +72,8 @@ bool Player::update(Scene &scene, float dt) {
 }
 
 void Player::render(Scene &scene) {
-  shader->use();
-
-  // Set up light
-  shader->setUniform("LightDirection", scene.lightDirection);
-
-  // use camera
-  shader->setUniform("ProjectionMatrix", scene.camera->projectionMatrix);
-  shader->setUniform("ViewMatrix", scene.camera->viewMatrix);
-
-  // render mesh
-  shader->setUniform("ModelMatrix", modelMatrix);
-  shader->setUniform("Texture", *texture);
-  mesh->render();
+  // Light, camera and modelMatrix are set by the queue
+  scene.renderQueue.submit(RenderQueue::OPAQUE_PASS, *this, *shader, *texture, *mesh);
 }
 
 void Player::onClick(Scene &scene) {
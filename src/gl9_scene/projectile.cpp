@@ -4,20 +4,25 @@
 
 #include <shaders/diffuse_vert_glsl.h>
 #include <shaders/diffuse_frag_glsl.h>
+#include <shaders/diffuse_instanced_vert_glsl.h>
 
 
 // shared resources
 std::unique_ptr<ppgso::Mesh> Projectile::mesh;
 std::unique_ptr<ppgso::Shader> Projectile::shader;
+std::unique_ptr<ppgso::Shader> Projectile::instancedShader;
 std::unique_ptr<ppgso::Texture> Projectile::texture;
 
 Projectile::Projectile() {
+  tags = PROJECTILE_TAG;
+
   // Set default speed
   speed = {0.0f, 3.0f, 0.0f};
   rotMomentum = {0.0f, 0.0f, glm::linearRand(-ppgso::PI/4.0f, ppgso::PI/4.0f)};
 
   // Initialize static resources if needed
   if (!shader) shader = std::make_unique<ppgso::Shader>(diffuse_vert_glsl, diffuse_frag_glsl);
+  if (!instancedShader) instancedShader = std::make_unique<ppgso::Shader>(diffuse_instanced_vert_glsl, diffuse_frag_glsl);
   if (!texture) texture = std::make_unique<ppgso::Texture>(ppgso::image::loadBMP("missile.bmp"));
   if (!mesh) mesh = std::make_unique<ppgso::Mesh>("missile.obj");
 }
@@ -41,19 +46,8 @@ bool Projectile::update(Scene &scene, float dt) {
 }
 
 void Projectile::render(Scene &scene) {
-  shader->use();
-
-  // Set up light
-  shader->setUniform("LightDirection", scene.lightDirection);
-
-  // use camera
-  shader->setUniform("ProjectionMatrix", scene.camera->projectionMatrix);
-  shader->setUniform("ViewMatrix", scene.camera->viewMatrix);
-
-  // render mesh
-  shader->setUniform("ModelMatrix", modelMatrix);
-  shader->setUniform("Texture", *texture);
-  mesh->render();
+  // Light, camera and modelMatrix are set by the queue, all projectiles are drawn with one instanced draw
+  scene.renderQueue.submit(RenderQueue::OPAQUE_PASS, *this, *shader, *texture, *mesh, instancedShader.get());
 }
 
 void Projectile::destroy() {
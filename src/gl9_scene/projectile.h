@@ -9,6 +9,7 @@
 class Projectile final : public Object {
 private:
   static std::unique_ptr<ppgso::Shader> shader;
+  static std::unique_ptr<ppgso::Shader> instancedShader;
   static std::unique_ptr<ppgso::Mesh> mesh;
   static std::unique_ptr<ppgso::Texture> texture;
 
@@ -0,0 +1,238 @@
+#include <cstring>
+#include <iostream>
+
+#include "render_queue.h"
+#include "object.h"
+#include "camera.h"
+
+// Sort key layout, highest bits first:
+//   opaque and background: pass(2) | program(10) | texture(10) | mesh(10) | depth(32)
+//   transparent:           pass(2) | inverted depth(32) | program(10) | texture(10) | mesh(10)
+static const uint32_t ID_MASK = 0x3ff;
+
+RenderQueue::~RenderQueue() {
+  if (instanceBuffer) glDeleteBuffers(1, &instanceBuffer);
+}
+
+void RenderQueue::begin(const Camera &camera, const glm::vec3 &lightDirection) {
+  viewMatrix = camera.viewMatrix;
+  projectionMatrix = camera.projectionMatrix;
+  this->lightDirection = lightDirection;
+  draws.clear();
+}
+
+void RenderQueue::submit(Pass pass, Object &object, ppgso::Shader &shader, ppgso::Texture &texture, ppgso::Mesh &mesh,
+                         ppgso::Shader *instancedShader) {
+  draws.push_back({pass, &object, &shader, &texture, &mesh, instancedShader});
+}
+
+uint32_t RenderQueue::getId(const void *resource) {
+  auto found = ids.find(resource);
+  if (found != ids.end()) return found->second;
+
+  // More than 1024 resources only share ids, the order within a state gets worse but stays valid
+  auto id = (uint32_t) ids.size() & ID_MASK;
+  ids.emplace(resource, id);
+  return id;
+}
+
+uint64_t RenderQueue::makeKey(const Draw &draw) {
+  // View space distance, positive floats sort like their bit patterns
+  float depth = -(viewMatrix * draw.object->modelMatrix[3]).z;
+  if (draw.pass == BACKGROUND_PASS || !(depth > 0.0f)) depth = 0.0f;
+  uint32_t depthBits;
+  std::memcpy(&depthBits, &depth, sizeof(depthBits));
+
+  uint64_t state = (uint64_t) getId(draw.shader) << 20 | (uint64_t) getId(draw.texture) << 10 | getId(draw.mesh);
+  uint64_t pass = (uint64_t) draw.pass << 62;
+
+  if (draw.pass == TRANSPARENT_PASS)
+    return pass | (uint64_t) ~depthBits << 30 | state;
+  return pass | state << 32 | depthBits;
+}
+
+void RenderQueue::radixSort() {
+  // LSD radix sort by bytes, bytes where all keys are equal are skipped
+  scratch.resize(entries.size());
+  for (int shift = 0; shift < 64; shift += 8) {
+    size_t counts[256] = {};
+    for (auto &entry : entries)
+      counts[(entry.key >> shift) & 0xff]++;
+    if (counts[(entries[0].key >> shift) & 0xff] == entries.size()) continue;
+
+    size_t offset = 0;
+    for (auto &count : counts) {
+      size_t bucket = count;
+      count = offset;
+      offset += bucket;
+    }
+    for (auto &entry : entries)
+      scratch[counts[(entry.key >> shift) & 0xff]++] = entry;
+    entries.swap(scratch);
+  }
+}
+
+void RenderQueue::setPassState(Pass pass) {
+  switch (pass) {
+    case BACKGROUND_PASS:
+      glEnable(GL_DEPTH_TEST);
+      glDepthMask(GL_FALSE);
+      glDisable(GL_BLEND);
+      break;
+    case OPAQUE_PASS:
+      glEnable(GL_DEPTH_TEST);
+      glDepthMask(GL_TRUE);
+      glDisable(GL_BLEND);
+      break;
+    case TRANSPARENT_PASS:
+      glDisable(GL_DEPTH_TEST);
+      glDepthMask(GL_TRUE);
+      glEnable(GL_BLEND);
+      glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+      break;
+  }
+}
+
+void RenderQueue::buildRuns() {
+  // Same state means same sort key without the depth, so such draws are already next to each other
+  runs.clear();
+  instanceMatrices.clear();
+  for (uint32_t begin = 0; begin < entries.size();) {
+    auto &first = draws[entries[begin].draw];
+    uint32_t end = begin + 1;
+    if (first.instancedShader) {
+      while (end < entries.size()) {
+        auto &next = draws[entries[end].draw];
+        if (next.pass != first.pass || next.shader != first.shader || next.texture != first.texture ||
+            next.mesh != first.mesh || next.instancedShader != first.instancedShader) break;
+        end++;
+      }
+    }
+
+    if (end - begin >= MIN_INSTANCES) {
+      runs.push_back({begin, end, instanceMatrices.size() * sizeof(glm::mat4)});
+      for (uint32_t i = begin; i < end; i++)
+        instanceMatrices.push_back(draws[entries[i].draw].object->modelMatrix);
+    } else {
+      for (uint32_t i = begin; i < end; i++)
+        runs.push_back({i, i + 1, NOT_INSTANCED});
+    }
+    begin = end;
+  }
+
+  if (instanceMatrices.empty()) return;
+
+  // One upload for the whole frame, orphaning the previous contents
+  if (!instanceBuffer) glGenBuffers(1, &instanceBuffer);
+  glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+  glBufferData(GL_ARRAY_BUFFER, instanceMatrices.size() * sizeof(glm::mat4), instanceMatrices.data(), GL_STREAM_DRAW);
+}
+
+void RenderQueue::flush() {
+  stats = Stats();
+  stats.draws = draws.size();
+  if (draws.empty()) return;
+
+  entries.clear();
+  for (size_t i = 0; i < draws.size(); i++)
+    entries.push_back({makeKey(draws[i]), (uint32_t) i});
+  radixSort();
+  buildRuns();
+
+  for (auto &program : programs)
+    program.second.cameraPass = -1;
+
+  int currentPass = -1;
+  const ppgso::Shader *currentShader = nullptr;
+  const ppgso::Texture *currentTexture = nullptr;
+
+  for (auto &run : runs) {
+    auto &draw = draws[entries[run.begin].draw];
+    bool instanced = run.offset != NOT_INSTANCED;
+    ppgso::Shader *shader = instanced ? draw.instancedShader : draw.shader;
+
+    if (draw.pass != currentPass) {
+      setPassState(draw.pass);
+      currentPass = draw.pass;
+      stats.passChanges++;
+    }
+
+    // Uniform handles are resolved the first time a program is seen
+    auto found = programs.find(shader);
+    if (found == programs.end()) {
+      Program program;
+      program.projection = shader->getUniform<glm::mat4>("ProjectionMatrix");
+      program.view = shader->getUniform<glm::mat4>("ViewMatrix");
+      program.model = shader->getUniform<glm::mat4>("ModelMatrix");
+      program.lightDirection = shader->getUniform<glm::vec3>("LightDirection");
+      program.texture = shader->getUniform<int>("Texture");
+      found = programs.emplace(shader, program).first;
+    }
+    auto &program = found->second;
+
+    if (shader != currentShader) {
+      shader->use();
+      currentShader = shader;
+      stats.programBinds++;
+    }
+
+    // Camera once per program, background draws use screen space
+    int cameraPass = draw.pass == BACKGROUND_PASS ? BACKGROUND_PASS : OPAQUE_PASS;
+    if (program.cameraPass != cameraPass) {
+      bool screen = cameraPass == BACKGROUND_PASS;
+      program.projection.set(screen ? glm::mat4{1.0f} : projectionMatrix);
+      program.view.set(screen ? glm::mat4{1.0f} : viewMatrix);
+      program.lightDirection.set(lightDirection);
+      program.texture.set(0);
+      program.cameraPass = cameraPass;
+      stats.cameraUploads++;
+    }
+
+    if (draw.texture != currentTexture) {
+      draw.texture->bind(0);
+      currentTexture = draw.texture;
+      stats.textureBinds++;
+    }
+
+    if (instanced) {
+      // Model matrices of the run are in the instance buffer
+      GLsizei count = run.end - run.begin;
+      draw.mesh->setInstanceBuffer(instanceBuffer, 3, run.offset);
+      draw.mesh->renderInstanced(count);
+      stats.instancedBatches++;
+      stats.instancedDraws += count;
+    } else {
+      program.model.set(draw.object->modelMatrix);
+      draw.object->prepareDraw(*draw.shader);
+      draw.mesh->render();
+    }
+    stats.drawCalls++;
+
+    // Without the queue every draw sets everything itself, passes other than opaque also restore state
+    for (uint32_t i = run.begin; i < run.end; i++) {
+      stats.naiveProgramBinds++;
+      stats.naiveTextureBinds++;
+      stats.naiveCameraUploads++;
+      if (draws[entries[i].draw].pass != OPAQUE_PASS) stats.naivePassChanges += 2;
+    }
+  }
+
+  if (currentPass != OPAQUE_PASS) {
+    setPassState(OPAQUE_PASS);
+    stats.passChanges++;
+  }
+}
+
+void RenderQueue::printStats() const {
+  auto line = [](const char *name, size_t issued, size_t naive) {
+    std::cout << "  " << name << issued << " (without sorting " << naive << ", saved "
+              << (long) naive - (long) issued << ")" << std::endl;
+  };
+  std::cout << "Render queue, last frame: " << stats.draws << " draws" << std::endl;
+  line("draw calls:     ", stats.drawCalls, stats.draws);
+  std::cout << "  instanced:      " << stats.instancedDraws << " draws in " << stats.instancedBatches << " batches" << std::endl;
+  line("program binds:  ", stats.programBinds, stats.naiveProgramBinds);
+  line("texture binds:  ", stats.textureBinds, stats.naiveTextureBinds);
+  line("camera uploads: ", stats.cameraUploads, stats.naiveCameraUploads);
+  line("blend / depth:  ", stats.passChanges, stats.naivePassChanges);
+}
@@ -0,0 +1,151 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <ppgso/ppgso.h>
+
+class Object;
+class Camera;
+
+/*!
+ * Collects the draw calls of one frame and submits them sorted by state
+ *
+ * Objects queue their mesh instead of drawing it right away. At flush the draws get a 64bit sort key
+ * (pass, shader program, texture, mesh, depth), the keys are radix sorted and the draws are submitted
+ * in key order. A program, texture or blend/depth state is only set when it differs from the previous
+ * draw and the camera uniforms are uploaded once per program and frame.
+ *
+ * Consecutive draws with the same state whose object provides an instanced program are merged: their
+ * model matrices go to one instance buffer shared by the whole frame and the run is drawn with a single
+ * glDrawElementsInstanced.
+ */
+class RenderQueue {
+public:
+  /*!
+   * Render passes in submission order, each with its own fixed blend and depth state
+   */
+  enum Pass {
+    BACKGROUND_PASS = 0,  // Screen space, no camera, does not write depth
+    OPAQUE_PASS = 1,      // Front to back within the same state
+    TRANSPARENT_PASS = 2  // Additive blending without depth test, back to front
+  };
+
+  /*!
+   * State changes issued by the last flush, and how many the same draws issue when every
+   * object sets up its own program, camera, texture and blend state
+   */
+  struct Stats {
+    size_t draws = 0;
+    size_t drawCalls = 0;
+    size_t instancedBatches = 0;
+    size_t instancedDraws = 0;
+    size_t programBinds = 0;
+    size_t textureBinds = 0;
+    size_t passChanges = 0;
+    size_t cameraUploads = 0;
+    size_t naiveProgramBinds = 0;
+    size_t naiveTextureBinds = 0;
+    size_t naivePassChanges = 0;
+    size_t naiveCameraUploads = 0;
+  };
+
+  RenderQueue() = default;
+  RenderQueue(const RenderQueue&) = delete;
+  RenderQueue &operator=(const RenderQueue&) = delete;
+  ~RenderQueue();
+
+  /*!
+   * Start a new frame, drops all queued draws
+   * @param camera - Camera used by the OPAQUE_PASS and TRANSPARENT_PASS
+   * @param lightDirection - Directional light passed to programs that have LightDirection
+   */
+  void begin(const Camera &camera, const glm::vec3 &lightDirection);
+
+  /*!
+   * Queue the mesh of an object, rendered with the object modelMatrix
+   * Object::prepareDraw is called right before the mesh is drawn to set per draw uniforms.
+   *
+   * @param pass - Pass to render in
+   * @param object - Object the draw belongs to
+   * @param shader - Program to draw with
+   * @param texture - Texture bound as "Texture" on unit 0
+   * @param mesh - Geometry to draw
+   * @param instancedShader - Same program reading ModelMatrix as attribute (locations 3 - 6), or nullptr.
+   *        Draws that provide it may be merged into one instanced draw and skip Object::prepareDraw.
+   */
+  void submit(Pass pass, Object &object, ppgso::Shader &shader, ppgso::Texture &texture, ppgso::Mesh &mesh,
+              ppgso::Shader *instancedShader = nullptr);
+
+  /*!
+   * Sort the queued draws and render them, leaves depth test on, depth writes on and blending off
+   */
+  void flush();
+
+  /*!
+   * Statistics of the last flush
+   */
+  const Stats &getStats() const { return stats; }
+
+  /*!
+   * Print statistics of the last flush to standard output
+   */
+  void printStats() const;
+
+private:
+  struct Draw {
+    Pass pass;
+    Object *object;
+    ppgso::Shader *shader;
+    ppgso::Texture *texture;
+    ppgso::Mesh *mesh;
+    ppgso::Shader *instancedShader;
+  };
+
+  // Sorted entries [begin, end) drawn together, instanced when offset is not NOT_INSTANCED
+  struct Run {
+    uint32_t begin, end;
+    size_t offset;
+  };
+  static const size_t NOT_INSTANCED = ~(size_t) 0;
+
+  // Fewest draws merged into an instanced one
+  static const uint32_t MIN_INSTANCES = 2;
+
+  struct SortEntry {
+    uint64_t key;
+    uint32_t draw;
+  };
+
+  // Handles of the uniforms the queue sets itself, resolved once per program
+  struct Program {
+    ppgso::Shader::Uniform<glm::mat4> projection, view, model;
+    ppgso::Shader::Uniform<glm::vec3> lightDirection;
+    ppgso::Shader::Uniform<int> texture;
+    int cameraPass = -1;  // Pass whose camera is uploaded, -1 before the first draw in a frame
+  };
+
+  glm::mat4 viewMatrix{1.0f}, projectionMatrix{1.0f};
+  glm::vec3 lightDirection{0.0f};
+
+  std::vector<Draw> draws;
+  std::vector<SortEntry> entries, scratch;
+  std::vector<Run> runs;
+
+  // Model matrices of all instanced runs of the frame
+  std::vector<glm::mat4> instanceMatrices;
+  GLuint instanceBuffer = 0;
+
+  // Small dense ids of resources for the sort key, stable for the lifetime of the queue
+  std::unordered_map<const void *, uint32_t> ids;
+  std::unordered_map<const ppgso::Shader *, Program> programs;
+
+  Stats stats;
+
+  uint32_t getId(const void *resource);
+  uint64_t makeKey(const Draw &draw);
+  void radixSort();
+  void buildRuns();
+  static void setPassState(Pass pass);
+};
@@ -3,53 +3,53 @@
 void Scene::update(float time) {
   camera->update();
 
-  // Use iterator to update all objects so we can remove while iterating
-  auto i = std::begin(objects);
-
-  while (i != std::end(objects)) {
-    // Update and remove from list if needed
-    auto obj = i->get();
-    if (!obj->update(*this, time))
-      i = objects.erase(i); // NOTE: no need to call destructors as we store shared pointers in the scene
-    else
-      ++i;
-  }
+  // Spawns of the last frame join the scene, new spawns only queue up until the next update
+  for (auto &pool : pools)
+    if (pool) pool->applySpawns();
+
+  // Positions at the start of the frame, objects added during the update are found next frame
+  spatialHash.clear();
+  for (auto &pool : pools)
+    if (pool) for (size_t i = 0; i < pool->size(); i++) spatialHash.insert(pool->at(i));
+  spatialHash.build();
+
+  // Objects returning false are queued for removal and no longer found by collision queries
+  // Indexed, the first spawn of a new type adds a pool and may move the vector
+  size_t entry = 0;
+  for (size_t i = 0; i < pools.size(); i++)
+    if (pools[i]) pools[i]->update(*this, time, spatialHash, entry);
+
+  for (auto &pool : pools)
+    if (pool) pool->applyDestroys();
+
+  // Follow moved, removed and added objects for picking
+  bvh.beginUpdate();
+  for (auto &pool : pools)
+    if (pool) for (size_t i = 0; i < pool->size(); i++) bvh.insert(pool->at(i));
+  bvh.endUpdate();
 }
 
 void Scene::render() {
-  // Simply render all objects
-  for ( auto& obj : objects )
-    obj->render(*this);
+  // Objects queue their draws, the queue submits them grouped by program, texture and mesh
+  renderQueue.begin(*camera, lightDirection);
+  for (auto &pool : pools)
+    if (pool) pool->render(*this);
+  renderQueue.flush();
 }
 
-std::vector<Object*> Scene::intersect(const glm::vec3 &position, const glm::vec3 &direction) {
-  std::vector<Object*> intersected = {};
-  for(auto& object : objects) {
-    // Collision with sphere of size object->scale.x
-    auto oc = position - object->position;
-    auto radius = object->scale.x;
-    auto a = glm::dot(direction, direction);
-    auto b = glm::dot(oc, direction);
-    auto c = glm::dot(oc, oc) - radius * radius;
-    auto dis = b * b - a * c;
-
-    if (dis > 0) {
-      auto e = sqrt(dis);
-      auto t = (-b - e) / a;
-
-      if ( t > 0 ) {
-        intersected.push_back(object.get());
-        continue;
-      }
-
-      t = (-b + e) / a;
-
-      if ( t > 0 ) {
-        intersected.push_back(object.get());
-        continue;
-      }
-    }
-  }
-
-  return intersected;
+void Scene::clear() {
+  for (auto &pool : pools)
+    if (pool) pool->clear();
+  bvh.clear();
+}
+
+size_t Scene::size() const {
+  size_t count = 0;
+  for (auto &pool : pools)
+    if (pool) count += pool->size();
+  return count;
+}
+
+size_t Scene::intersect(const glm::vec3 &position, const glm::vec3 &direction, Bvh::Hit *hits, size_t maxHits) const {
+  return bvh.intersect(position, direction, hits, maxHits);
 }
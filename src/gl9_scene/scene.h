@@ -3,42 +3,76 @@
 
 #include <memory>
 #include <map>
-#include <list>
+#include <vector>
 
 #include "object.h"
+#include "object_pool.h"
 #include "camera.h"
+#include "render_queue.h"
+#include "spatial_hash.h"
+#include "bvh.h"
 
 /*
  * Scene is an object that will aggregate all scene related data
- * Objects are stored in a list of objects
+ * Objects are stored in one contiguous pool per object type, see ObjectPool
  * Keyboard and Mouse states are stored in a map and struct
  */
 class Scene {
   public:
     /*!
      * Update all objects in the scene
+     * Objects spawned since the last update join the scene first, objects that return false from
+     * their update are removed at the end.
      * @param time
      */
     void update(float time);
 
+    /*!
+     * Create a new object, it joins the scene at the start of the next update
+     * The reference is only valid until the next spawn of the same type, use it to set the object up.
+     * @return Object of type T constructed with its default constructor
+     */
+    template<typename T>
+    T &spawn() {
+      return pool<T>().spawn();
+    }
+
+    /*!
+     * Remove all objects including queued spawns right away
+     */
+    void clear();
+
+    /*!
+     * Number of objects in the scene
+     */
+    size_t size() const;
+
     /*!
      * Render all objects in the scene
      */
     void render();
 
     /*!
-     * Pick objects using a ray
+     * Pick objects using a ray, tested against the bounding sphere of size object->scale.x
      * @param position - Position in the scene to pick object from
      * @param direction - Direction to pick objects from
-     * @return Objects - Vector of pointers to intersected objects
+     * @param hits - Array receiving the intersected objects, nearest first
+     * @param maxHits - Size of the array
+     * @return Number of intersected objects written to hits
      */
-    std::vector<Object*> intersect(const glm::vec3 &position, const glm::vec3 &direction);
+    size_t intersect(const glm::vec3 &position, const glm::vec3 &direction, Bvh::Hit *hits, size_t maxHits) const;
 
     // Camera object
     std::unique_ptr<Camera> camera;
 
-    // All objects to be rendered in scene
-    std::list< std::unique_ptr<Object> > objects;
+    // Draw calls of the current frame, sorted by state on render
+    RenderQueue renderQueue;
+
+    // Objects by position for collision queries, rebuilt at the start of update
+    SpatialHash spatialHash;
+
+    // Bounding spheres for ray queries, refit at the end of update
+    Bvh bvh;
 
     // Keyboard state
     std::map< int, int > keyboard;
@@ -51,6 +85,18 @@ class Scene {
       double x, y;
       bool left, right;
     } cursor;
+
+  private:
+    // All objects to be rendered in scene, indexed by ObjectPoolBase::typeIndex
+    std::vector< std::unique_ptr<ObjectPoolBase> > pools;
+
+    template<typename T>
+    ObjectPool<T> &pool() {
+      auto index = ObjectPoolBase::typeIndex<T>();
+      if (index >= pools.size()) pools.resize(index + 1);
+      if (!pools[index]) pools[index] = std::make_unique<ObjectPool<T>>();
+      return static_cast<ObjectPool<T>&>(*pools[index]);
+    }
 };
 
 #endif // _PPGSO_SCENE_H
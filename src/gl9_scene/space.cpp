@@ -20,23 +20,14 @@ bool Space::update(Scene &scene, float dt) {
 }
 
 void Space::render(Scene &scene) {
-  // Disable writing to the depth buffer so we render a "background"
-  glDepthMask(GL_FALSE);
-
-  // NOTE: this object does not use camera, just renders the entire quad as is
-  shader->use();
+  // NOTE: this object does not use camera, the background pass renders the entire quad as is
+  // without writing to the depth buffer
+  scene.renderQueue.submit(RenderQueue::BACKGROUND_PASS, *this, *shader, *texture, *mesh);
+}
 
+void Space::prepareDraw(ppgso::Shader &shader) {
   // Pass UV mapping offset to the shader
-  shader->setUniform("TextureOffset", textureOffset);
-
-  // Render mesh, not using any projections, we just render in 2D
-  shader->setUniform("ModelMatrix", modelMatrix);
-  shader->setUniform("ViewMatrix", glm::mat4{1.0f});
-  shader->setUniform("ProjectionMatrix", glm::mat4{1.0f});
-  shader->setUniform("Texture", *texture);
-  mesh->render();
-
-  glDepthMask(GL_TRUE);
+  shader.setUniform("TextureOffset", textureOffset);
 }
 
 // shared resources
@@ -37,6 +37,12 @@ public:
    * @param scene Scene to render in
    */
   void render(Scene &scene) override;
+
+  /*!
+   * Set texture offset of the background
+   * @param shader Program the background is drawn with
+   */
+  void prepareDraw(ppgso::Shader &shader) override;
 };
 
 #endif //PPGSO_SPACE_H
@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+
+#include <glm/gtc/random.hpp>
+#include <ppgso/timing.h>
+
+#include "spatial_hash.h"
+#include "object.h"
+
+SpatialHash::SpatialHash(float margin) : margin{margin} {}
+
+glm::ivec3 SpatialHash::cellOf(const glm::vec3 &position) const {
+  return glm::ivec3(glm::floor(position / cellSize));
+}
+
+uint32_t SpatialHash::bucket(const glm::ivec3 &cell) const {
+  // Large primes spread neighbouring cells over the table
+  return ((uint32_t) cell.x * 73856093u ^ (uint32_t) cell.y * 19349663u ^ (uint32_t) cell.z * 83492791u) & tableMask;
+}
+
+void SpatialHash::clear() {
+  entries.clear();
+  maxRadius = 0.0f;
+  tagged = 0;
+}
+
+void SpatialHash::insert(Object &object) {
+  auto radius = glm::max(glm::abs(object.scale.x), glm::max(glm::abs(object.scale.y), glm::abs(object.scale.z)));
+  entries.push_back({object.position, radius, object.tags, &object});
+  if (!object.tags) return;
+  maxRadius = std::max(maxRadius, radius);
+  tagged++;
+}
+
+void SpatialHash::build() {
+  // A query sphere of the largest size touches at most two cells per axis
+  cellSize = std::max(2.0f * maxRadius + margin, 1.0f);
+
+  // Power of two table with about twice as many buckets as objects
+  uint32_t tableSize = 16;
+  while (tableSize < 2 * tagged) tableSize *= 2;
+  tableMask = tableSize - 1;
+
+  // Counting sort of the tagged entries by bucket
+  cellStart.assign(tableSize + 1, 0);
+  bucketOf.resize(entries.size());
+  for (size_t i = 0; i < entries.size(); i++) {
+    if (!entries[i].tags) continue;
+    bucketOf[i] = bucket(cellOf(entries[i].position));
+    cellStart[bucketOf[i] + 1]++;
+  }
+  for (uint32_t b = 0; b < tableSize; b++)
+    cellStart[b + 1] += cellStart[b];
+
+  // Bucket starts are advanced while filling and end up one bucket ahead, then shifted back
+  cellEntries.resize(tagged);
+  for (size_t i = 0; i < entries.size(); i++)
+    if (entries[i].tags) cellEntries[cellStart[bucketOf[i]]++] = (uint32_t) i;
+  for (uint32_t b = tableSize; b > 0; b--)
+    cellStart[b] = cellStart[b - 1];
+  cellStart[0] = 0;
+}
+
+void SpatialHash::remove(size_t entry) {
+  if (entry < entries.size()) entries[entry].tags = 0;
+}
+
+void SpatialHash::gather(const glm::vec3 &center, float radius, uint32_t mask) const {
+  found.clear();
+  if (entries.empty()) return;
+
+  auto reach = radius + maxRadius + margin;
+  auto first = cellOf(center - reach);
+  auto last = cellOf(center + reach);
+
+  auto test = [&](uint32_t i) {
+    auto &entry = entries[i];
+    if (!(entry.tags & mask)) return;
+    auto distance = radius + entry.radius + margin;
+    auto offset = entry.position - center;
+    if (glm::dot(offset, offset) < distance * distance) found.push_back(i);
+  };
+
+  // Very large queries are cheaper as a plain scan
+  auto span = glm::vec3(last - first + 1);
+  if (span.x * span.y * span.z > (float) cellEntries.size()) {
+    for (uint32_t i = 0; i < entries.size(); i++) test(i);
+    return;
+  }
+
+  for (int z = first.z; z <= last.z; z++)
+    for (int y = first.y; y <= last.y; y++)
+      for (int x = first.x; x <= last.x; x++) {
+        auto b = bucket({x, y, z});
+        for (auto c = cellStart[b]; c < cellStart[b + 1]; c++) test(cellEntries[c]);
+      }
+
+  // Different cells can share a bucket, scene order keeps results independent of the hashing
+  std::sort(found.begin(), found.end());
+  found.erase(std::unique(found.begin(), found.end()), found.end());
+}
+
+namespace {
+  // Stand-ins for asteroids and projectiles without GPU resources
+  class BenchAsteroid final : public Object {
+  public:
+    BenchAsteroid() { tags = ASTEROID_TAG; }
+    bool update(Scene &scene, float dt) override { return true; }
+    void render(Scene &scene) override {}
+  };
+
+  class BenchProjectile final : public Object {
+  public:
+    BenchProjectile() { tags = PROJECTILE_TAG; }
+    bool update(Scene &scene, float dt) override { return true; }
+    void render(Scene &scene) override {}
+  };
+}
+
+void SpatialHash::benchmark(int count, int frames) {
+  // Same density as the game: the generator area holds about 50 asteroids
+  std::vector<std::unique_ptr<Object>> objects;
+  auto extent = 20.0f * std::sqrt(count / 50.0f);
+  for (int i = 0; i < count + count / 10; i++) {
+    std::unique_ptr<Object> object;
+    if (i < count) object = std::make_unique<BenchAsteroid>();
+    else object = std::make_unique<BenchProjectile>();
+    object->position = {glm::linearRand(-extent, extent), glm::linearRand(-extent, extent), 0.0f};
+    object->scale *= i < count ? glm::linearRand(0.25f, 3.0f) : 1.0f;
+    objects.push_back(move(object));
+  }
+
+  // First object every asteroid collides with, as in Asteroid::update
+  std::vector<Object*> loopHits, hashHits;
+
+  auto loop = ppgso::averageTime(frames, [&](int) {
+    loopHits.clear();
+    for (auto &self : objects) {
+      if (!dynamic_cast<BenchAsteroid*>(self.get())) continue;
+      Object *hit = nullptr;
+      for (auto &obj : objects) {
+        if (obj.get() == self.get()) continue;
+        auto asteroid = dynamic_cast<BenchAsteroid*>(obj.get());
+        auto projectile = dynamic_cast<BenchProjectile*>(obj.get());
+        if (!asteroid && !projectile) continue;
+        if (distance(self->position, obj->position) < (obj->scale.y + self->scale.y) * 0.7f) {
+          hit = obj.get();
+          break;
+        }
+      }
+      loopHits.push_back(hit);
+    }
+  });
+
+  SpatialHash hash;
+  auto hashed = ppgso::averageTime(frames, [&](int) {
+    hashHits.clear();
+    hash.clear();
+    for (auto &object : objects) hash.insert(*object);
+    hash.build();
+    for (auto &self : objects) {
+      if (!(self->tags & Object::ASTEROID_TAG)) continue;
+      Object *hit = nullptr;
+      hash.query(self->position, self->scale.y * 0.7f, Object::ASTEROID_TAG | Object::PROJECTILE_TAG, [&](Object &obj) {
+        if (&obj == self.get()) return true;
+        if (distance(self->position, obj.position) >= (obj.scale.y + self->scale.y) * 0.7f) return true;
+        hit = &obj;
+        return false;
+      });
+      hashHits.push_back(hit);
+    }
+  });
+
+  size_t collisions = std::count_if(loopHits.begin(), loopHits.end(), [](Object *hit) { return hit != nullptr; });
+  std::cout << "Collision broadphase, " << count << " asteroids and " << count / 10 << " projectiles:" << std::endl;
+  std::cout << "  loop with dynamic_cast: " << loop << " ms per frame" << std::endl;
+  std::cout << "  spatial hash:           " << hashed << " ms per frame (build included)" << std::endl;
+  std::cout << "  colliding asteroids:    " << collisions << (loopHits == hashHits ? ", same" : ", DIFFERENT")
+            << " first hits" << std::endl;
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class Object;
+
+/*!
+ * Broadphase for collisions between scene objects, rebuilt once per frame
+ *
+ * Every object is stored as a bounding sphere (position and largest scale component) in a hashed
+ * uniform grid. The cell size follows the largest sphere, so a query only visits the few cells
+ * around it. Cells are kept in flat arrays filled by a counting sort, a build does not allocate
+ * once the arrays have grown.
+ *
+ * Queries return candidates only, callers still do their own exact test against the live object.
+ * Positions are taken at build time, objects that moved since then are still found as long as
+ * they did not move further than the margin.
+ */
+class SpatialHash {
+public:
+  /*!
+   * Create an empty broadphase
+   * @param margin - Distance objects may move between build and query
+   */
+  explicit SpatialHash(float margin = 2.0f);
+
+  /*!
+   * Drop all entries before inserting the objects of a new frame
+   */
+  void clear();
+
+  /*!
+   * Add an object at its current position, entries are numbered in insertion order
+   * Objects without tags are kept as entries but never returned by queries.
+   * @param object - Object to add
+   */
+  void insert(Object &object);
+
+  /*!
+   * Sort the inserted objects into cells, needed before queries
+   */
+  void build();
+
+  /*!
+   * Stop returning an entry, used when its object is deleted during the frame
+   * @param entry - Insertion index of the object, larger values are ignored
+   */
+  void remove(size_t entry);
+
+  /*!
+   * Visit objects whose bounding sphere may overlap a sphere, in insertion order
+   * The visitor must not query the hash again.
+   *
+   * @param center - Center of the query sphere
+   * @param radius - Radius of the query sphere
+   * @param mask - Only objects sharing a tag with the mask are visited
+   * @param visit - Called with Object&, returns false to stop the query
+   */
+  template<typename Visitor>
+  void query(const glm::vec3 &center, float radius, uint32_t mask, Visitor visit) const {
+    gather(center, radius, mask);
+    for (auto entry : found)
+      if (!visit(*entries[entry].object)) return;
+  }
+
+  /*!
+   * Number of entries of the last build
+   */
+  size_t size() const { return entries.size(); }
+
+  /*!
+   * Compare the per object loop over the whole scene with dynamic_cast against the hash
+   * Prints the time of one collision frame for both and checks they find the same pairs.
+   * @param count - Number of asteroids
+   * @param frames - Frames to average
+   */
+  static void benchmark(int count, int frames = 3);
+
+private:
+  struct Entry {
+    glm::vec3 position;
+    float radius;
+    uint32_t tags;
+    Object *object;
+  };
+
+  float margin;
+  float cellSize = 1.0f;
+  float maxRadius = 0.0f;
+  uint32_t tableMask = 0;
+
+  std::vector<Entry> entries;
+  size_t tagged = 0;
+
+  // Entries of bucket b are cellEntries[cellStart[b], cellStart[b + 1])
+  std::vector<uint32_t> cellStart;
+  std::vector<uint32_t> cellEntries;
+  std::vector<uint32_t> bucketOf;
+
+  // Result of the last gather, sorted entry indices
+  mutable std::vector<uint32_t> found;
+
+  glm::ivec3 cellOf(const glm::vec3 &position) const;
+  uint32_t bucket(const glm::ivec3 &cell) const;
+  void gather(const glm::vec3 &center, float radius, uint32_t mask) const;
+};
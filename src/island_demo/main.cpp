@@ -4,6 +4,7 @@
 #include <ppgso/ppgso.h>
 
 #include "scene.h"
+#include "particles/particle_system.h"
 
 const unsigned int WIDTH = 1280;
 const unsigned int HEIGHT = 720;
@@ -17,6 +18,15 @@ const unsigned int HEIGHT = 720;
  *   1 - Zapnut/Vypnut smerove svetlo (slnko)
  *   2 - Zapnut/Vypnut bodove svetlo
  *   3 - Zapnut/Vypnut reflektor
+ *   S - Vypisat pocty GL volani shaderov za posledny frame
+ *   L - Zapnut/Vypnut nocny ostrov s faklami
+ *   K - Vypisat stav svetiel (clustre, zapnute svetla)
+ *   B - Benchmarky: TransformStore, castice, fyzika
+ *   F - Zapnut/Vypnut frustum culling
+ *   V - Vypisat stav frustum cullingu
+ *   P - Zhodit 50 kamenov riadenych fyzikou
+ *   O - Vypisat stav fyziky
+ *   C - Spustit/Zastavit animaciu kamery
  */
 class IslandDemoWindow : public ppgso::Window {
 private:
@@ -24,6 +34,9 @@ private:
     bool paused;
     float lastTime;
 
+    // GL volania shaderov za posledny frame
+    ppgso::Shader::Stats frameStats;
+
 public:
     IslandDemoWindow() : Window{"Island Demo", WIDTH, HEIGHT}, paused(false), lastTime(0.0f) {
         // OpenGL nastavenia
@@ -47,6 +60,14 @@ public:
         std::cout << "  SPACE - Pause/Resume" << std::endl;
         std::cout << "  1/2/3 - Toggle Lights" << std::endl;
         std::cout << "  C     - Toggle Camera Animation" << std::endl;
+        std::cout << "  S     - Print Shader GL Call Stats" << std::endl;
+        std::cout << "  L     - Toggle Night Torches (256 lights)" << std::endl;
+        std::cout << "  K     - Print Light Cluster Stats" << std::endl;
+        std::cout << "  B     - Benchmark Transforms, Particles and Physics" << std::endl;
+        std::cout << "  F     - Toggle Frustum Culling" << std::endl;
+        std::cout << "  V     - Print Frustum Culling Stats" << std::endl;
+        std::cout << "  P     - Drop 50 Physics Rocks" << std::endl;
+        std::cout << "  O     - Print Physics Stats" << std::endl;
         std::cout << "==================================" << std::endl;
     }
 
@@ -66,6 +87,19 @@ public:
 
         // Render sceny
         scene->render();
+
+        frameStats = ppgso::Shader::getStats();
+        ppgso::Shader::resetStats();
+    }
+
+    void printShaderStats() const {
+        // Pocitadla z ppgso::Shader za posledny frame
+        std::cout << "Shader GL calls (last frame):" << std::endl;
+        std::cout << "  uniform sets:          " << frameStats.namedSets + frameStats.handleSets
+                  << " (" << frameStats.namedSets << " by name, " << frameStats.handleSets << " via handles)" << std::endl;
+        std::cout << "  use() calls:           " << frameStats.useCalls << std::endl;
+        std::cout << "  glUseProgram:          " << frameStats.programSwitches << std::endl;
+        std::cout << "  glGetUniformLocation:  " << frameStats.locationQueries << std::endl;
     }
 
     void onKey(int key, int scanCode, int action, int mods) override {
@@ -116,6 +150,44 @@ public:
                 }
                 break;
 
+            case GLFW_KEY_S:
+                printShaderStats();
+                break;
+
+            case GLFW_KEY_L:
+                // Nocny ostrov s faklami
+                scene->setTorches(!scene->isTorchesEnabled());
+                break;
+
+            case GLFW_KEY_K:
+                scene->printLightStats();
+                break;
+
+            case GLFW_KEY_B:
+                // Flat TransformStore proti stromu uzlov na halde
+                ppgso::TransformStore::benchmark(10000);
+                ppgso::TransformStore::benchmark(100000);
+                // SoA castice, seriovo proti paralelne
+                ppgso::ParticleSystem::benchmark(1000000);
+                ppgso::PhysicsWorld::benchmark(10000);
+                break;
+
+            case GLFW_KEY_F:
+                scene->setFrustumCulling(!scene->isFrustumCullingEnabled());
+                break;
+
+            case GLFW_KEY_V:
+                scene->printCullingStats();
+                break;
+
+            case GLFW_KEY_P:
+                scene->dropRocks(50);
+                break;
+
+            case GLFW_KEY_O:
+                scene->printPhysicsStats();
+                break;
+
             case GLFW_KEY_C:
                 if (scene->isCameraAnimationActive()) {
                     scene->stopCameraAnimation();
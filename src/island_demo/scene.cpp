@@ -1,6 +1,13 @@
 #include "scene.h"
 #include "objects/test_cube.h"
 #include "objects/object.h"
+#include "objects/rock.h"
+#include "particles/dust_particles.h"
+#include "particles/falling_leaves.h"
+#include "particles/water_spray.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
 
 
 namespace ppgso {
@@ -11,11 +18,13 @@ namespace ppgso {
     {
         // Vytvor root uzol grafu sceny
         rootNode = std::make_shared<SceneNode>("Root");
+        rootNode->setListener(&renderList);
         cameraPath = std::make_unique<CameraPath>();  // Novy
     }
 
     Scene::~Scene() {
-        // Cleanup
+        // Graf moze prezit scenu (getRootNode), render list uz nie
+        rootNode->setListener(nullptr);
     }
 
     void Scene::initialize() {
@@ -34,10 +43,9 @@ namespace ppgso {
         // Setup sceny
         setupScene();
 
-        // DOLEZITE: Najprv vytvor svetla
+        // Svetla idu do spolocneho light bufferu, objekty ho len pripoja
+        lightBuffer = std::make_unique<LightBuffer>();
         setupLights();
-
-        // Potom objekty (potrebuju referenciu na svetla)
         setupObjects();
 
         std::cout << "Scene initialized with " << lights.size() << " lights" << std::endl;
@@ -54,8 +62,26 @@ namespace ppgso {
             camera.update(deltaTime);
         }
 
+        // Fakle blikaju, kazda s vlastnou fazou
+        if (isTorchesEnabled()) {
+            for (size_t i = 0; i < torches.size(); i++) {
+                float phase = torchPhases[i];
+                torches[i]->intensity = 1.6f + 0.25f * std::sin(time * 11.0f + phase)
+                                             + 0.15f * std::sin(time * 23.0f + phase * 1.7f);
+            }
+        }
+
+        // Fyzika bezi v pevnych krokoch, uzly dostanu polohu medzi poslednymi dvoma
+        physics.update(deltaTime);
+        for (const auto& physicsNode : physicsNodes) {
+            physicsNode.node->getTransform().setPosition(physics.getRenderPosition(physicsNode.body));
+        }
+
         // Update grafu sceny (rekurzivne)
         rootNode->updateRecursive(deltaTime);
+
+        // Svetove matice dirty uzlov sa prepocitaju jednym prechodom storu, rendering cita len cache
+        rootNode->getTransform().updateWorldMatrices();
     }
 
     void Scene::render() {
@@ -66,23 +92,17 @@ namespace ppgso {
         glEnable(GL_DEPTH_TEST);
         glDepthFunc(GL_LEQUAL);
 
-        // Render vsetky objekty s kamerou
-        renderNodeWithCamera(rootNode, camera);
-    }
-
-    void Scene::renderNodeWithCamera(std::shared_ptr<SceneNode> node, const Camera& camera) {
-        if (!node || !node->isVisible()) return;
+        // Svetla sa nahraju raz za frame pre vsetky objekty
+        lightBuffer->update(lights, camera.getViewMatrix(), camera.getProjectionMatrix());
+        lightBuffer->bind();
 
-        // Ak je to Object, renderuj ho s kamerou
-        auto obj = std::dynamic_pointer_cast<Object>(node);
-        if (obj) {
-            obj->renderWithCamera(camera);
+        // Obalky podstromov proti frustu kamery, orezane objekty render list preskoci
+        if (renderList.isFrustumCullingEnabled()) {
+            TransformStore::getDefault().cull(camera.getFrustum());
         }
 
-        // Renderuj deti
-        for (auto& child : node->getChildren()) {
-            renderNodeWithCamera(child, camera);
-        }
+        // Render vsetky viditelne objekty s kamerou
+        renderList.render(camera);
     }
 
     void Scene::resize(int width, int height) {
@@ -173,17 +193,165 @@ namespace ppgso {
         auto cube = std::make_shared<TestCube>();
         cube->getTransform().setPosition(glm::vec3(0.0f, 0.0f, 0.0f));
         cube->getTransform().setScale(2.0f);
-        cube->setLights(lights);
         addNode(cube);
 
         auto animatedCube = std::make_shared<AnimatedCube>();
         animatedCube->getTransform().setScale(1.5f);
-        animatedCube->setLights(lights);
         animatedCube->enableBobbing(true);
         animatedCube->setBobbingAmplitude(0.5f);
         addNode(animatedCube);
 
-        std::cout << "Created test objects (static + animated)" << std::endl;
+        // Kamene na pobrezi, vsetky jednym instanced draw
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        const int rockCount = 400;
+        for (int i = 0; i < rockCount; i++) {
+            float angle = glm::two_pi<float>() * unit(rng);
+            float radius = 8.0f + 30.0f * unit(rng);
+
+            auto rock = std::make_shared<Rock>();
+            rock->getTransform().setPosition(glm::vec3(radius * std::cos(angle), -1.0f, radius * std::sin(angle)));
+            rock->getTransform().setRotation(glm::vec3(unit(rng), unit(rng), unit(rng)) * glm::two_pi<float>());
+            glm::vec3 scale(0.4f + 0.8f * unit(rng), 0.3f + 0.4f * unit(rng), 0.4f + 0.8f * unit(rng));
+            rock->getTransform().setScale(scale);
+            addNode(rock);
+
+            // Pre fyziku staticka gula (mesh kamena ma polomer asi 0.5)
+            physics.bodies.create(rock->getTransform().getPosition(), 0.5f * std::max(scale.x, scale.z), 0.0f);
+        }
+
+        // Zem pod kamenmi a kocka v strede
+        physics.collisions.addCollider(std::make_shared<GroundPlane>(-1.0f));
+        physics.bodies.create(glm::vec3(0.0f), 1.5f, 0.0f);
+
+        // Castice: kazdy system je jeden draw v priehladnom prechode
+        addNode(std::make_shared<DustParticles>());
+
+        auto leaves = std::make_shared<FallingLeaves>();
+        leaves->getTransform().setPosition(glm::vec3(-6.0f, 8.0f, -4.0f));
+        addNode(leaves);
+
+        auto spray = std::make_shared<WaterSpray>();
+        spray->getTransform().setPosition(glm::vec3(12.0f, -1.0f, 6.0f));
+        addNode(spray);
+
+        std::cout << "Created test objects (static + animated), " << rockCount << " rocks and 3 particle systems" << std::endl;
+    }
+
+    void Scene::dropRocks(int count) {
+        std::mt19937 rng(1000 + droppedRocks);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        for (int i = 0; i < count; i++) {
+            float angle = glm::two_pi<float>() * unit(rng);
+            float radius = 12.0f * std::sqrt(unit(rng));
+            glm::vec3 position(radius * std::cos(angle), 10.0f + 10.0f * unit(rng), radius * std::sin(angle));
+            float size = 0.5f + 0.7f * unit(rng);
+
+            auto rock = std::make_shared<Rock>();
+            rock->getTransform().setPosition(position);
+            rock->getTransform().setScale(size);
+            addNode(rock);
+
+            auto body = physics.bodies.create(position, 0.5f * size, size * size * size);
+            physics.bodies.setRestitution(body, 0.3f);
+            physics.bodies.setVelocity(body, glm::vec3(unit(rng) - 0.5f, -2.0f, unit(rng) - 0.5f));
+            physicsNodes.push_back({body, rock});
+        }
+        droppedRocks += count;
+        std::cout << "Dropped " << count << " rocks (" << droppedRocks << " total)" << std::endl;
+    }
+
+    void Scene::printPhysicsStats() const {
+        const auto& stats = physics.getStats();
+        std::cout << "Physics (last frame, " << physics.getFixedDelta() * 1000.0f << " ms step):" << std::endl;
+        std::cout << "  steps:                 " << stats.steps << " (last " << stats.stepMs << " ms)" << std::endl;
+        std::cout << "  bodies:                " << stats.bodies << " (" << stats.awake << " awake)" << std::endl;
+        std::cout << "  contacts:              " << stats.contacts << " (" << stats.pairTests << " pair tests)" << std::endl;
+        std::cout << "  islands:               " << stats.islands << " (largest " << stats.largestIsland << ")" << std::endl;
+    }
+
+    void Scene::setupTorches() {
+        // Sustredne kruhy fakli okolo stredu sceny, hustejsie blizko objektov
+        const int rings = 8;
+        const int perRing = 32;
+        for (int r = 0; r < rings; r++) {
+            float radius = 4.0f + r * 4.5f;
+            for (int i = 0; i < perRing; i++) {
+                float angle = glm::two_pi<float>() * (i + 0.5f * (r % 2)) / perRing;
+                glm::vec3 position(radius * std::cos(angle), 1.5f, radius * std::sin(angle));
+
+                auto torch = std::make_shared<PointLight>(position);
+                torch->setColor(glm::vec3(1.0f, 0.55f, 0.2f));
+                torch->ambient = glm::vec3(0.0f);
+                torch->setRange(6.0f);
+                torches.push_back(torch);
+                torchPhases.push_back(angle * 7.0f + r * 1.3f);
+            }
+        }
+    }
+
+    void Scene::setTorches(bool enabled) {
+        if (enabled == isTorchesEnabled()) return;
+        if (torches.empty()) setupTorches();
+
+        if (enabled) {
+            lights.insert(lights.end(), torches.begin(), torches.end());
+        } else {
+            lights.erase(std::remove_if(lights.begin(), lights.end(), [this](const std::shared_ptr<Light>& light) {
+                return std::find(torches.begin(), torches.end(), light) != torches.end();
+            }), lights.end());
+        }
+
+        // Slnko (prve svetlo) sa v noci stlmi
+        if (!lights.empty()) {
+            if (enabled) {
+                sunIntensity = lights[0]->intensity;
+                lights[0]->intensity = 0.05f;
+            } else {
+                lights[0]->intensity = sunIntensity;
+            }
+        }
+
+        std::cout << "Torches " << (enabled ? "ON" : "OFF") << ", " << lights.size() << " lights" << std::endl;
+    }
+
+    bool Scene::isTorchesEnabled() const {
+        return !torches.empty() && std::find(lights.begin(), lights.end(), torches.front()) != lights.end();
+    }
+
+    void Scene::printLightStats() const {
+        const auto& clusters = lightBuffer->getClusters();
+        const auto& stats = clusters.getStats();
+        std::cout << "Lights (last frame):" << std::endl;
+        std::cout << "  packed:                " << lightBuffer->getLightCount()
+                  << " (" << lightBuffer->getGlobalLightCount() << " directional)" << std::endl;
+        std::cout << "  in view:               " << stats.visibleLights << " / " << stats.lights << std::endl;
+        std::cout << "  clusters:              " << clusters.getTilesX() << "x" << clusters.getTilesY()
+                  << "x" << clusters.getSlices() << ", " << stats.occupiedClusters << " occupied" << std::endl;
+        std::cout << "  max lights / cluster:  " << stats.maxPerCluster << std::endl;
+        std::cout << "  index list:            " << stats.assignments << std::endl;
+    }
+
+    void Scene::setFrustumCulling(bool enabled) {
+        renderList.setFrustumCulling(enabled);
+        std::cout << "Frustum culling: " << (enabled ? "ON" : "OFF") << std::endl;
+    }
+
+    bool Scene::isFrustumCullingEnabled() const {
+        return renderList.isFrustumCullingEnabled();
+    }
+
+    void Scene::printCullingStats() const {
+        const auto& stats = TransformStore::getDefault().getCullStats();
+        std::cout << "Frustum culling (last frame, " << (isFrustumCullingEnabled() ? "on" : "off") << "):" << std::endl;
+        std::cout << "  bounded nodes:         " << stats.bounded << std::endl;
+        std::cout << "  bounds tested:         " << stats.tested << std::endl;
+        std::cout << "  nodes culled:          " << stats.culled
+                  << " (" << stats.skipped << " with a whole subtree)" << std::endl;
+        std::cout << "  objects drawn:         " << renderList.getDrawnCount()
+                  << " (" << renderList.getCulledCount() << " skipped)" << std::endl;
+        std::cout << "  draw calls:            " << renderList.getDrawCallCount()
+                  << " (" << renderList.getInstancedCount() << " objects instanced)" << std::endl;
     }
 
     // Nová metoda na setup camera path:
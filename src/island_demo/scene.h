@@ -11,8 +11,11 @@
 #include "lighting/directional_light.h"
 #include "lighting/point_light.h"
 #include "lighting/spot_light.h"
+#include "lighting/light_buffer.h"
 #include "camera/camera_path.h"
 #include "objects/animated_cube.h"
+#include "objects/render_list.h"
+#include "physics/physics_world.h"
 
 namespace ppgso {
 
@@ -54,6 +57,22 @@ namespace ppgso {
         // Cas
         float getTime() const;
 
+        // Nocny rezim: slnko stlmene a okolo objektov stovky fakli (bodove svetla s kratkym dosahom)
+        void setTorches(bool enabled);
+        bool isTorchesEnabled() const;
+
+        // Pocty svetiel a obsadenost clustrov z posledneho frame
+        void printLightStats() const;
+
+        // Frustum culling podla obalok podstromov
+        void setFrustumCulling(bool enabled);
+        bool isFrustumCullingEnabled() const;
+        void printCullingStats() const;
+
+        // Zhodi count kamenov riadenych fyzikou (poradie a polohy zavisia len od poctu uz zhodenych)
+        void dropRocks(int count);
+        void printPhysicsStats() const;
+
         void startCameraAnimation();
         void stopCameraAnimation();
         bool isCameraAnimationActive() const;
@@ -62,11 +81,25 @@ namespace ppgso {
         // Kamera
         Camera camera;
 
-        // Graf sceny
+        // Graf sceny a ploche pole jeho vykreslovanych objektov
         std::shared_ptr<SceneNode> rootNode;
+        RenderList renderList;
 
         // Svetla
         std::vector<std::shared_ptr<Light>> lights;
+        std::unique_ptr<LightBuffer> lightBuffer;
+        std::vector<std::shared_ptr<PointLight>> torches;
+        std::vector<float> torchPhases;
+        float sunIntensity = 1.0f;
+
+        // Fyzika s pevnym krokom, uzly telies sa kazdy frame posunu na interpolovanu polohu
+        PhysicsWorld physics;
+        struct PhysicsNode {
+            RigidBodyStore::Handle body;
+            std::shared_ptr<SceneNode> node;
+        };
+        std::vector<PhysicsNode> physicsNodes;
+        int droppedRocks = 0;
 
         std::unique_ptr<CameraPath> cameraPath;
         bool useCameraAnimation;
@@ -83,9 +116,7 @@ namespace ppgso {
         void setupLights();
         void setupObjects();
         void setupCameraAnimation();
-
-        // Helper pre rendering s kamerou
-        void renderNodeWithCamera(std::shared_ptr<SceneNode> node, const Camera& camera);
+        void setupTorches();
     };
 
 } // namespace ppgso
@@ -26,18 +26,9 @@ namespace ppgso {
         return direction;
     }
 
-    void DirectionalLight::setupShaderUniforms(ppgso::Shader& shader, int lightIndex) {
-        if (!enabled) {
-            shader.setUniform(getUniformName(lightIndex, "enabled"), 0);
-            return;
-        }
-
-        shader.setUniform(getUniformName(lightIndex, "type"), 0);
-        shader.setUniform(getUniformName(lightIndex, "direction"), direction);
-        shader.setUniform(getUniformName(lightIndex, "ambient"), ambient * intensity);
-        shader.setUniform(getUniformName(lightIndex, "diffuse"), diffuse * intensity);
-        shader.setUniform(getUniformName(lightIndex, "specular"), specular * intensity);
-        shader.setUniform(getUniformName(lightIndex, "enabled"), 1);
+    void DirectionalLight::pack(GpuLight& light) const {
+        packCommon(light);
+        light.direction = direction;
     }
 
 } // namespace ppgso
\ No newline at end of file
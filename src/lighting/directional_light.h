@@ -13,7 +13,7 @@ namespace ppgso {
         void setDirection(const glm::vec3& direction);
         glm::vec3 getDirection() const;
 
-        void setupShaderUniforms(ppgso::Shader& shader, int lightIndex) override;
+        void pack(GpuLight& light) const override;
 
     private:
         glm::vec3 direction;
@@ -19,14 +19,22 @@ namespace ppgso {
         return type;
     }
 
+    bool Light::getBounds(glm::vec3& center, float& radius) const {
+        return false;
+    }
+
     void Light::setColor(const glm::vec3& color) {
         ambient = color * 0.2f;
         diffuse = color;
         specular = color;
     }
 
-    std::string Light::getUniformName(int lightIndex, const std::string& property) const {
-        return "light" + std::to_string(lightIndex) + "_" + property;
+    void Light::packCommon(GpuLight& light) const {
+        light = GpuLight();
+        light.type = (int)type;
+        light.ambient = ambient * intensity;
+        light.diffuse = diffuse * intensity;
+        light.specular = specular * intensity;
     }
 
 } // namespace ppgso
\ No newline at end of file
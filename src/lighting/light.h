@@ -13,6 +13,26 @@ namespace ppgso {
         SPOT
     };
 
+    /**
+     * GpuLight - std140 zrkadlo struct Light v phong_frag.glsl (96 bajtov)
+     * vec3 a nasledujuci skalar zdielaju jeden 16 bajtovy slot
+     */
+    struct GpuLight {
+        glm::vec3 position;
+        int type;
+        glm::vec3 direction;
+        float range;
+        glm::vec3 ambient;
+        float constantAttenuation;
+        glm::vec3 diffuse;
+        float linearAttenuation;
+        glm::vec3 specular;
+        float quadraticAttenuation;
+        float innerCutoff;
+        float outerCutoff;
+        float padding1[2];
+    };
+
     class Light {
     public:
         Light(LightType type);
@@ -25,13 +45,20 @@ namespace ppgso {
         bool enabled;
 
         LightType getType() const;
-        virtual void setupShaderUniforms(ppgso::Shader& shader, int lightIndex) = 0;
+        // Zapise parametre svetla do zaznamu light bufferu
+        virtual void pack(GpuLight& light) const = 0;
+
+        // Gula, mimo ktorej svetlo nic neosvetli (pre binovanie do clusterov)
+        // Smerove svetlo ziadnu nema a vrati false
+        virtual bool getBounds(glm::vec3& center, float& radius) const;
 
         void setColor(const glm::vec3& color);
 
     protected:
         LightType type;
-        std::string getUniformName(int lightIndex, const std::string& property) const;
+
+        // Spolocne farby (uz vynasobene intenzitou) a typ
+        void packCommon(GpuLight& light) const;
     };
 
 } // namespace ppgso
@@ -0,0 +1,154 @@
+#include "light_buffer.h"
+#include <cstddef>
+#include <iostream>
+
+namespace ppgso {
+
+    static_assert(sizeof(GpuLight) == 96, "GpuLight musi sediet so std140 layoutom struct Light");
+
+    // Buffer s texturou, ktora ho cita ako texture buffer daneho formatu
+    static void createTextureBuffer(GLuint& buffer, GLuint& texture, GLenum format) {
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+        glBufferData(GL_TEXTURE_BUFFER, 16, nullptr, GL_STREAM_DRAW);
+
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_BUFFER, texture);
+        glTexBuffer(GL_TEXTURE_BUFFER, format, buffer);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+    }
+
+    // Novy obsah bufferu (stary sa zahodi, driver nemusi cakat na predchadzajuci frame)
+    static void uploadTextureBuffer(GLuint buffer, const void* data, size_t bytes) {
+        glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+        if (bytes == 0) {
+            glBufferData(GL_TEXTURE_BUFFER, 16, nullptr, GL_STREAM_DRAW);
+        } else {
+            glBufferData(GL_TEXTURE_BUFFER, bytes, data, GL_STREAM_DRAW);
+        }
+    }
+
+    LightBuffer::LightBuffer() {
+        static_assert(offsetof(Block, clusterGrid) == 64 && sizeof(Block) == 112,
+                      "Block musi sediet so std140 layoutom bloku Lights");
+
+        glGenBuffers(1, &ubo);
+        glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+
+        // Prazdny blok, kym sa nenahraju svetla
+        Block empty = {};
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(Block), &empty, GL_DYNAMIC_DRAW);
+
+        createTextureBuffer(lightDataBuffer, lightDataTexture, GL_RGBA32F);
+        createTextureBuffer(rangeBuffer, rangeTexture, GL_RG32UI);
+        createTextureBuffer(indexBuffer, indexTexture, GL_R32UI);
+
+        packed.reserve(MAX_LIGHTS);
+    }
+
+    LightBuffer::~LightBuffer() {
+        glDeleteBuffers(1, &ubo);
+        glDeleteTextures(1, &lightDataTexture);
+        glDeleteTextures(1, &rangeTexture);
+        glDeleteTextures(1, &indexTexture);
+        glDeleteBuffers(1, &lightDataBuffer);
+        glDeleteBuffers(1, &rangeBuffer);
+        glDeleteBuffers(1, &indexBuffer);
+    }
+
+    void LightBuffer::update(const std::vector<std::shared_ptr<Light>>& lights,
+                             const glm::mat4& view, const glm::mat4& projection) {
+        packed.clear();
+        spheres.clear();
+
+        // Najprv smerove svetla (bez dosahu), tie sa pocitaju v kazdom fragmente
+        glm::vec3 center;
+        float radius;
+        for (auto& light : lights) {
+            if (!light || !light->enabled || light->getBounds(center, radius)) continue;
+            if ((int)packed.size() == MAX_LIGHTS) break;
+
+            packed.emplace_back();
+            light->pack(packed.back());
+        }
+        globalLightCount = (int)packed.size();
+
+        // Svetla s dosahom idu do clustrov
+        for (auto& light : lights) {
+            if (!light || !light->enabled || !light->getBounds(center, radius)) continue;
+            if ((int)packed.size() == MAX_LIGHTS) break;
+
+            spheres.push_back({center, radius, (uint32_t)packed.size()});
+            packed.emplace_back();
+            light->pack(packed.back());
+        }
+        lightCount = (int)packed.size();
+
+        clusters.setProjection(projection);
+        clusters.build(view, spheres);
+
+#ifndef NDEBUG
+        // Pri zmene poctu svetiel over rychle binovanie proti hrubej sile
+        if (lightCount != validatedLightCount) {
+            validatedLightCount = lightCount;
+            if (!clusters.matchesReference(view, spheres)) {
+                std::cerr << "LightClusters: binning does not match the reference" << std::endl;
+            }
+        }
+#endif
+
+        // Viewport sa cita z GL, aby dlazdice sedeli s gl_FragCoord aj pred prvym resize
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+
+        Block block;
+        block.view = view;
+        block.clusterGrid = glm::ivec4(clusters.getTilesX(), clusters.getTilesY(),
+                                       clusters.getSlices(), globalLightCount);
+        block.clusterDepth = glm::vec4(clusters.getNear(), clusters.getFar(),
+                                       clusters.getSliceScale(), clusters.getSliceBias());
+        block.viewport = glm::vec4(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+        glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Block), &block);
+
+        uploadTextureBuffer(lightDataBuffer, packed.data(), packed.size() * sizeof(GpuLight));
+        uploadTextureBuffer(rangeBuffer, clusters.getRanges().data(),
+                            clusters.getRanges().size() * sizeof(glm::uvec2));
+        uploadTextureBuffer(indexBuffer, clusters.getIndices().data(),
+                            clusters.getIndices().size() * sizeof(uint32_t));
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    }
+
+    void LightBuffer::bind() const {
+        glBindBufferBase(GL_UNIFORM_BUFFER, BINDING, ubo);
+
+        glActiveTexture(GL_TEXTURE0 + LIGHT_DATA_UNIT);
+        glBindTexture(GL_TEXTURE_BUFFER, lightDataTexture);
+        glActiveTexture(GL_TEXTURE0 + CLUSTER_RANGE_UNIT);
+        glBindTexture(GL_TEXTURE_BUFFER, rangeTexture);
+        glActiveTexture(GL_TEXTURE0 + CLUSTER_INDEX_UNIT);
+        glBindTexture(GL_TEXTURE_BUFFER, indexTexture);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    bool LightBuffer::attach(const ppgso::Shader& shader) {
+        shader.setUniform("lightData", LIGHT_DATA_UNIT);
+        shader.setUniform("clusterRanges", CLUSTER_RANGE_UNIT);
+        shader.setUniform("clusterIndices", CLUSTER_INDEX_UNIT);
+        return shader.setUniformBlockBinding("Lights", BINDING);
+    }
+
+    int LightBuffer::getLightCount() const {
+        return lightCount;
+    }
+
+    int LightBuffer::getGlobalLightCount() const {
+        return globalLightCount;
+    }
+
+    const LightClusters& LightBuffer::getClusters() const {
+        return clusters;
+    }
+
+} // namespace ppgso
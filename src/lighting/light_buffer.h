@@ -0,0 +1,82 @@
+#ifndef PPGSO_LIGHT_BUFFER_H
+#define PPGSO_LIGHT_BUFFER_H
+
+#include <memory>
+#include <vector>
+#include <ppgso/ppgso.h>
+
+#include "light.h"
+#include "light_clusters.h"
+
+namespace ppgso {
+
+    /**
+     * LightBuffer - Vsetky svetla sceny pre clustered forward shading
+     *
+     * Raz za frame zabali zapnute svetla do texture bufferu (6 texelov RGBA32F na GpuLight),
+     * svetla s dosahom rozdeli do clustrov (LightClusters) a nahra zoznamy svetiel clustrov
+     * do dalsich dvoch texture bufferov. Smerove svetla su na zaciatku a pocitaju sa vsade.
+     * Parametre mriezky a view matica su v std140 bloku "Lights", ktory zdielaju vsetky
+     * programy - cena na CPU nezavisi od poctu objektov a fragment pocita len svoj cluster.
+     */
+    class LightBuffer {
+    public:
+        // Najviac zabalenych svetiel (6 texelov na svetlo sa zmesti do minimalneho
+        // GL_MAX_TEXTURE_BUFFER_SIZE 65536)
+        static const int MAX_LIGHTS = 4096;
+
+        // Binding point bloku Lights (0 pouziva ocean pre vlny)
+        static const GLuint BINDING = 1;
+
+        // Texturove jednotky texture bufferov (samplery lightData, clusterRanges, clusterIndices)
+        static const int LIGHT_DATA_UNIT = 13;
+        static const int CLUSTER_RANGE_UNIT = 14;
+        static const int CLUSTER_INDEX_UNIT = 15;
+
+        LightBuffer();
+        ~LightBuffer();
+
+        // Zabali zapnute svetla, rozdeli ich do clustrov pre danu kameru a nahra vsetko na GPU
+        void update(const std::vector<std::shared_ptr<Light>>& lights,
+                    const glm::mat4& view, const glm::mat4& projection);
+
+        // Pripoji blok na BINDING a texture buffery na ich jednotky
+        void bind() const;
+
+        // Napoji blok "Lights" a samplery programu, false ak blok nema
+        static bool attach(const ppgso::Shader& shader);
+
+        int getLightCount() const;
+        int getGlobalLightCount() const;
+        const LightClusters& getClusters() const;
+
+    private:
+        // std140 zrkadlo bloku Lights
+        struct Block {
+            glm::mat4 view;
+            glm::ivec4 clusterGrid;    // tilesX, tilesY, slices, pocet smerovych svetiel
+            glm::vec4 clusterDepth;    // near, far, slice scale, slice bias
+            glm::vec4 viewport;        // x, y, sirka, vyska
+        };
+
+        GLuint ubo = 0;
+
+        // Texture buffery: buffer a textura nad nim
+        GLuint lightDataBuffer = 0, lightDataTexture = 0;
+        GLuint rangeBuffer = 0, rangeTexture = 0;
+        GLuint indexBuffer = 0, indexTexture = 0;
+
+        int lightCount = 0;
+        int globalLightCount = 0;
+        std::vector<GpuLight> packed;
+        std::vector<LightClusters::Sphere> spheres;
+        LightClusters clusters;
+
+#ifndef NDEBUG
+        int validatedLightCount = -1;
+#endif
+    };
+
+} // namespace ppgso
+
+#endif
@@ -0,0 +1,166 @@
+#include "light_clusters.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ppgso {
+
+    LightClusters::LightClusters(int tilesX, int tilesY, int slices)
+        : tilesX(std::max(1, tilesX))
+        , tilesY(std::max(1, tilesY))
+        , slices(std::max(1, slices))
+    {
+        ranges.assign(getClusterCount(), glm::uvec2(0));
+        bins.resize(getClusterCount());
+    }
+
+    void LightClusters::setProjection(const glm::mat4& projection) {
+        // glm::perspective: [2][2] = -(f+n)/(f-n), [3][2] = -2fn/(f-n)
+        float n = projection[3][2] / (projection[2][2] - 1.0f);
+        float f = projection[3][2] / (projection[2][2] + 1.0f);
+
+        if (n == nearPlane && f == farPlane &&
+            projection[0][0] == scaleX && projection[1][1] == scaleY) {
+            return;
+        }
+
+        nearPlane = n;
+        farPlane = f;
+        scaleX = projection[0][0];
+        scaleY = projection[1][1];
+        computeBounds();
+    }
+
+    void LightClusters::computeBounds() {
+        sliceDepth.resize(slices + 1);
+        for (int z = 0; z <= slices; z++) {
+            sliceDepth[z] = nearPlane * std::pow(farPlane / nearPlane, (float)z / slices);
+        }
+
+        // Dlazdica pokryva NDC interval [a, b], vo view priestore je to x = ndc * d / scale,
+        // AABB clustra je obal tohto intervalu na blizkej a vzdialenej hranici vrstvy
+        auto tileBounds = [this](std::vector<glm::vec2>& bounds, int tiles, float scale) {
+            bounds.resize(slices * tiles);
+            for (int z = 0; z < slices; z++) {
+                float d0 = sliceDepth[z];
+                float d1 = sliceDepth[z + 1];
+                for (int t = 0; t < tiles; t++) {
+                    float a = -1.0f + 2.0f * t / tiles;
+                    float b = -1.0f + 2.0f * (t + 1) / tiles;
+                    bounds[z * tiles + t] = glm::vec2(std::min(a * d0, a * d1) / scale,
+                                                      std::max(b * d0, b * d1) / scale);
+                }
+            }
+        };
+        tileBounds(tileBoundsX, tilesX, scaleX);
+        tileBounds(tileBoundsY, tilesY, scaleY);
+    }
+
+    float LightClusters::getSliceScale() const {
+        return slices / std::log(farPlane / nearPlane);
+    }
+
+    float LightClusters::getSliceBias() const {
+        return -slices * std::log(nearPlane) / std::log(farPlane / nearPlane);
+    }
+
+    int LightClusters::sliceForDepth(float depth) const {
+        int z = (int)std::floor(std::log(depth) * getSliceScale() + getSliceBias());
+        return std::min(std::max(z, 0), slices - 1);
+    }
+
+    bool LightClusters::intersects(const glm::vec3& center, float radius, int x, int y, int z) const {
+        // Gula proti AABB: vzdialenost stredu od najblizsieho bodu boxu
+        const glm::vec2& bx = tileBoundsX[z * tilesX + x];
+        const glm::vec2& by = tileBoundsY[z * tilesY + y];
+        glm::vec3 boxMin(bx.x, by.x, -sliceDepth[z + 1]);
+        glm::vec3 boxMax(bx.y, by.y, -sliceDepth[z]);
+
+        glm::vec3 closest = glm::clamp(center, boxMin, boxMax);
+        glm::vec3 delta = center - closest;
+        return glm::dot(delta, delta) <= radius * radius;
+    }
+
+    void LightClusters::build(const glm::mat4& view, const std::vector<Sphere>& spheres) {
+        for (auto& bin : bins) bin.clear();
+
+        stats = Stats();
+        stats.lights = (int)spheres.size();
+
+        for (auto& sphere : spheres) {
+            glm::vec3 center = glm::vec3(view * glm::vec4(sphere.center, 1.0f));
+            float radius = sphere.radius;
+            float depth = -center.z;
+
+            if (depth + radius < nearPlane || depth - radius > farPlane) continue;
+
+            bool visible = false;
+            for (int z = 0; z < slices; z++) {
+                if (depth + radius < sliceDepth[z] || depth - radius > sliceDepth[z + 1]) continue;
+
+                // Osi su separabilne: kandidati su sucin dlazdic, ktore sa prekryvaju v x aj v y
+                int x0 = tilesX, x1 = -1;
+                for (int x = 0; x < tilesX; x++) {
+                    const glm::vec2& b = tileBoundsX[z * tilesX + x];
+                    if (center.x + radius < b.x || center.x - radius > b.y) continue;
+                    x0 = std::min(x0, x);
+                    x1 = x;
+                }
+                int y0 = tilesY, y1 = -1;
+                for (int y = 0; y < tilesY; y++) {
+                    const glm::vec2& b = tileBoundsY[z * tilesY + y];
+                    if (center.y + radius < b.x || center.y - radius > b.y) continue;
+                    y0 = std::min(y0, y);
+                    y1 = y;
+                }
+
+                for (int y = y0; y <= y1; y++) {
+                    for (int x = x0; x <= x1; x++) {
+                        if (!intersects(center, radius, x, y, z)) continue;
+                        bins[clusterIndex(x, y, z)].push_back(sphere.lightIndex);
+                        visible = true;
+                    }
+                }
+            }
+            if (visible) stats.visibleLights++;
+        }
+
+        // Zlucenie do jedneho zoznamu
+        indices.clear();
+        for (int c = 0; c < getClusterCount(); c++) {
+            const auto& bin = bins[c];
+            ranges[c] = glm::uvec2((uint32_t)indices.size(), (uint32_t)bin.size());
+            indices.insert(indices.end(), bin.begin(), bin.end());
+
+            if (!bin.empty()) stats.occupiedClusters++;
+            stats.maxPerCluster = std::max(stats.maxPerCluster, (int)bin.size());
+        }
+        stats.assignments = (int)indices.size();
+    }
+
+    bool LightClusters::matchesReference(const glm::mat4& view, const std::vector<Sphere>& spheres) const {
+        std::vector<glm::vec3> centers;
+        for (auto& sphere : spheres) {
+            centers.push_back(glm::vec3(view * glm::vec4(sphere.center, 1.0f)));
+        }
+
+        std::vector<uint32_t> expected;
+        for (int z = 0; z < slices; z++) {
+            for (int y = 0; y < tilesY; y++) {
+                for (int x = 0; x < tilesX; x++) {
+                    expected.clear();
+                    for (size_t i = 0; i < spheres.size(); i++) {
+                        if (intersects(centers[i], spheres[i].radius, x, y, z)) {
+                            expected.push_back(spheres[i].lightIndex);
+                        }
+                    }
+
+                    const glm::uvec2& range = ranges[clusterIndex(x, y, z)];
+                    if (range.y != expected.size()) return false;
+                    if (!std::equal(expected.begin(), expected.end(), indices.begin() + range.x)) return false;
+                }
+            }
+        }
+        return true;
+    }
+
+} // namespace ppgso
@@ -0,0 +1,97 @@
+#ifndef PPGSO_LIGHT_CLUSTERS_H
+#define PPGSO_LIGHT_CLUSTERS_H
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace ppgso {
+
+    /**
+     * LightClusters - Binovanie svetiel do 3D mriezky nad view frustom (clustered shading)
+     *
+     * Obrazovka sa deli na tilesX x tilesY dlazdic a hlbka na slices vrstiev s exponencialnym
+     * rozostupom medzi near a far, kazdy cluster je teda kusok frustra. Svetlo (gula s dosahom
+     * zo setRange) sa zapise do kazdeho clustra, ktoreho AABB vo view priestore pretina. Vysledok
+     * je pre kazdy cluster (offset, pocet) do spolocneho zoznamu indexov svetiel, fragment shader
+     * potom pocita len svetla svojho clustra.
+     *
+     * Trieda nepouziva OpenGL, da sa teda overit aj bez okna (pozri matchesReference).
+     * Predpoklada symetricku perspektivnu projekciu (glm::perspective).
+     */
+    class LightClusters {
+    public:
+        // Gula svetla vo svete a index jeho zaznamu v light bufferi
+        struct Sphere {
+            glm::vec3 center;
+            float radius;
+            uint32_t lightIndex;
+        };
+
+        // Prehlad posledneho buildu
+        struct Stats {
+            int lights = 0;            // Binovane svetla
+            int visibleLights = 0;     // Svetla, ktore zasiahli aspon jeden cluster
+            int assignments = 0;       // Dlzka zoznamu indexov
+            int occupiedClusters = 0;
+            int maxPerCluster = 0;
+        };
+
+        LightClusters(int tilesX = 16, int tilesY = 9, int slices = 24);
+
+        // Z projekcnej matice si vytiahne near, far a sklon frustra
+        // Hranice clustrov sa prepocitaju len ked sa projekcia zmeni
+        void setProjection(const glm::mat4& projection);
+
+        // Rozdeli svetla do clustrov podla aktualnej view matice kamery
+        void build(const glm::mat4& view, const std::vector<Sphere>& spheres);
+
+        // Porovna posledny build s hrubou silou (kazda gula proti kazdemu clustru)
+        bool matchesReference(const glm::mat4& view, const std::vector<Sphere>& spheres) const;
+
+        int getTilesX() const { return tilesX; }
+        int getTilesY() const { return tilesY; }
+        int getSlices() const { return slices; }
+        int getClusterCount() const { return tilesX * tilesY * slices; }
+        float getNear() const { return nearPlane; }
+        float getFar() const { return farPlane; }
+
+        // Vrstva pre view hlbku d: floor(log(d) * scale + bias), rovnako ako v shaderi
+        float getSliceScale() const;
+        float getSliceBias() const;
+        int sliceForDepth(float depth) const;
+
+        int clusterIndex(int x, int y, int z) const { return (z * tilesY + y) * tilesX + x; }
+
+        // Pre kazdy cluster (offset do indexov, pocet svetiel)
+        const std::vector<glm::uvec2>& getRanges() const { return ranges; }
+        const std::vector<uint32_t>& getIndices() const { return indices; }
+
+        const Stats& getStats() const { return stats; }
+
+    private:
+        int tilesX, tilesY, slices;
+
+        // Parametre projekcie
+        float nearPlane = 0.0f, farPlane = 0.0f;
+        float scaleX = 0.0f, scaleY = 0.0f;   // projection[0][0], projection[1][1]
+
+        // Hranice AABB clustrov vo view priestore, po osiach (kazda os je separabilna)
+        std::vector<float> sliceDepth;        // slices + 1 hranic (kladna vzdialenost)
+        std::vector<glm::vec2> tileBoundsX;   // [slice * tilesX + x] = (min, max)
+        std::vector<glm::vec2> tileBoundsY;   // [slice * tilesY + y] = (min, max)
+
+        std::vector<glm::uvec2> ranges;
+        std::vector<uint32_t> indices;
+        Stats stats;
+
+        // Pracovne pole: svetla po clustroch pred zlucenim
+        std::vector<std::vector<uint32_t>> bins;
+
+        void computeBounds();
+        bool intersects(const glm::vec3& center, float radius, int x, int y, int z) const;
+    };
+
+} // namespace ppgso
+
+#endif // PPGSO_LIGHT_CLUSTERS_H
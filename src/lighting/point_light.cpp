@@ -8,6 +8,7 @@ namespace ppgso {
         , constantAttenuation(1.0f)
         , linearAttenuation(0.09f)
         , quadraticAttenuation(0.032f)
+        , range(50.0f)
     {
         setColor(glm::vec3(1.0f, 1.0f, 1.0f));
     }
@@ -18,6 +19,7 @@ namespace ppgso {
         , constantAttenuation(1.0f)
         , linearAttenuation(0.09f)
         , quadraticAttenuation(0.032f)
+        , range(50.0f)
     {
         setColor(glm::vec3(1.0f, 1.0f, 1.0f));
     }
@@ -31,26 +33,29 @@ namespace ppgso {
     }
 
     void PointLight::setRange(float range) {
+        this->range = range;
         constantAttenuation = 1.0f;
         linearAttenuation = 4.5f / range;
         quadraticAttenuation = 75.0f / (range * range);
     }
 
-    void PointLight::setupShaderUniforms(ppgso::Shader& shader, int lightIndex) {
-        if (!enabled) {
-            shader.setUniform(getUniformName(lightIndex, "enabled"), 0);
-            return;
-        }
-
-        shader.setUniform(getUniformName(lightIndex, "type"), 1);
-        shader.setUniform(getUniformName(lightIndex, "position"), position);
-        shader.setUniform(getUniformName(lightIndex, "ambient"), ambient * intensity);
-        shader.setUniform(getUniformName(lightIndex, "diffuse"), diffuse * intensity);
-        shader.setUniform(getUniformName(lightIndex, "specular"), specular * intensity);
-        shader.setUniform(getUniformName(lightIndex, "constantAttenuation"), constantAttenuation);
-        shader.setUniform(getUniformName(lightIndex, "linearAttenuation"), linearAttenuation);
-        shader.setUniform(getUniformName(lightIndex, "quadraticAttenuation"), quadraticAttenuation);
-        shader.setUniform(getUniformName(lightIndex, "enabled"), 1);
+    void PointLight::pack(GpuLight& light) const {
+        packCommon(light);
+        light.position = position;
+        light.constantAttenuation = constantAttenuation;
+        light.linearAttenuation = linearAttenuation;
+        light.quadraticAttenuation = quadraticAttenuation;
+        light.range = range;
+    }
+
+    float PointLight::getRange() const {
+        return range;
+    }
+
+    bool PointLight::getBounds(glm::vec3& center, float& radius) const {
+        center = position;
+        radius = range;
+        return true;
     }
 
 } // namespace ppgso
\ No newline at end of file
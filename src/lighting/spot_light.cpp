@@ -11,6 +11,7 @@ namespace ppgso {
         , constantAttenuation(1.0f)
         , linearAttenuation(0.09f)
         , quadraticAttenuation(0.032f)
+        , range(50.0f)
     {
         setColor(glm::vec3(1.0f, 1.0f, 1.0f));
     }
@@ -24,6 +25,7 @@ namespace ppgso {
         , constantAttenuation(1.0f)
         , linearAttenuation(0.09f)
         , quadraticAttenuation(0.032f)
+        , range(50.0f)
     {
         setColor(glm::vec3(1.0f, 1.0f, 1.0f));
     }
@@ -50,29 +52,32 @@ namespace ppgso {
     }
 
     void SpotLight::setRange(float range) {
+        this->range = range;
         constantAttenuation = 1.0f;
         linearAttenuation = 4.5f / range;
         quadraticAttenuation = 75.0f / (range * range);
     }
 
-    void SpotLight::setupShaderUniforms(ppgso::Shader& shader, int lightIndex) {
-        if (!enabled) {
-            shader.setUniform(getUniformName(lightIndex, "enabled"), 0);
-            return;
-        }
+    void SpotLight::pack(GpuLight& light) const {
+        packCommon(light);
+        light.position = position;
+        light.direction = direction;
+        light.innerCutoff = innerCutoff;
+        light.outerCutoff = outerCutoff;
+        light.constantAttenuation = constantAttenuation;
+        light.linearAttenuation = linearAttenuation;
+        light.quadraticAttenuation = quadraticAttenuation;
+        light.range = range;
+    }
+
+    float SpotLight::getRange() const {
+        return range;
+    }
 
-        shader.setUniform(getUniformName(lightIndex, "type"), 2);
-        shader.setUniform(getUniformName(lightIndex, "position"), position);
-        shader.setUniform(getUniformName(lightIndex, "direction"), direction);
-        shader.setUniform(getUniformName(lightIndex, "ambient"), ambient * intensity);
-        shader.setUniform(getUniformName(lightIndex, "diffuse"), diffuse * intensity);
-        shader.setUniform(getUniformName(lightIndex, "specular"), specular * intensity);
-        shader.setUniform(getUniformName(lightIndex, "innerCutoff"), innerCutoff);
-        shader.setUniform(getUniformName(lightIndex, "outerCutoff"), outerCutoff);
-        shader.setUniform(getUniformName(lightIndex, "constantAttenuation"), constantAttenuation);
-        shader.setUniform(getUniformName(lightIndex, "linearAttenuation"), linearAttenuation);
-        shader.setUniform(getUniformName(lightIndex, "quadraticAttenuation"), quadraticAttenuation);
-        shader.setUniform(getUniformName(lightIndex, "enabled"), 1);
+    bool SpotLight::getBounds(glm::vec3& center, float& radius) const {
+        center = position;
+        radius = range;
+        return true;
     }
 
 } // namespace ppgso
\ No newline at end of file
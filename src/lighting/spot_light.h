@@ -25,11 +25,16 @@ namespace ppgso {
         float linearAttenuation;
         float quadraticAttenuation;
 
+        // Nastavi utlm tak, aby na hranici dosahu zostalo ~1% svetla
         void setRange(float range);
-        void setupShaderUniforms(ppgso::Shader& shader, int lightIndex) override;
+        float getRange() const;
+
+        void pack(GpuLight& light) const override;
+        bool getBounds(glm::vec3& center, float& radius) const override;
 
     private:
         glm::vec3 position;
+        float range;
         glm::vec3 direction;
     };
 
@@ -92,22 +92,9 @@ namespace ppgso {
         shader->setUniform("useTexture", false);
         shader->setUniform("useBlinnPhong", true);
 
-        int numLights = std::min((int)lights.size(), 3);
-        shader->setUniform("numLights", numLights);
-
-        for (int i = 0; i < numLights; i++) {
-            if (lights[i]) {
-                lights[i]->setupShaderUniforms(*shader, i);
-            }
-        }
-
         mesh->render();
     }
 
-    void AnimatedCube::setLights(const std::vector<std::shared_ptr<Light>>& lights) {
-        this->lights = lights;
-    }
-
     AnimationController& AnimatedCube::getAnimationController() {
         return animationController;
     }
@@ -2,7 +2,6 @@
 #define PPGSO_ANIMATED_CUBE_H
 
 #include "../objects/object.h"
-#include "../lighting/light.h"
 #include "../animation/animation_controller.h"
 #include <vector>
 #include <memory>
@@ -26,9 +25,6 @@ namespace ppgso {
         glm::vec3 materialSpecular;
         float materialShininess;
 
-        // Lights
-        void setLights(const std::vector<std::shared_ptr<Light>>& lights);
-
         // Animation
         AnimationController& getAnimationController();
         void setupAnimation();
@@ -39,7 +35,6 @@ namespace ppgso {
         void setBobbingSpeed(float speed);
 
     private:
-        std::vector<std::shared_ptr<Light>> lights;
         AnimationController animationController;
         
         // Proceduralna animacia
@@ -0,0 +1,72 @@
+#include "instance_batch.h"
+#include "../lighting/light_buffer.h"
+#include <shaders/instanced_vert_glsl.h>
+#include <shaders/phong_frag_glsl.h>
+#include <iostream>
+
+namespace ppgso {
+
+    // Prve lokacie atributu model matice (instanced_vert.glsl)
+    static const GLuint MODEL_MATRIX_LOCATION = 3;
+
+    InstanceBatch::InstanceBatch(const std::string& meshFile) {
+        try {
+            mesh = std::make_unique<ppgso::Mesh>(meshFile);
+            shader = std::make_unique<ppgso::Shader>(instanced_vert_glsl, phong_frag_glsl);
+        } catch (std::exception& e) {
+            std::cerr << "Error creating instance batch " << meshFile << ": " << e.what() << std::endl;
+            return;
+        }
+
+        viewMatrixUniform = shader->getUniform<glm::mat4>("ViewMatrix");
+        projectionMatrixUniform = shader->getUniform<glm::mat4>("ProjectionMatrix");
+        materialAmbientUniform = shader->getUniform<glm::vec3>("material.ambient");
+        materialDiffuseUniform = shader->getUniform<glm::vec3>("material.diffuse");
+        materialSpecularUniform = shader->getUniform<glm::vec3>("material.specular");
+        materialShininessUniform = shader->getUniform<float>("material.shininess");
+        viewPosUniform = shader->getUniform<glm::vec3>("viewPos");
+        LightBuffer::attach(*shader);
+
+        // Program patri len tejto davke, prepinace sa nemenia a nastavia sa raz
+        shader->setUniform("useTexture", false);
+        shader->setUniform("useBlinnPhong", true);
+
+        // Atributy instancii sa na VAO meshu napoja raz, buffer sa potom len prepisuje
+        glGenBuffers(1, &instanceBuffer);
+        mesh->setInstanceBuffer(instanceBuffer, MODEL_MATRIX_LOCATION);
+    }
+
+    InstanceBatch::~InstanceBatch() {
+        if (instanceBuffer) glDeleteBuffers(1, &instanceBuffer);
+    }
+
+    void InstanceBatch::add(const glm::mat4& modelMatrix) {
+        matrices.push_back(modelMatrix);
+    }
+
+    void InstanceBatch::render(const Camera& camera) {
+        if (matrices.empty()) return;
+        if (!mesh || !shader) {
+            matrices.clear();
+            return;
+        }
+
+        // Novy obsah bufferu, driver nemusi cakat na predchadzajuci frame
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        glBufferData(GL_ARRAY_BUFFER, matrices.size() * sizeof(glm::mat4), matrices.data(), GL_STREAM_DRAW);
+
+        shader->use();
+        viewMatrixUniform.set(camera.getViewMatrix());
+        projectionMatrixUniform.set(camera.getProjectionMatrix());
+
+        materialAmbientUniform.set(materialAmbient);
+        materialDiffuseUniform.set(materialDiffuse);
+        materialSpecularUniform.set(materialSpecular);
+        materialShininessUniform.set(materialShininess);
+        viewPosUniform.set(camera.getPosition());
+
+        mesh->renderInstanced((GLsizei)matrices.size());
+        matrices.clear();
+    }
+
+} // namespace ppgso
@@ -0,0 +1,61 @@
+#ifndef PPGSO_INSTANCE_BATCH_H
+#define PPGSO_INSTANCE_BATCH_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <ppgso/ppgso.h>
+
+#include "../camera/camera.h"
+
+namespace ppgso {
+
+    /**
+     * InstanceBatch - Jeden mesh vykresleny pre vela objektov jednym glDrawElementsInstanced
+     *
+     * Objekty, ktore zdielaju davku (Object::setInstanceBatch), nekreslia samy - render list
+     * im cez add() zapise svetovu maticu do per-frame instance bufferu a po prechode vsetkych
+     * objektov vykresli kazdu davku raz. Shader je instanced_vert + phong_frag, takze
+     * instancie su osvetlene rovnako ako ostatne objekty.
+     */
+    class InstanceBatch {
+    public:
+        explicit InstanceBatch(const std::string& meshFile);
+        ~InstanceBatch();
+
+        InstanceBatch(const InstanceBatch&) = delete;
+        InstanceBatch& operator=(const InstanceBatch&) = delete;
+
+        // Prida instanciu do aktualneho frame
+        void add(const glm::mat4& modelMatrix);
+
+        // Nahra matice, vykresli vsetky instancie jednym volanim a vyprazdni davku
+        void render(const Camera& camera);
+
+        size_t getInstanceCount() const { return matrices.size(); }
+        const ppgso::Mesh* getMesh() const { return mesh.get(); }
+
+        // Material spolocny pre vsetky instancie
+        glm::vec3 materialAmbient = glm::vec3(0.3f);
+        glm::vec3 materialDiffuse = glm::vec3(0.6f);
+        glm::vec3 materialSpecular = glm::vec3(0.2f);
+        float materialShininess = 16.0f;
+
+    private:
+        std::unique_ptr<ppgso::Mesh> mesh;
+        std::unique_ptr<ppgso::Shader> shader;
+        GLuint instanceBuffer = 0;
+        std::vector<glm::mat4> matrices;
+
+        ppgso::Shader::Uniform<glm::mat4> viewMatrixUniform;
+        ppgso::Shader::Uniform<glm::mat4> projectionMatrixUniform;
+        ppgso::Shader::Uniform<glm::vec3> materialAmbientUniform;
+        ppgso::Shader::Uniform<glm::vec3> materialDiffuseUniform;
+        ppgso::Shader::Uniform<glm::vec3> materialSpecularUniform;
+        ppgso::Shader::Uniform<float> materialShininessUniform;
+        ppgso::Shader::Uniform<glm::vec3> viewPosUniform;
+    };
+
+} // namespace ppgso
+
+#endif // PPGSO_INSTANCE_BATCH_H
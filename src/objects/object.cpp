@@ -1,4 +1,6 @@
 #include "object.h"
+#include "instance_batch.h"
+#include "../lighting/light_buffer.h"
 
 namespace ppgso {
 
@@ -38,10 +40,18 @@ namespace ppgso {
         mesh->render();
     }
 
+    void Object::setInstanceBatch(std::shared_ptr<InstanceBatch> batch) {
+        instanceBatch = std::move(batch);
+        if (instanceBatch && instanceBatch->getMesh()) {
+            setLocalBounds(instanceBatch->getMesh()->getBoundsMin(), instanceBatch->getMesh()->getBoundsMax());
+        }
+    }
+
     // Helper metody
     void Object::loadMesh(const std::string& filename) {
         try {
             mesh = std::make_unique<ppgso::Mesh>(filename);
+            setLocalBounds(mesh->getBoundsMin(), mesh->getBoundsMax());
         } catch (std::exception& e) {
             std::cerr << "Error loading mesh " << filename << ": " << e.what() << std::endl;
         }
@@ -53,6 +63,7 @@ namespace ppgso {
         try {
             // ppgso::Shader očakáva cesty bez .glsl prípony alebo priamo string s kodom
             shader = std::make_unique<ppgso::Shader>(vertPath, fragPath);
+            resolveUniforms();
         } catch (std::exception& e) {
             std::cerr << "Error loading shader " << vertPath << "/" << fragPath << ": " << e.what() << std::endl;
         }
@@ -62,6 +73,7 @@ namespace ppgso {
         try {
             // Priame nacitanie z string kodu (ako v test_cube.cpp)
             shader = std::make_unique<ppgso::Shader>(vertCode, fragCode);
+            resolveUniforms();
         } catch (std::exception& e) {
             std::cerr << "Error loading shader from code: " << e.what() << std::endl;
         }
@@ -79,12 +91,22 @@ namespace ppgso {
         if (!shader) return;
 
         glm::mat4 modelMatrix = transform.getWorldMatrix();
-        shader->setUniform("ModelMatrix", modelMatrix);
-        shader->setUniform("ViewMatrix", camera.getViewMatrix());
-        shader->setUniform("ProjectionMatrix", camera.getProjectionMatrix());
+        modelMatrixUniform.set(modelMatrix);
+        viewMatrixUniform.set(camera.getViewMatrix());
+        projectionMatrixUniform.set(camera.getProjectionMatrix());
 
         // NormalMatrix workaround
         glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(modelMatrix)));
-        shader->setUniform("NormalMatrix", normalMatrix);
+        normalMatrixUniform.set(normalMatrix);
+    }
+
+    void Object::resolveUniforms() {
+        modelMatrixUniform = shader->getUniform<glm::mat4>("ModelMatrix");
+        viewMatrixUniform = shader->getUniform<glm::mat4>("ViewMatrix");
+        projectionMatrixUniform = shader->getUniform<glm::mat4>("ProjectionMatrix");
+        normalMatrixUniform = shader->getUniform<glm::mat3>("NormalMatrix");
+
+        // Osvetlene programy citaju svetla zo spolocneho bufferu
+        LightBuffer::attach(*shader);
     }
 } // namespace ppgso
\ No newline at end of file
@@ -9,6 +9,8 @@
 
 namespace ppgso {
 
+    class InstanceBatch;
+
     /**
      * Object - Abstraktna baza pre vsetky objekty v scene
      * Roziruje SceneNode o renderovanie s meshom a shadrom
@@ -25,11 +27,24 @@ namespace ppgso {
         // Rendering s kamerou
         virtual void renderWithCamera(const Camera& camera);
 
+        // Pre zoskupenie vykreslovania podla shadera a meshu (nullptr ak este nie su nacitane)
+        const ppgso::Shader* getShader() const { return shader.get(); }
+        const ppgso::Mesh* getMesh() const { return mesh.get(); }
+
+        // Objekt kresleny cez spolocnu davku (jeden instanced draw pre vsetky objekty davky),
+        // render list mu renderWithCamera nevola. Obalka sa nastavi z meshu davky.
+        void setInstanceBatch(std::shared_ptr<InstanceBatch> batch);
+        InstanceBatch* getInstanceBatch() const { return instanceBatch.get(); }
+
+        // Priehladne objekty (castice) render list kresli az po vsetkych nepriehladnych a davkach
+        virtual bool isTransparent() const { return false; }
+
     protected:
         // Mesh a shader (budu inicializovane v odvodených triedach)
         std::unique_ptr<ppgso::Mesh> mesh;
         std::unique_ptr<ppgso::Shader> shader;
         std::unique_ptr<ppgso::Texture> texture;
+        std::shared_ptr<InstanceBatch> instanceBatch;
 
         // Helper metody
         virtual void loadMesh(const std::string& filename);
@@ -39,6 +54,13 @@ namespace ppgso {
 
         // Rendering helpers
         virtual void setupShaderUniforms(const Camera& camera);
+
+        // Uniformy matic su resolvnute raz po nacitani shadera, bez hladania podla mena pri kazdom vykresleni
+        ppgso::Shader::Uniform<glm::mat4> modelMatrixUniform;
+        ppgso::Shader::Uniform<glm::mat4> viewMatrixUniform;
+        ppgso::Shader::Uniform<glm::mat4> projectionMatrixUniform;
+        ppgso::Shader::Uniform<glm::mat3> normalMatrixUniform;
+        void resolveUniforms();
     };
 
 } // namespace ppgso
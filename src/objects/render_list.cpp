@@ -0,0 +1,94 @@
+#include "render_list.h"
+#include <algorithm>
+
+namespace ppgso {
+
+    void RenderList::onNodeAdded(SceneNode* node) {
+        // Typ sa zisti raz pri pridani, nie pri kazdom vykresleni
+        auto object = dynamic_cast<Object*>(node);
+        if (object != nullptr) {
+            registered.insert(object);
+            dirty = true;
+        }
+    }
+
+    void RenderList::onNodeRemoved(SceneNode* node) {
+        auto object = dynamic_cast<Object*>(node);
+        if (object != nullptr && registered.erase(object) > 0) {
+            dirty = true;
+        }
+    }
+
+    void RenderList::onNodeVisibilityChanged(SceneNode* node) {
+        // Skryty uzol skryva aj cely podstrom, najjednoduchsie je prebudovat zoznam
+        dirty = true;
+    }
+
+    const std::vector<Object*>& RenderList::getObjects() {
+        if (dirty) rebuild();
+        return objects;
+    }
+
+    void RenderList::render(const Camera& camera) {
+        if (dirty) rebuild();
+
+        drawn = culled = instanced = drawCalls = 0;
+        batches.clear();
+        for (size_t i = 0; i < objects.size(); i++) {
+            // Davky sa dokreslia pred prvym priehladnym objektom, aby ho nic neprekrylo
+            if (i == opaqueCount) flushBatches(camera);
+
+            Object* object = objects[i];
+            if (frustumCulling && object->isCulled()) {
+                culled++;
+                continue;
+            }
+            drawn++;
+
+            InstanceBatch* batch = object->getInstanceBatch();
+            if (batch != nullptr) {
+                if (batch->getInstanceCount() == 0) batches.push_back(batch);
+                batch->add(object->getTransform().getWorldMatrix());
+                instanced++;
+                continue;
+            }
+            object->renderWithCamera(camera);
+            drawCalls++;
+        }
+        flushBatches(camera);
+    }
+
+    void RenderList::flushBatches(const Camera& camera) {
+        // Kazda davka jednym instanced draw
+        for (InstanceBatch* batch : batches) {
+            batch->render(camera);
+            drawCalls++;
+        }
+        batches.clear();
+    }
+
+    void RenderList::rebuild() {
+        objects.clear();
+        for (Object* object : registered) {
+            if (object->isVisibleInHierarchy()) {
+                objects.push_back(object);
+            }
+        }
+
+        // Priehladne objekty na koniec, inak objekty s rovnakym shadrom (a meshom) idu za sebou
+        std::sort(objects.begin(), objects.end(), [](const Object* a, const Object* b) {
+            if (a->isTransparent() != b->isTransparent()) return b->isTransparent();
+            if (a->getShader() != b->getShader()) return a->getShader() < b->getShader();
+            if (a->getMesh() != b->getMesh()) return a->getMesh() < b->getMesh();
+            return a < b;
+        });
+
+        opaqueCount = std::find_if(objects.begin(), objects.end(), [](const Object* object) {
+            return object->isTransparent();
+        }) - objects.begin();
+
+        dirty = false;
+        rebuilds++;
+    }
+
+} // namespace ppgso
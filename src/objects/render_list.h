@@ -0,0 +1,68 @@
+#ifndef PPGSO_RENDER_LIST_H
+#define PPGSO_RENDER_LIST_H
+
+#include <unordered_set>
+#include <vector>
+
+#include "object.h"
+#include "instance_batch.h"
+
+namespace ppgso {
+
+    /**
+     * RenderList - Ploche pole vykreslovanych objektov sceny
+     *
+     * Pripaja sa ako listener na root grafu sceny. Objekty sa zbieraju len pri pridani /
+     * odobrati uzla (addChild / removeChild) a pri zmene viditelnosti, pole sa potom
+     * prebuduje raz pred dalsim vykreslenim: len viditelne objekty (aj s predkami),
+     * zoradene podla shadera a meshu. Kazdy frame je to uz len cyklus cez raw pointre,
+     * bez dynamic_pointer_cast a bez kopii shared_ptr. Objekty orezane poslednym
+     * frustum cullingom (TransformStore::cull) sa preskocia. Objekty s InstanceBatch
+     * len pridaju svoju maticu do davky a kazda davka sa vykresli raz po ostatnych
+     * nepriehladnych objektoch. Priehladne objekty su v poli na konci a kreslia sa posledne.
+     */
+    class RenderList : public SceneNodeListener {
+    public:
+        void onNodeAdded(SceneNode* node) override;
+        void onNodeRemoved(SceneNode* node) override;
+        void onNodeVisibilityChanged(SceneNode* node) override;
+
+        // Vykresli vsetky viditelne objekty
+        void render(const Camera& camera);
+
+        // Viditelne objekty v poradi vykreslenia
+        const std::vector<Object*>& getObjects();
+
+        // Ci render() preskakuje orezane objekty
+        void setFrustumCulling(bool enabled) { frustumCulling = enabled; }
+        bool isFrustumCullingEnabled() const { return frustumCulling; }
+
+        size_t getRegisteredCount() const { return registered.size(); }
+        int getRebuildCount() const { return rebuilds; }
+
+        // Pocty z posledneho render()
+        int getDrawnCount() const { return drawn; }
+        int getCulledCount() const { return culled; }
+        int getInstancedCount() const { return instanced; }
+        int getDrawCallCount() const { return drawCalls; }
+
+    private:
+        std::unordered_set<Object*> registered;
+        std::vector<Object*> objects;          // Nepriehladne [0, opaqueCount), potom priehladne
+        size_t opaqueCount = 0;
+        std::vector<InstanceBatch*> batches;   // Davky s instanciami v aktualnom frame
+        bool dirty = false;
+        bool frustumCulling = true;
+        int rebuilds = 0;
+        int drawn = 0;
+        int culled = 0;
+        int instanced = 0;
+        int drawCalls = 0;
+
+        void rebuild();
+        void flushBatches(const Camera& camera);
+    };
+
+} // namespace ppgso
+
+#endif // PPGSO_RENDER_LIST_H
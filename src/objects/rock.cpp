@@ -2,4 +2,27 @@
 // Created by mrepi on 20. 11. 2025.
 //
 
-#include "rock.h"
\ No newline at end of file
+#include "rock.h"
+
+namespace ppgso {
+
+    Rock::Rock() : Object("Rock") {
+        setInstanceBatch(getSharedBatch());
+    }
+
+    std::shared_ptr<InstanceBatch> Rock::getSharedBatch() {
+        // Davka zanikne s poslednym kamenom
+        static std::weak_ptr<InstanceBatch> shared;
+        auto batch = shared.lock();
+        if (!batch) {
+            batch = std::make_shared<InstanceBatch>("asteroid.obj");
+            batch->materialAmbient = glm::vec3(0.25f, 0.23f, 0.2f);
+            batch->materialDiffuse = glm::vec3(0.55f, 0.5f, 0.45f);
+            batch->materialSpecular = glm::vec3(0.1f);
+            batch->materialShininess = 8.0f;
+            shared = batch;
+        }
+        return batch;
+    }
+
+} // namespace ppgso
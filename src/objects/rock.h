@@ -5,4 +5,25 @@
 #ifndef PPGSO_ROCK_H
 #define PPGSO_ROCK_H
 
-#endif //PPGSO_ROCK_H
\ No newline at end of file
+#include <memory>
+
+#include "object.h"
+#include "instance_batch.h"
+
+namespace ppgso {
+
+    /**
+     * Rock - Kamen na pobrezi
+     * Vsetky kamene zdielaju jeden mesh a kreslia sa spolu jednym instanced draw
+     */
+    class Rock : public Object {
+    public:
+        Rock();
+
+        // Davka zdielana vsetkymi kamenmi, vytvori sa s prvym kamenom
+        static std::shared_ptr<InstanceBatch> getSharedBatch();
+    };
+
+} // namespace ppgso
+
+#endif //PPGSO_ROCK_H
@@ -55,22 +55,9 @@ namespace ppgso {
         shader->setUniform("useTexture", false);
         shader->setUniform("useBlinnPhong", true);
 
-        int numLights = std::min((int)lights.size(), 3);
-        shader->setUniform("numLights", numLights);
-
-        for (int i = 0; i < numLights; i++) {
-            if (lights[i]) {
-                lights[i]->setupShaderUniforms(*shader, i);
-            }
-        }
-
         std::cout << "📦 Calling mesh->render()..." << std::endl;  // ✅ Vidíte toto?
         mesh->render();
         std::cout << "✅ mesh->render() done" << std::endl;  // ✅ Vidíte toto?
     }
 
-    void TestCube::setLights(const std::vector<std::shared_ptr<Light>>& lights) {
-        this->lights = lights;
-    }
-
 } // namespace ppgso
\ No newline at end of file
@@ -2,7 +2,6 @@
 #define PPGSO_TEST_CUBE_H
 
 #include "../objects/object.h"
-#include "../lighting/light.h"
 #include <vector>
 #include <memory>
 
@@ -20,13 +19,10 @@ namespace ppgso {
         glm::vec3 materialSpecular;
         float materialShininess;
 
-        void setLights(const std::vector<std::shared_ptr<Light>>& lights);
-
         float rotationSpeed;
         bool enableRotation;
 
     private:
-        std::vector<std::shared_ptr<Light>> lights;
         void setupMaterial();
     };
 
@@ -0,0 +1,197 @@
+#include "Buoyancy.h"
+#include "Ocean.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <ppgso/timing.h>
+
+Buoyancy::Buoyancy(const Ocean &ocean, ppgso::PhysicsWorld &world)
+    : ocean(ocean), forces(world.forces), frameStart(ocean.getTime()), frameEnd(ocean.getTime()) {
+    world.forces.addGenerator([this](ppgso::RigidBodyStore &bodies, float deltaTime) {
+        apply(bodies, deltaTime);
+    });
+}
+
+// ===================== Floaters =========================
+
+void Buoyancy::add(Handle body, const std::vector<glm::vec3> &samplePoints, float relativeDensity) {
+    if (samplePoints.empty()) return;
+    if (find(body)) remove(body);
+
+    if (floaterOf.size() <= body) floaterOf.resize(body + 1, -1);
+    floaterOf[body] = (int)floaters.size();
+
+    floaters.push_back({body, (uint32_t)offsets.size(), (uint32_t)samplePoints.size(),
+                        std::max(relativeDensity, 1e-3f), glm::vec3(0.0f, 1.0f, 0.0f), 0.0f, 0.0f, false});
+    offsets.insert(offsets.end(), samplePoints.begin(), samplePoints.end());
+}
+
+void Buoyancy::remove(Handle body) {
+    const Floater *floater = find(body);
+    if (!floater) return;
+
+    // Later floaters move one place down, their samples by the removed range
+    const int index = floaterOf[body];
+    const uint32_t first = floater->firstSample, count = floater->sampleCount;
+    offsets.erase(offsets.begin() + first, offsets.begin() + first + count);
+    floaters.erase(floaters.begin() + index);
+    floaterOf[body] = -1;
+
+    for (size_t i = index; i < floaters.size(); i++) {
+        floaters[i].firstSample -= count;
+        floaterOf[floaters[i].body] = (int)i;
+    }
+}
+
+void Buoyancy::clear() {
+    floaters.clear();
+    floaterOf.clear();
+    offsets.clear();
+}
+
+const Buoyancy::Floater *Buoyancy::find(Handle body) const {
+    if (body >= floaterOf.size() || floaterOf[body] < 0) return nullptr;
+    return &floaters[floaterOf[body]];
+}
+
+glm::vec3 Buoyancy::getSurfaceNormal(Handle body) const {
+    const Floater *floater = find(body);
+    return floater ? floater->surfaceNormal : glm::vec3(0.0f, 1.0f, 0.0f);
+}
+
+float Buoyancy::getSubmergedFraction(Handle body) const {
+    const Floater *floater = find(body);
+    return floater ? floater->submerged : 0.0f;
+}
+
+// ===================== Forces =========================
+
+float Buoyancy::stepTime() {
+    // The ocean moved on: a new frame starts where the last one ended
+    if (ocean.getTime() != frameEnd) {
+        frameStart = frameEnd;
+        frameEnd = ocean.getTime();
+        frameElapsed = 0.0f;
+    }
+
+    // Never past the ocean's own time (paused waves, steps catching up)
+    float t = frameStart + frameElapsed * ocean.getWaveFrequency();
+    return frameStart <= frameEnd ? std::min(t, frameEnd) : frameEnd;
+}
+
+void Buoyancy::apply(ppgso::RigidBodyStore &bodies, float deltaTime) {
+    // Kept up to date without floaters too, so the first ones added start at the right time
+    const float t = stepTime();
+    frameElapsed += deltaTime;
+
+    const int sampleCount = (int)offsets.size();
+    if (sampleCount == 0) return;
+
+    sampleX.resize(sampleCount);
+    sampleZ.resize(sampleCount);
+    waterHeight.resize(sampleCount);
+    waterNormal.resize(sampleCount);
+
+    // Sample points of every floater in one array
+    for (const Floater &floater : floaters) {
+        const glm::vec3 &position = bodies.positions[bodies.getSlot(floater.body)];
+        for (uint32_t i = floater.firstSample; i < floater.firstSample + floater.sampleCount; i++) {
+            sampleX[i] = position.x + offsets[i].x;
+            sampleZ[i] = position.z + offsets[i].z;
+        }
+    }
+
+    // The only wave evaluation of the step
+    auto start = std::chrono::high_resolution_clock::now();
+    ocean.getHeightsAndNormalsAt(sampleX.data(), sampleZ.data(), t,
+                                 waterHeight.data(), waterNormal.data(), sampleCount);
+    auto end = std::chrono::high_resolution_clock::now();
+    lastQueryTime = std::chrono::duration<float, std::milli>(end - start).count();
+
+    const float gravity = glm::length(forces.gravity);
+    const glm::vec3 up = gravity > 0.0f ? -forces.gravity / gravity : glm::vec3(0.0f, 1.0f, 0.0f);
+
+    for (Floater &floater : floaters) {
+        const uint32_t slot = bodies.getSlot(floater.body);
+        const float inverseMass = bodies.inverseMasses[slot];
+        if (inverseMass == 0.0f) continue;
+
+        const glm::vec3 &position = bodies.positions[slot];
+        const float radius = std::max(bodies.radii[slot], 1e-3f);
+        const float mass = 1.0f / inverseMass;
+        const float share = 1.0f / floater.sampleCount;
+        const float fullBuoyancy = mass * gravity / floater.relativeDensity * share;
+
+        glm::vec3 force(0.0f), normal(0.0f);
+        float submerged = 0.0f, waterLevel = 0.0f;
+        for (uint32_t i = floater.firstSample; i < floater.firstSample + floater.sampleCount; i++) {
+            waterLevel += waterHeight[i] * share;
+
+            // Water level along the point's column [y - radius, y + radius]
+            float bottom = position.y + offsets[i].y - radius;
+            float depth = glm::clamp((waterHeight[i] - bottom) / (2.0f * radius), 0.0f, 1.0f);
+            if (depth == 0.0f) continue;
+
+            const glm::vec3 &n = waterNormal[i];
+            float lift = fullBuoyancy * depth;
+            force += up * lift + glm::vec3(n.x, 0.0f, n.z) * (lift * waveDrift);
+            normal += n * depth;
+            submerged += depth * share;
+        }
+
+        // Rise and fall of the water along the body's path since the last step
+        float waterSpeed = floater.hasWaterLevel ? (waterLevel - floater.waterLevel) / std::max(deltaTime, 1e-6f) : 0.0f;
+        floater.waterLevel = waterLevel;
+        floater.hasWaterLevel = true;
+
+        floater.submerged = submerged;
+        floater.surfaceNormal = submerged > 0.0f ? glm::normalize(normal) : up;
+        if (submerged == 0.0f) continue;
+
+        // Drag proportional to the submerged part, never more than stops the body in one step
+        const float limit = 1.0f / std::max(deltaTime, 1e-6f);
+        const glm::vec3 &velocity = bodies.velocities[slot];
+        glm::vec3 vertical = up * glm::dot(velocity, up);
+        glm::vec3 relative = vertical - up * waterSpeed;
+        force -= (velocity - vertical) * (mass * std::min(waterDrag * submerged, limit));
+        force -= relative * (mass * std::min(heaveDrag * submerged, limit));
+
+        bodies.forces[slot] += force;
+        bodies.wake(floater.body);
+    }
+}
+
+// ===================== Benchmark =========================
+
+void Buoyancy::benchmark(const Ocean &ocean, int floaterCount, int samplesPerFloater) {
+    const int count = floaterCount * samplesPerFloater;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> position(-400.0f, 400.0f);
+
+    std::vector<float> xs(count), zs(count), scalar(count), batched(count);
+    std::vector<glm::vec3> normals(count);
+    for (int i = 0; i < count; i++) {
+        xs[i] = position(rng);
+        zs[i] = position(rng);
+    }
+
+    const int repeats = 20;
+    const float t = ocean.getTime();
+
+    float scalarMs = ppgso::averageTime(repeats, [&](int) {
+        for (int i = 0; i < count; i++) scalar[i] = ocean.getHeightAt(xs[i], zs[i], t);
+    });
+    float heightsMs = ppgso::averageTime(repeats, [&](int) { ocean.getHeightsAt(xs.data(), zs.data(), t, batched.data(), count); });
+    float normalsMs = ppgso::averageTime(repeats, [&](int) {
+        ocean.getHeightsAndNormalsAt(xs.data(), zs.data(), t, batched.data(), normals.data(), count);
+    });
+
+    float maxError = 0.0f;
+    for (int i = 0; i < count; i++) maxError = std::max(maxError, std::abs(scalar[i] - batched[i]));
+
+    std::cout << "Buoyancy wave query (" << floaterCount << " floaters, " << count << " samples): getHeightAt "
+              << scalarMs << " ms, batched heights " << heightsMs << " ms ("
+              << scalarMs / std::max(heightsMs, 1e-6f) << "x), with normals " << normalsMs
+              << " ms (max difference " << maxError << ")\n";
+}
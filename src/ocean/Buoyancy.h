@@ -0,0 +1,99 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "../physics/physics_world.h"
+
+class Ocean;
+
+/*!
+ * Buoyancy and water drag for rigid bodies floating on the Ocean.
+ *
+ * Every floating body has a few sample points (offsets from its centre, e.g. the
+ * corners of a hull). Each point carries an equal share of the body's volume as a
+ * column of the body's diameter, so the submerged share of a point is how far the
+ * water at that point reaches up the column. The force of a point is
+ * mass * g / relativeDensity * share * submerged, so a body with relative density
+ * 0.5 floats half submerged whatever its mass.
+ *
+ * The forces are added by a ForceSystem generator at the start of every physics step.
+ * The sample points of all bodies are gathered into one array and the water heights
+ * and normals for all of them come from a single batched Ocean query, so hundreds of
+ * floating bodies cost one vectorized wave evaluation per step. The ocean time only
+ * advances once per frame, so every step samples the waves at its own time: the ocean
+ * time of the previous frame plus the steps taken since, which requires the Ocean to be
+ * updated before the physics world. The spectral model only has the surface of the
+ * current frame and is sampled as is.
+ *
+ * Submerged points also push the body along the surface slope (waveDrift), which
+ * makes floating objects ride down the wave faces, and damp its velocity: horizontally
+ * against still water (waterDrag), vertically against the rise and fall of the water
+ * under the body (heaveDrag), so thin objects follow the surface instead of bouncing.
+ */
+class Buoyancy {
+public:
+    using Handle = ppgso::RigidBodyStore::Handle;
+
+    // Registers the force generator with world.forces, both have to outlive the world's steps
+    Buoyancy(const Ocean &ocean, ppgso::PhysicsWorld &world);
+    Buoyancy(const Buoyancy &) = delete;
+    Buoyancy &operator=(const Buoyancy &) = delete;
+
+    float waterDrag = 1.5f;     // Horizontal velocity fraction lost per second when fully submerged
+    float heaveDrag = 8.0f;     // Same for the vertical velocity relative to the water surface
+    float waveDrift = 0.3f;     // Push along the surface slope, relative to the buoyant force
+
+    // Makes a dynamic body float. samplePoints are offsets from the body centre,
+    // relativeDensity is body density / water density (below 1 floats).
+    void add(Handle body, const std::vector<glm::vec3> &samplePoints, float relativeDensity);
+    void remove(Handle body);
+    void clear();
+
+    int getFloaterCount() const { return (int)floaters.size(); }
+    int getSampleCount() const { return (int)offsets.size(); }
+
+    // State from the last step: average water normal under the submerged samples
+    // (up when dry) and the submerged fraction of the body (0 - 1)
+    glm::vec3 getSurfaceNormal(Handle body) const;
+    float getSubmergedFraction(Handle body) const;
+
+    // Duration of the last batched wave query in milliseconds
+    float getLastQueryTime() const { return lastQueryTime; }
+
+    // One wave query for all sample points, then buoyancy and drag forces (the generator)
+    void apply(ppgso::RigidBodyStore &bodies, float deltaTime);
+
+    // Compares one Ocean::getHeightAt call per sample point with the batched query
+    // for floaterCount bodies and prints both times
+    static void benchmark(const Ocean &ocean, int floaterCount = 500, int samplesPerFloater = 4);
+
+private:
+    const Ocean &ocean;
+    const ppgso::ForceSystem &forces;
+
+    struct Floater {
+        Handle body;
+        uint32_t firstSample, sampleCount;     // Range in offsets
+        float relativeDensity;
+        glm::vec3 surfaceNormal;
+        float submerged;
+        float waterLevel;                       // Mean water height under the samples, last step
+        bool hasWaterLevel;
+    };
+    std::vector<Floater> floaters;
+    std::vector<int> floaterOf;                 // Floater index by body handle or -1
+    std::vector<glm::vec3> offsets;             // Sample offsets of all floaters, in floater order
+
+    // Per step scratch, one entry per sample point
+    std::vector<float> sampleX, sampleZ, waterHeight;
+    std::vector<glm::vec3> waterNormal;
+    float lastQueryTime = 0.0f;
+
+    // Wave time of the steps: ocean time at the start of the frame and real time stepped since
+    float frameStart, frameEnd;
+    float frameElapsed = 0.0f;
+    float stepTime();
+
+    const Floater *find(Handle body) const;
+};
@@ -0,0 +1,78 @@
+#include "FFT.h"
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+FFT::FFT(int size) : size(size) {
+    if (size < 2 || (size & (size - 1)) != 0) {
+        throw std::runtime_error("FFT: size must be a power of two");
+    }
+
+    int bits = 0;
+    while ((1 << bits) < size) bits++;
+
+    bitReverse.resize(size);
+    for (int i = 0; i < size; i++) {
+        int r = 0;
+        for (int b = 0; b < bits; b++) {
+            if (i & (1 << b)) r |= 1 << (bits - 1 - b);
+        }
+        bitReverse[i] = r;
+    }
+
+    twiddles.resize(size / 2);
+    for (int k = 0; k < size / 2; k++) {
+        double angle = -2.0 * M_PI * k / size;
+        twiddles[k] = {(float)std::cos(angle), (float)std::sin(angle)};
+    }
+}
+
+void FFT::transform(std::complex<float> *data, bool inverse) const {
+    for (int i = 0; i < size; i++) {
+        int r = bitReverse[i];
+        if (i < r) std::swap(data[i], data[r]);
+    }
+
+    // Butterflies, the products are written out to avoid the NaN checks of
+    // std::complex multiplication
+    for (int length = 2; length <= size; length *= 2) {
+        const int half = length / 2;
+        const int step = size / length;
+
+        for (int start = 0; start < size; start += length) {
+            for (int j = 0; j < half; j++) {
+                const std::complex<float> &w = twiddles[j * step];
+                float wr = w.real();
+                float wi = inverse ? -w.imag() : w.imag();
+
+                std::complex<float> &a = data[start + j];
+                std::complex<float> &b = data[start + j + half];
+                float br = b.real() * wr - b.imag() * wi;
+                float bi = b.real() * wi + b.imag() * wr;
+
+                b = {a.real() - br, a.imag() - bi};
+                a = {a.real() + br, a.imag() + bi};
+            }
+        }
+    }
+}
+
+void FFT::transform2D(std::complex<float> *data, bool inverse, bool parallel) const {
+    #pragma omp parallel for schedule(static) if(parallel)
+    for (int row = 0; row < size; row++) {
+        transform(data + (size_t)row * size, inverse);
+    }
+
+    // Columns are gathered into a contiguous buffer so the butterflies stay cache friendly
+    #pragma omp parallel if(parallel)
+    {
+        std::vector<std::complex<float>> column(size);
+
+        #pragma omp for schedule(static)
+        for (int col = 0; col < size; col++) {
+            for (int row = 0; row < size; row++) column[row] = data[(size_t)row * size + col];
+            transform(column.data(), inverse);
+            for (int row = 0; row < size; row++) data[(size_t)row * size + col] = column[row];
+        }
+    }
+}
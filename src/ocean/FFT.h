@@ -0,0 +1,30 @@
+#pragma once
+
+#include <complex>
+#include <vector>
+
+/*!
+ * Iterative radix-2 complex FFT for one fixed power of two size.
+ *
+ * Bit reversal indices and twiddle factors are computed once in the constructor.
+ * The forward transform uses e^(-2 pi i nk / N), the inverse e^(+2 pi i nk / N);
+ * neither is scaled by 1 / N, so the inverse directly sums spectral components.
+ */
+class FFT {
+public:
+    explicit FFT(int size);
+
+    int getSize() const { return size; }
+
+    // In place transform of `size` contiguous values
+    void transform(std::complex<float> *data, bool inverse) const;
+
+    // In place transform of a size x size row-major grid: rows first, then
+    // columns, each pass optionally spread across OpenMP threads
+    void transform2D(std::complex<float> *data, bool inverse, bool parallel = true) const;
+
+private:
+    int size;
+    std::vector<int> bitReverse;
+    std::vector<std::complex<float>> twiddles;   // e^(-2 pi i k / N) for k < N / 2
+};
@@ -0,0 +1,207 @@
+#include "FloatingObjects.h"
+#include "Ocean.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <utility>
+
+#include <shaders/floating_vert_glsl.h>
+#include <shaders/floating_frag_glsl.h>
+
+// Static member initialization
+std::unique_ptr<ppgso::Shader> FloatingObjects::shader;
+int FloatingObjects::instanceCount = 0;
+
+namespace {
+    struct KindSettings {
+        const char *name;
+        glm::vec3 size;             // Box dimensions in metres
+        float relativeDensity;      // To water, also the submerged part at rest
+        glm::vec3 color;
+        float spin;                 // Largest turn rate (radians per second)
+    };
+
+    const KindSettings KINDS[] = {
+        {"debris", {1.8f, 0.2f, 0.4f}, 0.6f, {0.45f, 0.3f, 0.15f}, 0.0f},
+        {"crates", {0.9f, 0.9f, 0.9f}, 0.5f, {0.7f, 0.55f, 0.3f}, 0.0f},
+        {"boats", {4.0f, 0.8f, 1.6f}, 0.3f, {0.85f, 0.25f, 0.2f}, 0.0f},
+        {"leaves", {0.5f, 0.03f, 0.3f}, 0.25f, {0.25f, 0.6f, 0.15f}, 1.5f},
+    };
+
+    const float WATER_DENSITY = 1000.0f;
+    const float MIN_RADIUS = 0.1f;          // Thinner bodies would need a shorter time step
+    const float MIN_WATER_DEPTH = 2.0f;     // Spawn only where the sea floor is at least this deep
+    const float SPAWN_INNER = 400.0f;       // Ring around the island centre where objects are dropped
+    const float SPAWN_OUTER = 650.0f;       // Cut down to the ocean and ground edges
+    const float EDGE_MARGIN = 20.0f;        // Room to drift before reaching the edge of the water
+
+    // First attribute location of the instance matrix (floating_vert.glsl)
+    const GLuint INSTANCE_LOCATION = 3;
+}
+
+FloatingObjects::FloatingObjects(const Ocean &ocean, std::shared_ptr<HeightfieldCollider> ground)
+    : ocean(ocean), ground(std::move(ground)), buoyancy(ocean, world) {
+
+    instanceCount++;
+    if (!shader) {
+        shader = std::make_unique<ppgso::Shader>(floating_vert_glsl, floating_frag_glsl);
+    }
+
+    // Floating objects wash up on the island and bump into each other
+    world.collisions.addCollider(this->ground);
+
+    mesh = std::make_unique<ppgso::Mesh>("cube.obj");
+    glGenBuffers(1, &instanceBuffer);
+}
+
+FloatingObjects::~FloatingObjects() {
+    glDeleteBuffers(1, &instanceBuffer);
+
+    instanceCount--;
+    if (instanceCount == 0) {
+        shader.reset();
+    }
+}
+
+void FloatingObjects::spawn(FloatingKind kind, int count) {
+    const KindSettings &settings = KINDS[(int)kind];
+    const glm::vec3 size = settings.size;
+    const float radius = std::max(0.5f * size.y, MIN_RADIUS);
+    const float mass = settings.relativeDensity * WATER_DENSITY * size.x * size.y * size.z;
+
+    std::mt19937 rng(1000 + spawned++);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    // Ring inside the drawn ocean square, its corners still reach past SPAWN_INNER
+    const float edge = 0.5f * ocean.getSize() - EDGE_MARGIN;
+    const float inner = std::min(SPAWN_INNER, edge);
+    const float outer = std::min(SPAWN_OUTER, edge * (float)M_SQRT2);
+
+    for (int i = 0; i < count; i++) {
+        // Random place on open water, a few tries to miss the island
+        glm::vec2 place(0.0f);
+        bool found = false;
+        for (int attempt = 0; attempt < 32 && !found; attempt++) {
+            float angle = unit(rng) * 2.0f * (float)M_PI;
+            float distance = std::sqrt(glm::mix(inner * inner, outer * outer, unit(rng)));
+            place = glm::vec2(std::cos(angle), std::sin(angle)) * distance;
+            found = std::abs(place.x) <= edge && std::abs(place.y) <= edge &&
+                    ground->contains(place.x, place.y, EDGE_MARGIN) &&
+                    ground->height(place.x, place.y) < -MIN_WATER_DEPTH;
+        }
+        if (!found) continue;
+
+        Object object;
+        object.kind = kind;
+        object.scale = size;
+        object.yaw = unit(rng) * 2.0f * (float)M_PI;
+        object.spin = (unit(rng) * 2.0f - 1.0f) * settings.spin;
+        // Starts at its calm water line, slightly lifted so it settles in with a splash
+        float restHeight = radius - 2.0f * radius * settings.relativeDensity;
+        object.body = world.bodies.create(glm::vec3(place.x, restHeight + 0.5f * unit(rng), place.y), radius, mass);
+        world.bodies.setRestitution(object.body, 0.1f);
+
+        // Hull corners (the body does not rotate, so they keep the spawn heading), leaves float on one point
+        std::vector<glm::vec3> samples;
+        if (kind == FloatingKind::LEAF) {
+            samples.push_back(glm::vec3(0.0f));
+        } else {
+            float c = std::cos(object.yaw), s = std::sin(object.yaw);
+            for (float dx : {-0.4f, 0.4f}) {
+                for (float dz : {-0.4f, 0.4f}) {
+                    glm::vec2 corner(dx * size.x, dz * size.z);
+                    samples.push_back(glm::vec3(c * corner.x + s * corner.y, 0.0f, -s * corner.x + c * corner.y));
+                }
+            }
+        }
+        buoyancy.add(object.body, samples, settings.relativeDensity);
+        objects.push_back(object);
+    }
+}
+
+void FloatingObjects::scatter(int count) {
+    spawn(FloatingKind::DEBRIS, count * 4 / 10);
+    spawn(FloatingKind::CRATE, count * 2 / 10);
+    spawn(FloatingKind::BOAT, count / 20);
+    spawn(FloatingKind::LEAF, count - count * 4 / 10 - count * 2 / 10 - count / 20);
+}
+
+void FloatingObjects::clear() {
+    buoyancy.clear();
+    world.bodies.clear();
+    objects.clear();
+}
+
+void FloatingObjects::update(float dt) {
+    // New terrain type -> new shore
+    ground->sync();
+    world.update(dt);
+
+    for (Object &object : objects) object.yaw += object.spin * dt;
+}
+
+void FloatingObjects::render(const glm::mat4 &view, const glm::mat4 &projection) {
+    if (objects.empty()) return;
+
+    // Instances sorted by kind, each kind is one draw from its range of the buffer
+    int counts[KIND_COUNT] = {0}, first[KIND_COUNT] = {0};
+    for (const Object &object : objects) counts[(int)object.kind]++;
+    for (int k = 1; k < KIND_COUNT; k++) first[k] = first[k - 1] + counts[k - 1];
+
+    instances.resize(objects.size());
+    int next[KIND_COUNT];
+    std::copy(first, first + KIND_COUNT, next);
+
+    const glm::vec3 up(0.0f, 1.0f, 0.0f);
+    for (const Object &object : objects) {
+        const KindSettings &settings = KINDS[(int)object.kind];
+        const float radius = world.bodies.radii[world.bodies.getSlot(object.body)];
+        const float height = object.scale.y;
+
+        // The box floats as deep as the body's column: same waterline for both at rest
+        float offset = -radius + 2.0f * radius * settings.relativeDensity - height * settings.relativeDensity + 0.5f * height;
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), world.getRenderPosition(object.body) + up * offset);
+
+        // Tilt with the water under the object
+        glm::vec3 normal = buoyancy.getSurfaceNormal(object.body);
+        glm::vec3 axis = glm::cross(up, normal);
+        float axisLength = glm::length(axis);
+        if (axisLength > 1e-4f) {
+            model = glm::rotate(model, std::atan2(axisLength, glm::dot(up, normal)), axis / axisLength);
+        }
+
+        model = glm::rotate(model, object.yaw, up);
+        instances[next[(int)object.kind]++] = glm::scale(model, object.scale);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(glm::mat4), instances.data(), GL_STREAM_DRAW);
+
+    shader->use();
+    shader->setUniform("viewMatrix", view);
+    shader->setUniform("projectionMatrix", projection);
+
+    for (int k = 0; k < KIND_COUNT; k++) {
+        if (counts[k] == 0) continue;
+        shader->setUniform("color", KINDS[k].color);
+        mesh->setInstanceBuffer(instanceBuffer, INSTANCE_LOCATION, first[k] * sizeof(glm::mat4));
+        mesh->renderInstanced(counts[k]);
+    }
+}
+
+void FloatingObjects::printStats() const {
+    int counts[KIND_COUNT] = {0}, afloat = 0;
+    for (const Object &object : objects) {
+        counts[(int)object.kind]++;
+        afloat += buoyancy.getSubmergedFraction(object.body) > 0.0f;
+    }
+
+    const auto &stats = world.getStats();
+    std::cout << "Floating objects: " << objects.size() << " (";
+    for (int k = 0; k < KIND_COUNT; k++) std::cout << (k ? ", " : "") << counts[k] << " " << KINDS[k].name;
+    std::cout << "), " << afloat << " afloat, " << buoyancy.getSampleCount() << " wave samples\n"
+              << "  Wave query: " << buoyancy.getLastQueryTime() << " ms, physics step: " << stats.stepMs
+              << " ms (" << stats.awake << " awake, " << stats.contacts << " contacts)\n";
+}
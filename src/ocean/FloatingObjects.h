@@ -0,0 +1,77 @@
+#pragma once
+
+#include <ppgso/ppgso.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+#include "Buoyancy.h"
+#include "../physics/physics_world.h"
+#include "../terrain/HeightfieldCollider.h"
+
+class Ocean;
+
+enum class FloatingKind {
+    DEBRIS,     // Planks
+    CRATE,
+    BOAT,
+    LEAF
+};
+
+/*!
+ * Objects drifting on the ocean around the island.
+ *
+ * Every object is a rigid body of its own physics world: Buoyancy keeps it on the
+ * waves (hull corners as sample points, a single point for leaves) and the terrain
+ * heightfield lets it wash up on the shore. Bodies are spheres with the height of the
+ * object, the sample points spread the buoyancy over its footprint and the drawn box
+ * tilts with the water under it.
+ *
+ * Drawn as unit cubes, one instanced draw per kind.
+ */
+class FloatingObjects {
+public:
+    // ground is the island terrain, shared with other users of its collider
+    FloatingObjects(const Ocean &ocean, std::shared_ptr<HeightfieldCollider> ground);
+    ~FloatingObjects();
+
+    // Drops count objects at random places on open water near the island
+    void spawn(FloatingKind kind, int count);
+
+    // Mix of every kind, mostly debris and leaves
+    void scatter(int count);
+    void clear();
+
+    void update(float dt);
+    void render(const glm::mat4 &view, const glm::mat4 &projection);
+
+    int getObjectCount() const { return (int)objects.size(); }
+    void printStats() const;
+
+    ppgso::PhysicsWorld &getWorld() { return world; }
+    Buoyancy &getBuoyancy() { return buoyancy; }
+
+private:
+    const Ocean &ocean;
+    ppgso::PhysicsWorld world;
+    std::shared_ptr<HeightfieldCollider> ground;
+    Buoyancy buoyancy;
+    uint32_t spawned = 0;                       // Seed for the next spawn
+
+    struct Object {
+        ppgso::RigidBodyStore::Handle body;
+        FloatingKind kind;
+        glm::vec3 scale;
+        float yaw, spin;                        // Heading and its change per second (radians)
+    };
+    std::vector<Object> objects;
+
+    // Rendering, instance matrices grouped by kind
+    static const int KIND_COUNT = 4;
+    std::unique_ptr<ppgso::Mesh> mesh;
+    GLuint instanceBuffer = 0;
+    std::vector<glm::mat4> instances;
+
+    static std::unique_ptr<ppgso::Shader> shader;
+    static int instanceCount;
+};
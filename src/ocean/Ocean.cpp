@@ -2,6 +2,9 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <random>
 #include <cmath>
+#include <iostream>
+#include <algorithm>
+#include <ppgso/timing.h>
 
 #include <shaders/ocean_vert_glsl.h>
 #include <shaders/ocean_frag_glsl.h>
@@ -17,7 +20,10 @@ Ocean::Ocean(float size, int resolution, float waveHeight)
 
     // Initialize shader only once
     if (!shader) {
-        shader = std::make_unique<ppgso::Shader>(ocean_vert_glsl, ocean_frag_glsl);
+        // Displaced surface can be captured with transform feedback for verification
+        shader = std::make_unique<ppgso::Shader>(ocean_vert_glsl, ocean_frag_glsl,
+                                                 std::vector<std::string>{"fragPosition", "fragNormal"});
+        shader->setUniformBlockBinding("OceanWaves", WAVE_BLOCK_BINDING);
     }
 
     // Initialize wave parameters
@@ -25,6 +31,15 @@ Ocean::Ocean(float size, int resolution, float waveHeight)
 
     // Generate initial mesh
     generateMesh();
+    updateSurface();
+
+#ifndef NDEBUG
+    // Wave bank must agree with the per-vertex wave functions
+    float bankError = measureWaveBankError();
+    if (bankError > WAVE_BANK_TOLERANCE) {
+        std::cerr << "Ocean: wave bank deviates from reference waves by " << bankError << "\n";
+    }
+#endif
 
     // Setup OpenGL buffers
     glGenVertexArrays(1, &vao);
@@ -61,6 +76,12 @@ Ocean::Ocean(float size, int resolution, float waveHeight)
                  indices.data(), GL_STATIC_DRAW);
 
     indexCount = indices.size();
+
+    // UBO: wave parameters for GPU displacement
+    glGenBuffers(1, &waveUbo);
+    glBindBuffer(GL_UNIFORM_BUFFER, waveUbo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(WaveBlock), nullptr, GL_DYNAMIC_DRAW);
+    uploadWaves();
 }
 
 Ocean::~Ocean() {
@@ -69,6 +90,10 @@ Ocean::~Ocean() {
     glDeleteBuffers(1, &nbo);
     glDeleteBuffers(1, &tbo);
     glDeleteBuffers(1, &ebo);
+    glDeleteBuffers(1, &waveUbo);
+    glDeleteVertexArrays(1, &gridVao);
+    glDeleteBuffers(1, &gridVbo);
+    glDeleteBuffers(1, &gridEbo);
 
     instanceCount--;
 
@@ -103,6 +128,62 @@ void Ocean::initializeWaves() {
             glm::vec2(cos(angle), sin(angle))
         });
     }
+
+    waveBank.clear();
+    for (const auto &wave : waves) {
+        waveBank.addWave(wave.wavelength, wave.amplitude, wave.speed, wave.direction);
+    }
+    waveBank.setScales(waveHeight, waveSpeed);
+    wavesDirty = true;
+}
+
+void Ocean::setWaveSpeed(float speed) {
+    waveSpeed = speed;
+    waveBank.setScales(waveHeight, waveSpeed);
+    wavesDirty = true;
+}
+
+void Ocean::setWaveHeight(float height) {
+    waveHeight = height;
+    waveBank.setScales(waveHeight, waveSpeed);
+    wavesDirty = true;
+
+    if (spectral) spectral->setHeightScale(waveHeight);
+}
+
+void Ocean::setWaveModel(WaveModel model) {
+    waveModel = model;
+
+    if (waveModel == WaveModel::SPECTRAL) {
+        if (!spectral) {
+            spectral = std::make_unique<SpectralOcean>(spectrumSettings);
+            spectral->setHeightScale(waveHeight);
+        }
+        updateSpectral();
+
+#ifndef NDEBUG
+        // FFT maps must agree with a direct sum over the spectrum
+        float spectralError = spectral->measureError();
+        if (spectralError > SpectralOcean::TOLERANCE) {
+            std::cerr << "Ocean: FFT heights deviate from the spectral sum by " << spectralError << "\n";
+        }
+#endif
+    }
+
+    // Both models change the mesh outside of the GPU path, refresh it right away
+    updateMesh(0.0f);
+}
+
+void Ocean::setSpectrumSettings(const SpectrumSettings &settings) {
+    spectrumSettings = settings;
+    spectral.reset();
+
+    if (waveModel == WaveModel::SPECTRAL) setWaveModel(WaveModel::SPECTRAL);
+}
+
+void Ocean::updateSpectral() {
+    // Same time scaling as the Gerstner phases
+    spectral->update(time * waveSpeed);
 }
 
 float Ocean::gerstnerWaveHeight(float x, float z, float t) const {
@@ -137,7 +218,28 @@ glm::vec3 Ocean::gerstnerWaveNormal(float x, float z, float t) const {
 }
 
 float Ocean::getHeightAt(float worldX, float worldZ, float t) const {
-    return gerstnerWaveHeight(worldX, worldZ, t);
+    if (waveModel == WaveModel::SPECTRAL) return spectral->height(worldX, worldZ);
+    return waveBank.height(worldX, worldZ, t);
+}
+
+void Ocean::getHeightsAt(const float *worldX, const float *worldZ, float t, float *out, int count) const {
+    if (waveModel == WaveModel::SPECTRAL) {
+        for (int i = 0; i < count; i++) out[i] = spectral->height(worldX[i], worldZ[i]);
+        return;
+    }
+    waveBank.heights(worldX, worldZ, t, out, count);
+}
+
+void Ocean::getHeightsAndNormalsAt(const float *worldX, const float *worldZ, float t,
+                                   float *outHeight, glm::vec3 *outNormal, int count) const {
+    if (waveModel == WaveModel::SPECTRAL) {
+        for (int i = 0; i < count; i++) {
+            outHeight[i] = spectral->height(worldX[i], worldZ[i]);
+            outNormal[i] = spectral->normal(worldX[i], worldZ[i]);
+        }
+        return;
+    }
+    waveBank.heightsAndNormals(worldX, worldZ, t, outHeight, outNormal, count);
 }
 
 void Ocean::generateMesh() {
@@ -146,6 +248,10 @@ void Ocean::generateMesh() {
     uvs.clear();
     indices.clear();
 
+    // Grid coordinates shared by every row / column, used by the wave bank
+    gridX.resize(resolution + 1);
+    gridZ.resize(resolution + 1);
+
     // Generate flat grid (will be displaced in update)
     for (int z = 0; z <= resolution; z++) {
         for (int x = 0; x <= resolution; x++) {
@@ -155,6 +261,8 @@ void Ocean::generateMesh() {
             float wz = (fz - 0.5f) * size;
 
             positions.push_back({wx, 0.0f, wz});
+            gridX[x] = wx;
+            gridZ[z] = wz;
             normals.push_back({0.0f, 1.0f, 0.0f});
             uvs.push_back({fx * 10.0f, fz * 10.0f}); // Repeat texture
         }
@@ -174,27 +282,86 @@ void Ocean::generateMesh() {
     }
 }
 
-void Ocean::updateMesh(float dt) {
-    // Update vertex positions based on Gerstner waves
+void Ocean::updateSurface() {
+    if (waveModel == WaveModel::SPECTRAL) {
+        // Heights and normals sampled from the FFT maps of the last spectral update
+        spectral->sampleGrid(gridX.data(), resolution + 1, gridZ.data(), resolution + 1,
+                             &positions[0].y, 3, normals.data());
+        return;
+    }
+
+    // Heights and analytic normals from the wave bank, rows spread across threads. Normals
+    // differenced from the mesh would alias the waves shorter than a few grid cells.
+    waveBank.gridHeightsAndNormals(gridX.data(), resolution + 1, gridZ.data(), resolution + 1,
+                                   time, &positions[0].y, 3, normals.data());
+}
+
+void Ocean::updateSurfaceReference() {
+    // Original per-vertex loop, kept as the reference for benchmarkUpdate
     for (int z = 0; z <= resolution; z++) {
         for (int x = 0; x <= resolution; x++) {
             int idx = z * (resolution + 1) + x;
-            
+
             float fx = (float)x / resolution;
             float fz = (float)z / resolution;
             float wx = (fx - 0.5f) * size;
             float wz = (fz - 0.5f) * size;
-            
-            // Calculate wave height
-            float height = gerstnerWaveHeight(wx, wz, time);
-            
-            // Update position
-            positions[idx].y = height;
-            
-            // Calculate normal
+
+            positions[idx].y = gerstnerWaveHeight(wx, wz, time);
             normals[idx] = gerstnerWaveNormal(wx, wz, time);
         }
     }
+}
+
+float Ocean::measureWaveBankError() const {
+    const int columns = resolution + 1;
+    float maxError = 0.0f;
+
+    std::vector<float> xs(columns), zs(columns), heights(columns);
+    std::vector<glm::vec3> bankNormals(columns);
+
+    // Every grid row, compared with the scalar reference functions
+    for (int z = 0; z <= resolution; z++) {
+        std::fill(zs.begin(), zs.end(), gridZ[z]);
+        waveBank.heightsAndNormals(gridX.data(), zs.data(), time, heights.data(), bankNormals.data(), columns, false);
+
+        for (int x = 0; x <= resolution; x++) {
+            maxError = std::max(maxError, std::abs(heights[x] - gerstnerWaveHeight(gridX[x], gridZ[z], time)));
+            maxError = std::max(maxError, glm::length(bankNormals[x] - gerstnerWaveNormal(gridX[x], gridZ[z], time)));
+        }
+    }
+
+    return maxError;
+}
+
+void Ocean::benchmarkUpdate(int iterations) {
+    if (waveModel == WaveModel::SPECTRAL) {
+        std::cout << "Ocean update benchmark compares Gerstner wave updates, switch the wave model first\n";
+        return;
+    }
+
+    auto timeUpdates = [&](void (Ocean::*update)()) {
+        return ppgso::averageTime(iterations, [&](int) { (this->*update)(); });
+    };
+
+    // Both produce heights and analytic normals, the difference shows it is the same work
+    float reference = timeUpdates(&Ocean::updateSurfaceReference);
+    std::vector<glm::vec3> referencePositions = positions, referenceNormals = normals;
+    float bank = timeUpdates(&Ocean::updateSurface);
+
+    float maxError = 0.0f;
+    for (size_t i = 0; i < positions.size(); i++) {
+        maxError = std::max(maxError, std::abs(positions[i].y - referencePositions[i].y));
+        maxError = std::max(maxError, glm::length(normals[i] - referenceNormals[i]));
+    }
+
+    std::cout << "Ocean update (" << positions.size() << " vertices, heights and normals): reference loop "
+              << reference << " ms, wave bank " << bank << " ms ("
+              << reference / std::max(bank, 1e-6f) << "x, max difference " << maxError << ")\n";
+}
+
+void Ocean::updateMesh(float dt) {
+    updateSurface();
 
     // Update GPU buffers
     glBindVertexArray(vao);
@@ -212,7 +379,156 @@ void Ocean::updateMesh(float dt) {
 
 void Ocean::update(float dt) {
     time += dt * waveFrequency;
-    updateMesh(dt);
+
+    if (waveModel == WaveModel::SPECTRAL) {
+        // O(N log N) in the spectrum size, then a cheap resample onto the mesh
+        updateSpectral();
+        updateMesh(dt);
+    } else if (usesGpuWaves()) {
+        // Constant CPU cost, only parameter changes touch the GPU
+        if (wavesDirty) uploadWaves();
+    } else {
+        updateMesh(dt);
+    }
+}
+
+void Ocean::setGpuDisplacement(bool enabled) {
+    gpuDisplacement = enabled;
+
+#ifndef NDEBUG
+    if (enabled) {
+        float gpuError = measureGpuError();
+        if (gpuError > GPU_TOLERANCE) {
+            std::cerr << "Ocean: GPU waves deviate from CPU waves by " << gpuError << "\n";
+        }
+    }
+#endif
+}
+
+bool Ocean::usesGpuWaves() const {
+    return waveModel == WaveModel::GERSTNER && (gpuDisplacement || projectedGrid);
+}
+
+void Ocean::setProjectedGrid(bool enabled) {
+    projectedGrid = enabled;
+    if (projectedGrid && !gridVao) generateProjectedGrid();
+}
+
+void Ocean::setProjectedGridResolution(int columns, int rows) {
+    gridColumns = std::max(columns, 1);
+    gridRows = std::max(rows, 1);
+    if (gridVao) generateProjectedGrid();
+}
+
+void Ocean::generateProjectedGrid() {
+    // Screen positions (NDC) slightly past the screen edges, projected by the vertex shader
+    std::vector<glm::vec3> gridPositions;
+    gridPositions.reserve((size_t)(gridColumns + 1) * (gridRows + 1));
+    const float extent = 1.0f + GRID_MARGIN;
+
+    for (int y = 0; y <= gridRows; y++) {
+        for (int x = 0; x <= gridColumns; x++) {
+            gridPositions.push_back({(2.0f * x / gridColumns - 1.0f) * extent,
+                                     (2.0f * y / gridRows - 1.0f) * extent, 0.0f});
+        }
+    }
+
+    std::vector<unsigned int> gridIndices;
+    gridIndices.reserve((size_t)gridColumns * gridRows * 6);
+    for (int y = 0; y < gridRows; y++) {
+        for (int x = 0; x < gridColumns; x++) {
+            unsigned int i0 = y * (gridColumns + 1) + x;
+            unsigned int i1 = i0 + 1;
+            unsigned int i2 = i0 + (gridColumns + 1);
+            unsigned int i3 = i2 + 1;
+
+            gridIndices.push_back(i0); gridIndices.push_back(i1); gridIndices.push_back(i2);
+            gridIndices.push_back(i1); gridIndices.push_back(i3); gridIndices.push_back(i2);
+        }
+    }
+
+    if (!gridVao) {
+        glGenVertexArrays(1, &gridVao);
+        glGenBuffers(1, &gridVbo);
+        glGenBuffers(1, &gridEbo);
+    }
+    glBindVertexArray(gridVao);
+
+    // Only positions, normals and texture coordinates come from the shader
+    glBindBuffer(GL_ARRAY_BUFFER, gridVbo);
+    glBufferData(GL_ARRAY_BUFFER, gridPositions.size() * sizeof(glm::vec3),
+                 gridPositions.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gridEbo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, gridIndices.size() * sizeof(unsigned int),
+                 gridIndices.data(), GL_STATIC_DRAW);
+    gridIndexCount = gridIndices.size();
+}
+
+void Ocean::uploadWaves() {
+    static_assert(sizeof(GpuWave) == 32, "GpuWave must match the std140 layout of Wave");
+    static_assert(sizeof(WaveBlock) == MAX_GPU_WAVES * 32 + 16, "WaveBlock must match the std140 layout of OceanWaves");
+
+    WaveBlock block = {};
+    block.waveCount = (int)std::min(waves.size(), (size_t)MAX_GPU_WAVES);
+
+    for (int i = 0; i < block.waveCount; i++) {
+        const Wave &wave = waves[i];
+        block.waves[i].direction = wave.direction;
+        block.waves[i].k = 2.0f * M_PI / wave.wavelength;
+        block.waves[i].speed = wave.speed * waveSpeed;
+        block.waves[i].amplitude = wave.amplitude * waveHeight;
+    }
+
+    glBindBuffer(GL_UNIFORM_BUFFER, waveUbo);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(WaveBlock), &block);
+    wavesDirty = false;
+}
+
+float Ocean::measureGpuError() {
+    if (wavesDirty) uploadWaves();
+
+    // Run the vertex shader over the grid points and capture fragPosition / fragNormal
+    const size_t count = positions.size();
+    GLuint feedback = 0;
+    glGenBuffers(1, &feedback);
+    glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, feedback);
+    glBufferData(GL_TRANSFORM_FEEDBACK_BUFFER, count * 2 * sizeof(glm::vec3), nullptr, GL_STATIC_READ);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, feedback);
+
+    shader->use();
+    shader->setUniform("modelMatrix", glm::mat4(1.0f));
+    shader->setUniform("viewMatrix", glm::mat4(1.0f));
+    shader->setUniform("projectionMatrix", glm::mat4(1.0f));
+    shader->setUniform("gpuDisplacement", true);
+    shader->setUniform("projectedGrid", false);
+    shader->setUniform("time", time);
+    glBindBufferBase(GL_UNIFORM_BUFFER, WAVE_BLOCK_BINDING, waveUbo);
+
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBindVertexArray(vao);
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, (GLsizei)count);
+    glEndTransformFeedback();
+    glDisable(GL_RASTERIZER_DISCARD);
+
+    std::vector<glm::vec3> captured(count * 2);
+    glGetBufferSubData(GL_TRANSFORM_FEEDBACK_BUFFER, 0, captured.size() * sizeof(glm::vec3), captured.data());
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glDeleteBuffers(1, &feedback);
+
+    float maxError = 0.0f;
+    for (size_t i = 0; i < count; i++) {
+        const glm::vec3 &p = captured[2 * i];
+        const glm::vec3 &n = captured[2 * i + 1];
+
+        maxError = std::max(maxError, std::abs(p.y - gerstnerWaveHeight(p.x, p.z, time)));
+        maxError = std::max(maxError, glm::length(n - gerstnerWaveNormal(p.x, p.z, time)));
+    }
+
+    return maxError;
 }
 
 void Ocean::render(const glm::mat4 &view, const glm::mat4 &projection) {
@@ -228,6 +544,19 @@ void Ocean::render(const glm::mat4 &view, const glm::mat4 &projection) {
     shader->setUniform("foamColor", foamColor);
     shader->setUniform("transparency", transparency);
     shader->setUniform("time", time);
+    shader->setUniform("gpuDisplacement", usesGpuWaves());
+    glBindBufferBase(GL_UNIFORM_BUFFER, WAVE_BLOCK_BINDING, waveUbo);
+
+    // Projected grid follows the camera, the regular mesh stays where it is
+    bool drawProjected = projectedGrid && waveModel == WaveModel::GERSTNER;
+    shader->setUniform("projectedGrid", drawProjected);
+    if (drawProjected) {
+        const float extent = 2.0f * (1.0f + GRID_MARGIN);
+        shader->setUniform("inverseViewProjection", glm::inverse(projection * view));
+        shader->setUniform("gridStep", glm::vec2(extent / gridColumns, extent / gridRows));
+        shader->setUniform("viewDistance", viewDistance);
+        shader->setUniform("surfaceSize", size);
+    }
     
     // Enable blending for transparency
     glEnable(GL_BLEND);
@@ -236,8 +565,13 @@ void Ocean::render(const glm::mat4 &view, const glm::mat4 &projection) {
     // Disable depth writing (but keep depth testing)
     glDepthMask(GL_FALSE);
     
-    glBindVertexArray(vao);
-    glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr);
+    if (drawProjected) {
+        glBindVertexArray(gridVao);
+        glDrawElements(GL_TRIANGLES, gridIndexCount, GL_UNSIGNED_INT, nullptr);
+    } else {
+        glBindVertexArray(vao);
+        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr);
+    }
     
     // Restore depth writing
     glDepthMask(GL_TRUE);
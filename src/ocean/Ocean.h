@@ -2,9 +2,16 @@
 
 #include <ppgso/ppgso.h>
 #include <glm/glm.hpp>
+#include "WaveBank.h"
+#include "SpectralOcean.h"
 #include <vector>
 #include <memory>
 
+enum class WaveModel {
+    GERSTNER,   // Sum of a few hand-picked directional waves
+    SPECTRAL    // FFT ocean with thousands of components drawn from a wave spectrum
+};
+
 class Ocean {
 public:
     // Constructor
@@ -18,18 +25,65 @@ public:
     void render(const glm::mat4 &view, const glm::mat4 &projection);
 
     // Wave parameters
-    void setWaveSpeed(float speed) { waveSpeed = speed; }
-    void setWaveHeight(float height) { waveHeight = height; }
+    void setWaveSpeed(float speed);
+    void setWaveHeight(float height);
     void setWaveFrequency(float freq) { waveFrequency = freq; }
+    float getWaveFrequency() const { return waveFrequency; }
+    float getSize() const { return size; }
 
     // Visual parameters
     void setWaterColor(const glm::vec3& color) { waterColor = color; }
     void setFoamColor(const glm::vec3& color) { foamColor = color; }
     void setTransparency(float alpha) { transparency = alpha; }
 
+    // Displace the static grid in the vertex shader instead of updating it on the CPU
+    // every frame. getHeightAt keeps working for CPU queries in both modes.
+    void setGpuDisplacement(bool enabled);
+    bool isGpuDisplacement() const { return gpuDisplacement; }
+
+    // The spectral surface is always displaced on the CPU from its FFT maps, GPU
+    // displacement only applies to the Gerstner waves. Height queries in spectral
+    // mode sample the most recent update, so their time argument is not used.
+    void setWaveModel(WaveModel model);
+    WaveModel getWaveModel() const { return waveModel; }
+    void setSpectrumSettings(const SpectrumSettings &settings);
+    const SpectralOcean *getSpectralOcean() const { return spectral.get(); }
+
+    // Screen-space projected grid: a fixed grid of vertices spread over the screen is
+    // projected onto the sea plane in the vertex shader, so vertex density follows the
+    // view and the ocean reaches the view distance at a constant vertex count. Displaced
+    // with the GPU Gerstner waves; the spectral model keeps drawing the regular mesh.
+    void setProjectedGrid(bool enabled);
+    bool isProjectedGrid() const { return projectedGrid; }
+    void setProjectedGridResolution(int columns, int rows);
+    void setViewDistance(float distance) { viewDistance = distance; }
+    int getProjectedGridVertexCount() const { return (gridColumns + 1) * (gridRows + 1); }
+
     // Get height at position (for foam/intersection detection)
     float getHeightAt(float worldX, float worldZ, float time) const;
 
+    // Batched queries for simulation, `count` points given as separate x/z arrays
+    void getHeightsAt(const float *worldX, const float *worldZ, float time, float *out, int count) const;
+    void getHeightsAndNormalsAt(const float *worldX, const float *worldZ, float time,
+                                float *outHeight, glm::vec3 *outNormal, int count) const;
+
+    float getTime() const { return time; }
+    const WaveBank &getWaveBank() const { return waveBank; }
+
+    // Largest difference between the wave bank and the per-vertex reference functions
+    float measureWaveBankError() const;
+    static constexpr float WAVE_BANK_TOLERANCE = 1e-3f;
+
+    // Times the per-vertex reference surface update against the wave bank update (Gerstner
+    // waves, heights and normals on both sides) and prints both (milliseconds per update,
+    // CPU side only) with the largest difference between their results
+    void benchmarkUpdate(int iterations = 20);
+
+    // Largest difference between the surface displaced by the vertex shader (read back
+    // with transform feedback) and the CPU wave functions, heights and normals
+    float measureGpuError();
+    static constexpr float GPU_TOLERANCE = 1e-3f;
+
 private:
     // Mesh data
     std::vector<glm::vec3> positions;
@@ -63,14 +117,56 @@ private:
     };
     std::vector<Wave> waves;
 
+    // Precomputed SoA copy of the waves used by every CPU evaluation
+    WaveBank waveBank;
+    std::vector<float> gridX, gridZ;
+
+    // std140 mirror of the OceanWaves uniform block in ocean_vert.glsl
+    static const int MAX_GPU_WAVES = 16;
+    static const GLuint WAVE_BLOCK_BINDING = 0;
+    struct GpuWave {
+        glm::vec2 direction;
+        float k;
+        float speed;
+        float amplitude;
+        float padding[3];
+    };
+    struct WaveBlock {
+        GpuWave waves[MAX_GPU_WAVES];
+        int waveCount;
+        float padding[3];
+    };
+
+    bool gpuDisplacement = false;
+    bool wavesDirty = true;
+    GLuint waveUbo = 0;
+    void uploadWaves();
+
+    // Spectral wave model, created on first use
+    WaveModel waveModel = WaveModel::GERSTNER;
+    SpectrumSettings spectrumSettings;
+    std::unique_ptr<SpectralOcean> spectral;
+    void updateSpectral();
+
+    // Projected grid, built on first use
+    bool projectedGrid = false;
+    int gridColumns = 200, gridRows = 150;
+    float viewDistance = 5000.0f;
+    static constexpr float GRID_MARGIN = 0.1f;  // NDC overscan so displaced waves never uncover the screen edges
+    GLuint gridVao = 0, gridVbo = 0, gridEbo = 0;
+    size_t gridIndexCount = 0;
+    void generateProjectedGrid();
+    bool usesGpuWaves() const;
+
     void initializeWaves();
     float gerstnerWaveHeight(float x, float z, float t) const;
     glm::vec3 gerstnerWaveNormal(float x, float z, float t) const;
 
     // Mesh generation
     void generateMesh();
+    void updateSurface();
+    void updateSurfaceReference();
     void updateMesh(float dt);
-    void computeNormals();
 
     // Shader (shared across all ocean instances)
     static std::unique_ptr<ppgso::Shader> shader;
@@ -0,0 +1,236 @@
+#include "SpectralOcean.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+static const float GRAVITY = 9.81f;
+
+SpectralOcean::SpectralOcean(const SpectrumSettings &settings)
+    : settings(settings), fft(settings.gridSize), n(settings.gridSize) {
+
+    const size_t count = (size_t)n * n;
+    h0.resize(count);
+    h0MinusConj.resize(count);
+    kx.resize(count);
+    kz.resize(count);
+    omega.resize(count);
+    heightSpectrum.resize(count);
+    slopeSpectrum.resize(count);
+    heightMap.resize(count);
+    normalMap.resize(count);
+
+    generateSpectrum();
+    update(0.0f);
+}
+
+// ===================== Initial spectrum =========================
+
+float SpectralOcean::spectrumDensity(float waveX, float waveZ) const {
+    float k = std::sqrt(waveX * waveX + waveZ * waveZ);
+    if (k < 1e-6f) return 0.0f;
+
+    glm::vec2 wind = glm::normalize(settings.windDirection);
+    float cosTheta = (waveX * wind.x + waveZ * wind.y) / k;
+    float windSpeed = settings.windSpeed;
+
+    if (settings.spectrum == Spectrum::PHILLIPS) {
+        // P(k) = exp(-1 / (kL)^2) / k^4 * |k^ . w^|^2, with L = V^2 / g the largest
+        // wave the wind can raise and waves much shorter than L / 1000 suppressed
+        float largest = windSpeed * windSpeed / GRAVITY;
+        float smallest = largest / 1000.0f;
+        float kl = k * largest;
+        return std::exp(-1.0f / (kl * kl)) / (k * k * k * k) * cosTheta * cosTheta *
+               std::exp(-k * k * smallest * smallest);
+    }
+
+    // JONSWAP frequency spectrum for fetch limited seas
+    float w = std::sqrt(GRAVITY * k);
+    float peak = 22.0f * std::cbrt(GRAVITY * GRAVITY / (windSpeed * settings.fetch));
+    float alpha = 0.076f * std::pow(windSpeed * windSpeed / (settings.fetch * GRAVITY), 0.22f);
+    float sigma = w <= peak ? 0.07f : 0.09f;
+    float r = std::exp(-(w - peak) * (w - peak) / (2.0f * sigma * sigma * peak * peak));
+    float ratio = peak / w;
+    float s = alpha * GRAVITY * GRAVITY / std::pow(w, 5.0f) *
+              std::exp(-1.25f * ratio * ratio * ratio * ratio) * std::pow(settings.peakEnhancement, r);
+
+    // cos^2 spreading of the waves travelling downwind
+    float spreading = cosTheta > 0.0f ? 2.0f / (float)M_PI * cosTheta * cosTheta : 0.0f;
+
+    // S(omega) d omega -> density over (kx, kz): d omega / dk = g / (2 omega), dk dtheta = dkx dkz / k
+    return s * (GRAVITY / (2.0f * w)) / k * spreading;
+}
+
+void SpectralOcean::generateSpectrum() {
+    const float dk = 2.0f * (float)M_PI / settings.patchSize;
+
+    std::mt19937 gen(settings.seed);
+    std::normal_distribution<float> gauss(0.0f, 1.0f);
+
+    double variance = 0.0;
+    for (int j = 0; j < n; j++) {
+        for (int i = 0; i < n; i++) {
+            const size_t idx = (size_t)j * n + i;
+
+            // FFT order: indices past n / 2 are the negative frequencies
+            kx[idx] = (float)(i < n / 2 ? i : i - n) * dk;
+            kz[idx] = (float)(j < n / 2 ? j : j - n) * dk;
+            omega[idx] = std::sqrt(GRAVITY * std::sqrt(kx[idx] * kx[idx] + kz[idx] * kz[idx]));
+
+            // Draw for every entry so the sequence does not depend on which ones are zeroed
+            float xr = gauss(gen);
+            float xi = gauss(gen);
+
+            // The Nyquist row / column has no conjugate partner, keep it empty so the maps stay real
+            if (i == n / 2 || j == n / 2) {
+                h0[idx] = 0.0f;
+                continue;
+            }
+
+            float amplitude = std::sqrt(spectrumDensity(kx[idx], kz[idx]) * dk * dk * 0.5f);
+            h0[idx] = {xr * amplitude, xi * amplitude};
+            variance += 2.0 * std::norm(h0[idx]);
+        }
+    }
+
+    // Normalize to the requested significant wave height (4 standard deviations):
+    // by Parseval the surface variance is sum |h0(k)|^2 + |h0(-k)|^2
+    float scale = 0.0f;
+    if (variance > 0.0) {
+        scale = (float)(settings.significantHeight / 4.0 / std::sqrt(variance));
+    }
+
+    for (auto &h : h0) h *= scale;
+
+    for (int j = 0; j < n; j++) {
+        for (int i = 0; i < n; i++) {
+            size_t minus = (size_t)((n - j) % n) * n + (n - i) % n;
+            h0MinusConj[(size_t)j * n + i] = std::conj(h0[minus]);
+        }
+    }
+}
+
+// ===================== Evolution =========================
+
+std::complex<float> SpectralOcean::evolve(int index, float t) const {
+    float c = std::cos(omega[index] * t);
+    float s = std::sin(omega[index] * t);
+
+    const std::complex<float> &a = h0[index];
+    const std::complex<float> &b = h0MinusConj[index];
+    return {(a.real() + b.real()) * c - (a.imag() - b.imag()) * s,
+            (a.imag() + b.imag()) * c + (a.real() - b.real()) * s};
+}
+
+void SpectralOcean::update(float t, bool parallel) {
+    time = t;
+    const int count = n * n;
+
+    #pragma omp parallel for schedule(static) if(parallel)
+    for (int idx = 0; idx < count; idx++) {
+        std::complex<float> h = evolve(idx, t) * heightScale;
+        heightSpectrum[idx] = h;
+
+        // i kx h + i (i kz h): the inverse transform yields dh/dx in the real part
+        // and dh/dz in the imaginary part, since both fields are real
+        slopeSpectrum[idx] = {-kx[idx] * h.imag() - kz[idx] * h.real(),
+                              kx[idx] * h.real() - kz[idx] * h.imag()};
+    }
+
+    fft.transform2D(heightSpectrum.data(), true, parallel);
+    fft.transform2D(slopeSpectrum.data(), true, parallel);
+
+    #pragma omp parallel for schedule(static) if(parallel)
+    for (int idx = 0; idx < count; idx++) {
+        heightMap[idx] = heightSpectrum[idx].real();
+        normalMap[idx] = glm::normalize(glm::vec3(-slopeSpectrum[idx].real(), 1.0f, -slopeSpectrum[idx].imag()));
+    }
+}
+
+// ===================== Sampling =========================
+
+void SpectralOcean::lookup(float x, float z, int &i00, int &i10, int &i01, int &i11, float &fx, float &fz) const {
+    const float texelsPerUnit = n / settings.patchSize;
+    float u = x * texelsPerUnit;
+    float v = z * texelsPerUnit;
+    float fu = std::floor(u);
+    float fv = std::floor(v);
+    fx = u - fu;
+    fz = v - fv;
+
+    // Power of two size: masking wraps negative indices too
+    int x0 = (int)fu & (n - 1);
+    int z0 = (int)fv & (n - 1);
+    int x1 = (x0 + 1) & (n - 1);
+    int z1 = (z0 + 1) & (n - 1);
+
+    i00 = z0 * n + x0;
+    i10 = z0 * n + x1;
+    i01 = z1 * n + x0;
+    i11 = z1 * n + x1;
+}
+
+float SpectralOcean::height(float x, float z) const {
+    int i00, i10, i01, i11;
+    float fx, fz;
+    lookup(x, z, i00, i10, i01, i11, fx, fz);
+
+    float row0 = heightMap[i00] + (heightMap[i10] - heightMap[i00]) * fx;
+    float row1 = heightMap[i01] + (heightMap[i11] - heightMap[i01]) * fx;
+    return row0 + (row1 - row0) * fz;
+}
+
+glm::vec3 SpectralOcean::normal(float x, float z) const {
+    int i00, i10, i01, i11;
+    float fx, fz;
+    lookup(x, z, i00, i10, i01, i11, fx, fz);
+
+    glm::vec3 n0 = glm::mix(normalMap[i00], normalMap[i10], fx);
+    glm::vec3 n1 = glm::mix(normalMap[i01], normalMap[i11], fx);
+    return glm::normalize(glm::mix(n0, n1, fz));
+}
+
+void SpectralOcean::sampleGrid(const float *xs, int columns, const float *zs, int rows,
+                               float *outHeight, int stride, glm::vec3 *outNormal, bool parallel) const {
+    #pragma omp parallel for schedule(static) if(parallel && rows > 1)
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < columns; c++) {
+            size_t idx = (size_t)r * columns + c;
+            outHeight[idx * stride] = height(xs[c], zs[r]);
+            if (outNormal) outNormal[idx] = normal(xs[c], zs[r]);
+        }
+    }
+}
+
+// ===================== Verification =========================
+
+float SpectralOcean::measureError(int samples) const {
+    const int count = n * n;
+    std::vector<std::complex<float>> spectrum(count);
+    for (int idx = 0; idx < count; idx++) {
+        spectrum[idx] = evolve(idx, time) * heightScale;
+    }
+
+    std::mt19937 gen(settings.seed + 1);
+    std::uniform_int_distribution<int> texel(0, n - 1);
+
+    float maxError = 0.0f;
+    for (int s = 0; s < samples; s++) {
+        int mx = texel(gen);
+        int mz = texel(gen);
+
+        // h(x) = sum h(k, t) e^(i k . x), phases reduced exactly in integer arithmetic
+        double sum = 0.0;
+        for (int j = 0; j < n; j++) {
+            for (int i = 0; i < n; i++) {
+                int phase = (int)(((long long)i * mx + (long long)j * mz) % n);
+                double angle = 2.0 * M_PI * phase / n;
+                const std::complex<float> &h = spectrum[(size_t)j * n + i];
+                sum += h.real() * std::cos(angle) - h.imag() * std::sin(angle);
+            }
+        }
+
+        maxError = std::max(maxError, std::abs((float)sum - heightMap[(size_t)mz * n + mx]));
+    }
+
+    return maxError;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <complex>
+#include <vector>
+#include "FFT.h"
+
+// Wave spectrum the initial amplitudes are drawn from
+enum class Spectrum {
+    PHILLIPS,
+    JONSWAP
+};
+
+struct SpectrumSettings {
+    int gridSize = 128;                  // FFT size per axis, power of two
+    float patchSize = 256.0f;            // World size of one tile
+    Spectrum spectrum = Spectrum::JONSWAP;
+    float windSpeed = 20.0f;             // m/s
+    glm::vec2 windDirection = {1.0f, 0.3f};
+    float fetch = 100000.0f;             // Distance the wind blew over water (m), JONSWAP only
+    float peakEnhancement = 3.3f;        // JONSWAP gamma
+    float significantHeight = 6.0f;      // 4 * standard deviation of the surface at height scale 1
+    unsigned int seed = 42;
+};
+
+/*!
+ * Statistical ocean surface after Tessendorf, "Simulating Ocean Water".
+ *
+ * A random initial spectrum h0(k) is drawn once from a Phillips or JONSWAP wave
+ * spectrum on a gridSize x gridSize lattice of wave vectors. Every update evolves it
+ * in the frequency domain with the deep water dispersion omega = sqrt(g |k|),
+ *
+ *   h(k, t) = h0(k) e^(i omega t) + conj(h0(-k)) e^(-i omega t)
+ *
+ * and two inverse 2D FFTs turn it into a height map and (packed as real / imaginary
+ * part of one transform) the x / z slopes, from which the normal map is built. The
+ * cost is O(N log N) for all N = gridSize^2 components. The maps tile with period
+ * patchSize in x and z and are sampled bilinearly.
+ */
+class SpectralOcean {
+public:
+    explicit SpectralOcean(const SpectrumSettings &settings = SpectrumSettings());
+
+    // Evolve the spectrum to time t and rebuild the height and normal maps
+    void update(float t, bool parallel = true);
+
+    // Multiplier for every height (and slope), applied from the next update
+    void setHeightScale(float scale) { heightScale = scale; }
+
+    // Bilinear samples of the periodic maps from the last update
+    float height(float x, float z) const;
+    glm::vec3 normal(float x, float z) const;
+
+    // Regular grid: row r samples xs[0..columns) at zs[r]. Heights are written to
+    // outHeight[(r * columns + c) * stride], normals to outNormal[r * columns + c].
+    void sampleGrid(const float *xs, int columns, const float *zs, int rows,
+                    float *outHeight, int stride, glm::vec3 *outNormal, bool parallel = true) const;
+
+    const SpectrumSettings &getSettings() const { return settings; }
+    float getTime() const { return time; }
+    const std::vector<float> &getHeightMap() const { return heightMap; }
+    const std::vector<glm::vec3> &getNormalMap() const { return normalMap; }
+
+    // Largest difference between the FFT height map and a direct sum of all
+    // spectral components at `samples` map points
+    float measureError(int samples = 16) const;
+    static constexpr float TOLERANCE = 1e-3f;
+
+private:
+    SpectrumSettings settings;
+    FFT fft;
+    int n;
+    float heightScale = 1.0f;
+    float time = 0.0f;
+
+    // Per wave vector, row-major over (kz, kx) in FFT order
+    std::vector<std::complex<float>> h0;          // h0(k)
+    std::vector<std::complex<float>> h0MinusConj; // conj(h0(-k))
+    std::vector<float> kx, kz, omega;
+
+    // FFT work buffers
+    std::vector<std::complex<float>> heightSpectrum, slopeSpectrum;
+
+    // Results of the last update
+    std::vector<float> heightMap;
+    std::vector<glm::vec3> normalMap;
+
+    void generateSpectrum();
+    float spectrumDensity(float waveX, float waveZ) const;
+    std::complex<float> evolve(int index, float t) const;
+
+    // Bilinear lookup setup: base texel indices and weights for a world position
+    void lookup(float x, float z, int &i00, int &i10, int &i01, int &i11, float &fx, float &fz) const;
+};
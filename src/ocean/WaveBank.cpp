@@ -0,0 +1,196 @@
+#include "WaveBank.h"
+#include <algorithm>
+#include <cmath>
+
+// ===================== Polynomial sin / cos =========================
+//
+// Branchless so that loops calling it vectorize. The argument is reduced to
+// r in [-pi/4, pi/4] with x = q * pi/2 + r (pi/2 split in three parts so the
+// reduction stays exact for the phases the ocean produces), then the quadrant
+// picks between the sin and cos polynomials (Cephes sinf / cosf coefficients).
+
+static inline void sinCos(float x, float &s, float &c) {
+    const float TWO_OVER_PI = 0.636619772367581f;
+    const float PIO2_1 = 1.5703125f;
+    const float PIO2_2 = 4.837512969970703125e-4f;
+    const float PIO2_3 = 7.54978995489188216e-8f;
+
+    int iq = (int)(x * TWO_OVER_PI + std::copysign(0.5f, x));
+    float q = (float)iq;
+    float r = ((x - q * PIO2_1) - q * PIO2_2) - q * PIO2_3;
+    float r2 = r * r;
+
+    float sr = r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+    float cr = 1.0f - 0.5f * r2 + r2 * r2 * (4.166664568298827e-2f + r2 * (-1.388731625493765e-3f + r2 * 2.443315711809948e-5f));
+
+    // Quadrant selection as arithmetic (no branches for the vectorizer to give up on)
+    float odd = (float)(iq & 1);
+    float sq = sr + odd * (cr - sr);
+    float cq = cr + odd * (sr - cr);
+    s = sq * (1.0f - (float)(iq & 2));
+    c = cq * (1.0f - (float)((iq + 1) & 2));
+}
+
+// ===================== Wave setup =========================
+
+const int WaveBank::BLOCK;
+
+void WaveBank::clear() {
+    wavelengths.clear();
+    amplitudes.clear();
+    speeds.clear();
+    directions.clear();
+    rebuild();
+}
+
+void WaveBank::addWave(float wavelength, float amplitude, float speed, const glm::vec2 &direction) {
+    wavelengths.push_back(wavelength);
+    amplitudes.push_back(amplitude);
+    speeds.push_back(speed);
+    directions.push_back(direction);
+    rebuild();
+}
+
+void WaveBank::setScales(float height, float speed) {
+    heightScale = height;
+    speedScale = speed;
+    rebuild();
+}
+
+void WaveBank::rebuild() {
+    const size_t count = wavelengths.size();
+    dirX.resize(count);
+    dirZ.resize(count);
+    k.resize(count);
+    omega.resize(count);
+    amp.resize(count);
+    slope.resize(count);
+
+    for (size_t i = 0; i < count; i++) {
+        dirX[i] = directions[i].x;
+        dirZ[i] = directions[i].y;
+        k[i] = 2.0f * (float)M_PI / wavelengths[i];
+        omega[i] = k[i] * speeds[i] * speedScale;
+        amp[i] = amplitudes[i] * heightScale;
+        slope[i] = k[i] * amp[i];
+    }
+}
+
+// ===================== Evaluation =========================
+
+void WaveBank::evaluateBlock(const float *x, const float *z, float t, float *outHeight,
+                             float *gradX, float *gradZ, int count) const {
+    std::fill(outHeight, outHeight + count, 0.0f);
+    if (gradX) {
+        std::fill(gradX, gradX + count, 0.0f);
+        std::fill(gradZ, gradZ + count, 0.0f);
+    }
+
+    // Waves outside, points inside: the inner loops are plain SIMD over points
+    for (size_t w = 0; w < k.size(); w++) {
+        const float kx = k[w] * dirX[w];
+        const float kz = k[w] * dirZ[w];
+        const float phase = omega[w] * t;
+        const float a = amp[w];
+
+        if (gradX) {
+            const float sx = slope[w] * dirX[w];
+            const float sz = slope[w] * dirZ[w];
+
+            #pragma omp simd
+            for (int i = 0; i < count; i++) {
+                float s, c;
+                sinCos(kx * x[i] + kz * z[i] - phase, s, c);
+                outHeight[i] += a * s;
+                gradX[i] += sx * c;
+                gradZ[i] += sz * c;
+            }
+        } else {
+            #pragma omp simd
+            for (int i = 0; i < count; i++) {
+                float s, c;
+                sinCos(kx * x[i] + kz * z[i] - phase, s, c);
+                outHeight[i] += a * s;
+            }
+        }
+    }
+}
+
+float WaveBank::height(float x, float z, float t) const {
+    float h;
+    evaluateBlock(&x, &z, t, &h, nullptr, nullptr, 1);
+    return h;
+}
+
+glm::vec3 WaveBank::normal(float x, float z, float t) const {
+    float h, gx, gz;
+    evaluateBlock(&x, &z, t, &h, &gx, &gz, 1);
+    return glm::normalize(glm::vec3(-gx, 1.0f, -gz));
+}
+
+void WaveBank::heights(const float *x, const float *z, float t, float *out, int count, bool parallel) const {
+    const int blocks = (count + BLOCK - 1) / BLOCK;
+
+    #pragma omp parallel for schedule(static) if(parallel && blocks > 1)
+    for (int b = 0; b < blocks; b++) {
+        int first = b * BLOCK;
+        evaluateBlock(x + first, z + first, t, out + first, nullptr, nullptr, std::min(BLOCK, count - first));
+    }
+}
+
+void WaveBank::heightsAndNormals(const float *x, const float *z, float t, float *outHeight,
+                                 glm::vec3 *outNormal, int count, bool parallel) const {
+    const int blocks = (count + BLOCK - 1) / BLOCK;
+
+    #pragma omp parallel for schedule(static) if(parallel && blocks > 1)
+    for (int b = 0; b < blocks; b++) {
+        int first = b * BLOCK;
+        int n = std::min(BLOCK, count - first);
+        float gradX[BLOCK], gradZ[BLOCK];
+
+        evaluateBlock(x + first, z + first, t, outHeight + first, gradX, gradZ, n);
+        for (int i = 0; i < n; i++) {
+            outNormal[first + i] = glm::normalize(glm::vec3(-gradX[i], 1.0f, -gradZ[i]));
+        }
+    }
+}
+
+void WaveBank::gridHeights(const float *xs, int columns, const float *zs, int rows, float t,
+                           float *out, int stride, bool parallel) const {
+    #pragma omp parallel for schedule(static) if(parallel && rows > 1)
+    for (int r = 0; r < rows; r++) {
+        float zRow[BLOCK], hRow[BLOCK];
+        std::fill(zRow, zRow + BLOCK, zs[r]);
+
+        for (int first = 0; first < columns; first += BLOCK) {
+            int n = std::min(BLOCK, columns - first);
+            evaluateBlock(xs + first, zRow, t, hRow, nullptr, nullptr, n);
+
+            float *dst = out + ((size_t)r * columns + first) * stride;
+            for (int i = 0; i < n; i++) {
+                dst[(size_t)i * stride] = hRow[i];
+            }
+        }
+    }
+}
+
+void WaveBank::gridHeightsAndNormals(const float *xs, int columns, const float *zs, int rows, float t,
+                                     float *outHeight, int stride, glm::vec3 *outNormal, bool parallel) const {
+    #pragma omp parallel for schedule(static) if(parallel && rows > 1)
+    for (int r = 0; r < rows; r++) {
+        float zRow[BLOCK], hRow[BLOCK], gradX[BLOCK], gradZ[BLOCK];
+        std::fill(zRow, zRow + BLOCK, zs[r]);
+
+        for (int first = 0; first < columns; first += BLOCK) {
+            int n = std::min(BLOCK, columns - first);
+            evaluateBlock(xs + first, zRow, t, hRow, gradX, gradZ, n);
+
+            const size_t base = (size_t)r * columns + first;
+            float *dst = outHeight + base * stride;
+            for (int i = 0; i < n; i++) {
+                dst[(size_t)i * stride] = hRow[i];
+                outNormal[base + i] = glm::normalize(glm::vec3(-gradX[i], 1.0f, -gradZ[i]));
+            }
+        }
+    }
+}
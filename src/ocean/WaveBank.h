@@ -0,0 +1,62 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+/*!
+ * CPU evaluator for a sum of directional sine waves (the Ocean wave model).
+ *
+ * Per-wave constants are derived once when waves or scales change and stored as
+ * separate arrays: wave number k, angular frequency omega, direction and the
+ * scaled amplitude. Queries evaluate many points at once; the inner loops run
+ * over points with a branchless polynomial sin/cos so they vectorize, and large
+ * batches and grids are split across OpenMP threads.
+ *
+ * height(x, z, t) = sum A * sin(k * dot(d, (x, z)) - omega * t)
+ * normal          = normalize(-dh/dx, 1, -dh/dz)
+ */
+class WaveBank {
+public:
+    void clear();
+    void addWave(float wavelength, float amplitude, float speed, const glm::vec2 &direction);
+
+    // Global multipliers for every amplitude and speed
+    void setScales(float heightScale, float speedScale);
+
+    int getWaveCount() const { return (int)k.size(); }
+
+    // Single point queries
+    float height(float x, float z, float t) const;
+    glm::vec3 normal(float x, float z, float t) const;
+
+    // Batch of `count` points given as separate x/z arrays
+    void heights(const float *x, const float *z, float t, float *out, int count, bool parallel = true) const;
+    void heightsAndNormals(const float *x, const float *z, float t, float *outHeight,
+                           glm::vec3 *outNormal, int count, bool parallel = true) const;
+
+    // Regular grid: row r samples xs[0..columns) at zs[r]. Heights are written to
+    // out[(r * columns + c) * stride], so the y channel of a position array works.
+    void gridHeights(const float *xs, int columns, const float *zs, int rows, float t,
+                     float *out, int stride, bool parallel = true) const;
+
+    // Same with analytic normals, outNormal holds rows * columns entries
+    void gridHeightsAndNormals(const float *xs, int columns, const float *zs, int rows, float t,
+                               float *outHeight, int stride, glm::vec3 *outNormal, bool parallel = true) const;
+
+private:
+    // Source parameters
+    std::vector<float> wavelengths, amplitudes, speeds;
+    std::vector<glm::vec2> directions;
+    float heightScale = 1.0f;
+    float speedScale = 1.0f;
+
+    // Derived constants, one entry per wave
+    std::vector<float> dirX, dirZ, k, omega, amp, slope;
+
+    void rebuild();
+
+    // Points per block: blocks are what threads take, and what the accumulators hold
+    static const int BLOCK = 256;
+    void evaluateBlock(const float *x, const float *z, float t, float *outHeight,
+                       float *gradX, float *gradZ, int count) const;
+};
@@ -2,4 +2,23 @@
 // Created by mrepi on 20. 11. 2025.
 //
 
-#include "dust_particles.h"
\ No newline at end of file
+#include "dust_particles.h"
+
+namespace ppgso {
+
+    DustParticles::DustParticles(size_t capacity) : ParticleSystem(capacity, "DustParticles") {
+        // Siroky plochy emitor, slaby vietor a takmer ziadna gravitacia
+        emitterExtent = glm::vec3(30.0f, 2.0f, 30.0f);
+        emissionRate = 2000.0f;
+        velocity = glm::vec3(0.3f, 0.05f, 0.1f);
+        velocitySpread = glm::vec3(0.2f, 0.1f, 0.2f);
+        acceleration = glm::vec3(0.0f, -0.02f, 0.0f);
+        lifetimeMin = 4.0f;
+        lifetimeMax = 8.0f;
+        sizeMin = 0.03f;
+        sizeMax = 0.08f;
+        colorMin = glm::vec4(0.55f, 0.45f, 0.30f, 0.3f);
+        colorMax = glm::vec4(0.80f, 0.70f, 0.50f, 0.6f);
+    }
+
+} // namespace ppgso
@@ -5,4 +5,18 @@
 #ifndef PPGSO_DUST_PARTICLES_H
 #define PPGSO_DUST_PARTICLES_H
 
-#endif //PPGSO_DUST_PARTICLES_H
\ No newline at end of file
+#include "particle_system.h"
+
+namespace ppgso {
+
+    /**
+     * DustParticles - Pomaly sa vznasajuci piesok nad ostrovom
+     */
+    class DustParticles : public ParticleSystem {
+    public:
+        explicit DustParticles(size_t capacity = 20000);
+    };
+
+} // namespace ppgso
+
+#endif //PPGSO_DUST_PARTICLES_H
@@ -2,4 +2,24 @@
 // Created by mrepi on 20. 11. 2025.
 //
 
-#include "falling_leaves.h"
\ No newline at end of file
+#include "falling_leaves.h"
+
+namespace ppgso {
+
+    FallingLeaves::FallingLeaves(size_t capacity) : ParticleSystem(capacity, "FallingLeaves") {
+        // Odpor vzduchu drzi listy pri nizkej rychlosti padu, vietor ich unasa do strany
+        emitterExtent = glm::vec3(4.0f, 0.5f, 4.0f);
+        emissionRate = 40.0f;
+        velocitySpread = glm::vec3(0.5f, 0.2f, 0.5f);
+        acceleration = glm::vec3(0.4f, -0.8f, 0.1f);
+        drag = 0.6f;
+        floorHeight = 0.0f;
+        lifetimeMin = 8.0f;
+        lifetimeMax = 12.0f;
+        sizeMin = 0.08f;
+        sizeMax = 0.15f;
+        colorMin = glm::vec4(0.25f, 0.45f, 0.10f, 0.9f);
+        colorMax = glm::vec4(0.60f, 0.45f, 0.15f, 1.0f);
+    }
+
+} // namespace ppgso
@@ -5,4 +5,18 @@
 #ifndef PPGSO_FALLING_LEAVES_H
 #define PPGSO_FALLING_LEAVES_H
 
-#endif //PPGSO_FALLING_LEAVES_H
\ No newline at end of file
+#include "particle_system.h"
+
+namespace ppgso {
+
+    /**
+     * FallingLeaves - Listy padajuce z korun paliem, zaniknu na zemi
+     */
+    class FallingLeaves : public ParticleSystem {
+    public:
+        explicit FallingLeaves(size_t capacity = 5000);
+    };
+
+} // namespace ppgso
+
+#endif //PPGSO_FALLING_LEAVES_H
@@ -2,4 +2,334 @@
 // Created by mrepi on 20. 11. 2025.
 //
 
-#include "particle_system.h"
\ No newline at end of file
+#include "particle_system.h"
+#include <shaders/particle_vert_glsl.h>
+#include <shaders/particle_frag_glsl.h>
+#include <ppgso/timing.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace ppgso {
+
+    // Lokacie atributov v particle_vert.glsl, v tomto poradi su aj useky bufferu
+    enum ParticleAttribute : GLuint {
+        ATTRIBUTE_POSITION_X = 0,
+        ATTRIBUTE_POSITION_Y,
+        ATTRIBUTE_POSITION_Z,
+        ATTRIBUTE_SIZE,
+        ATTRIBUTE_AGE,
+        ATTRIBUTE_COLOR,
+        ATTRIBUTE_COUNT
+    };
+
+    // Nahodne cislo <0, 1) z pocitadla castice a indexu hodnoty, bez stavu generatora,
+    // takze cyklus cez davku ide vektorizovat
+    static inline float hashUnit(uint32_t counter, uint32_t channel) {
+        uint32_t x = counter * 0x9E3779B9u + channel * 0x85EBCA6Bu;
+        x ^= x >> 16;
+        x *= 0x7FEB352Du;
+        x ^= x >> 15;
+        x *= 0x846CA68Bu;
+        x ^= x >> 16;
+        return (float)(x >> 8) * (1.0f / 16777216.0f);
+    }
+
+    static inline uint32_t packColor(float r, float g, float b, float a) {
+        return (uint32_t)(r * 255.0f + 0.5f)
+             | (uint32_t)(g * 255.0f + 0.5f) << 8
+             | (uint32_t)(b * 255.0f + 0.5f) << 16
+             | (uint32_t)(a * 255.0f + 0.5f) << 24;
+    }
+
+    ParticleSystem::ParticleSystem(size_t capacity, const std::string& name)
+        : Object(name)
+        , capacity(capacity)
+    {
+        // Cela kapacita sa alokuje hned, emitovanie a zanikanie potom nealokuje
+        for (auto array : {&positionX, &positionY, &positionZ, &velocityX, &velocityY, &velocityZ, &age, &ageRate, &size}) {
+            array->resize(capacity);
+        }
+        color.resize(capacity);
+    }
+
+    ParticleSystem::~ParticleSystem() {
+        if (buffer) glDeleteBuffers(1, &buffer);
+        if (vao) glDeleteVertexArrays(1, &vao);
+    }
+
+    void ParticleSystem::update(float deltaTime) {
+        // Zlomky castic sa prenasaju do dalsieho frame, nizky emissionRate funguje aj pri vysokom FPS
+        emitAccumulator += emissionRate * deltaTime;
+        auto newParticles = (size_t)emitAccumulator;
+        emitAccumulator -= (float)newParticles;
+
+        simulate(deltaTime);
+        emit(newParticles);
+        publishBounds();
+    }
+
+    void ParticleSystem::publishBounds() {
+        // Prazdny system ma obalku v bode emitora, podstrom predka tak zostane orezatelny
+        const glm::mat4& world = transform.getWorldMatrix();
+        if (count == 0) {
+            liveMin = liveMax = glm::vec3(world[3]);
+            liveSize = 0.0f;
+        }
+
+        // Roh billboardu je v rovine kamery az size * sqrt(2) od stredu castice
+        const glm::vec3 margin(liveSize * 1.4142136f);
+        const glm::vec3 worldCenter = (liveMin + liveMax) * 0.5f;
+        const glm::vec3 worldExtent = (liveMax - liveMin) * 0.5f + margin;
+
+        // Svetovy AABB do lokalneho priestoru uzla (Arvo cez inverznu maticu)
+        const glm::mat4 toLocal = glm::inverse(world);
+        glm::vec3 center = glm::vec3(toLocal * glm::vec4(worldCenter, 1.0f));
+        glm::vec3 extent = glm::abs(glm::vec3(toLocal[0])) * worldExtent.x
+                         + glm::abs(glm::vec3(toLocal[1])) * worldExtent.y
+                         + glm::abs(glm::vec3(toLocal[2])) * worldExtent.z;
+        setLocalBounds(center - extent, center + extent);
+    }
+
+    void ParticleSystem::emit(size_t particleCount) {
+        const size_t n = std::min(particleCount, capacity - count);
+        if (n == 0) return;
+
+        const glm::vec3 origin = glm::vec3(transform.getWorldMatrix()[3]);
+        const uint32_t seed = spawnCounter;
+        const size_t first = count;
+        spawnCounter += (uint32_t)n;
+
+        float* px = positionX.data() + first;
+        float* py = positionY.data() + first;
+        float* pz = positionZ.data() + first;
+        float* vx = velocityX.data() + first;
+        float* vy = velocityY.data() + first;
+        float* vz = velocityZ.data() + first;
+        float* a = age.data() + first;
+        float* rate = ageRate.data() + first;
+        float* s = size.data() + first;
+        uint32_t* c = color.data() + first;
+
+        const glm::vec3 extent = emitterExtent, base = velocity, spread = velocitySpread;
+        const glm::vec4 color0 = colorMin, colorRange = colorMax - colorMin;
+        const float lifetime0 = lifetimeMin, lifetimeRange = lifetimeMax - lifetimeMin;
+        const float size0 = sizeMin, sizeRange = sizeMax - sizeMin;
+
+        #pragma omp simd
+        for (size_t i = 0; i < n; i++) {
+            const uint32_t k = seed + (uint32_t)i;
+            px[i] = origin.x + extent.x * (2.0f * hashUnit(k, 0) - 1.0f);
+            py[i] = origin.y + extent.y * (2.0f * hashUnit(k, 1) - 1.0f);
+            pz[i] = origin.z + extent.z * (2.0f * hashUnit(k, 2) - 1.0f);
+            vx[i] = base.x + spread.x * (2.0f * hashUnit(k, 3) - 1.0f);
+            vy[i] = base.y + spread.y * (2.0f * hashUnit(k, 4) - 1.0f);
+            vz[i] = base.z + spread.z * (2.0f * hashUnit(k, 5) - 1.0f);
+            a[i] = 0.0f;
+            rate[i] = 1.0f / (lifetime0 + lifetimeRange * hashUnit(k, 6));
+            s[i] = size0 + sizeRange * hashUnit(k, 7);
+
+            // Jedna hodnota pre vsetky kanaly, farby zostanu medzi colorMin a colorMax
+            const float t = hashUnit(k, 8);
+            c[i] = packColor(color0.r + colorRange.r * t, color0.g + colorRange.g * t,
+                             color0.b + colorRange.b * t, color0.a + colorRange.a * t);
+        }
+
+        // Nove castice su v boxe emitora, obalka zivych sa nim len rozsiri
+        if (count == 0) {
+            liveMin = origin - extent;
+            liveMax = origin + extent;
+            liveSize = 0.0f;
+        } else {
+            liveMin = glm::min(liveMin, origin - extent);
+            liveMax = glm::max(liveMax, origin + extent);
+        }
+        liveSize = std::max(liveSize, std::max(sizeMin, sizeMax));
+        count += n;
+    }
+
+    void ParticleSystem::simulateBlock(size_t first, size_t n, float deltaTime) {
+        float* px = positionX.data() + first;
+        float* py = positionY.data() + first;
+        float* pz = positionZ.data() + first;
+        float* vx = velocityX.data() + first;
+        float* vy = velocityY.data() + first;
+        float* vz = velocityZ.data() + first;
+        float* a = age.data() + first;
+        const float* rate = ageRate.data() + first;
+        float* s = size.data() + first;
+
+        const glm::vec3 dv = acceleration * deltaTime;
+        const float damping = std::max(0.0f, 1.0f - drag * deltaTime);
+        const float grow = sizeGrowth * deltaTime;
+        const float floorY = floorHeight;
+
+        #pragma omp simd
+        for (size_t i = 0; i < n; i++) {
+            vx[i] = (vx[i] + dv.x) * damping;
+            vy[i] = (vy[i] + dv.y) * damping;
+            vz[i] = (vz[i] + dv.z) * damping;
+            px[i] += vx[i] * deltaTime;
+            py[i] += vy[i] * deltaTime;
+            pz[i] += vz[i] * deltaTime;
+            s[i] = std::max(0.0f, s[i] + grow);
+
+            // Castica pod podlahou zanikne spolu so starymi
+            const float aged = a[i] + rate[i] * deltaTime;
+            a[i] = py[i] < floorY ? 1.0f : aged;
+        }
+    }
+
+    void ParticleSystem::simulate(float deltaTime, bool parallel) {
+        const int blocks = (int)((count + BLOCK - 1) / BLOCK);
+
+        #pragma omp parallel for schedule(static) if(parallel && blocks > 1)
+        for (int b = 0; b < blocks; b++) {
+            size_t first = (size_t)b * BLOCK;
+            simulateBlock(first, std::min<size_t>(BLOCK, count - first), deltaTime);
+        }
+
+        compact();
+    }
+
+    void ParticleSystem::compact() {
+        // Mrtvu casticu nahradi posledna ziva, ta sa hned otestuje na tom istom indexe
+        size_t i = 0;
+        while (i < count) {
+            if (age[i] < 1.0f) {
+                i++;
+                continue;
+            }
+            size_t last = --count;
+            if (i == last) break;
+            positionX[i] = positionX[last];
+            positionY[i] = positionY[last];
+            positionZ[i] = positionZ[last];
+            velocityX[i] = velocityX[last];
+            velocityY[i] = velocityY[last];
+            velocityZ[i] = velocityZ[last];
+            age[i] = age[last];
+            ageRate[i] = ageRate[last];
+            size[i] = size[last];
+            color[i] = color[last];
+        }
+
+        // Obalka zivych castic: po kompakcii su huste v [0, count), takze ide o cistu
+        // redukciu, ktora sa vektorizuje (v cykle vyssie by bola seriova a s vetvenim).
+        // Porovnania namiesto std::min/max, tie vracaju referenciu a GCC cyklus nevektorizuje
+        const float far = std::numeric_limits<float>::max();
+        float minX = far, minY = far, minZ = far, maxX = -far, maxY = -far, maxZ = -far, largest = 0.0f;
+        const float* px = positionX.data();
+        const float* py = positionY.data();
+        const float* pz = positionZ.data();
+        const float* s = size.data();
+
+        #pragma omp simd reduction(min:minX, minY, minZ) reduction(max:maxX, maxY, maxZ, largest)
+        for (size_t j = 0; j < count; j++) {
+            minX = px[j] < minX ? px[j] : minX;
+            maxX = px[j] > maxX ? px[j] : maxX;
+            minY = py[j] < minY ? py[j] : minY;
+            maxY = py[j] > maxY ? py[j] : maxY;
+            minZ = pz[j] < minZ ? pz[j] : minZ;
+            maxZ = pz[j] > maxZ ? pz[j] : maxZ;
+            largest = s[j] > largest ? s[j] : largest;
+        }
+        liveMin = glm::vec3(minX, minY, minZ);
+        liveMax = glm::vec3(maxX, maxY, maxZ);
+        liveSize = largest;
+    }
+
+    void ParticleSystem::createGpuResources() {
+        gpuInitialized = true;
+        try {
+            shader = std::make_unique<ppgso::Shader>(particle_vert_glsl, particle_frag_glsl);
+        } catch (std::exception& e) {
+            std::cerr << "Error creating particle shader: " << e.what() << std::endl;
+            return;
+        }
+        particleView = shader->getUniform<glm::mat4>("ViewMatrix");
+        particleProjection = shader->getUniform<glm::mat4>("ProjectionMatrix");
+
+        // Kazde pole ma v bufferi usek velkosti capacity, offsety atributov su preto pevne
+        // a VAO sa nastavi raz. Stvorec billboardu sa sklada vo vertex shadri z gl_VertexID.
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &buffer);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, capacity * ATTRIBUTE_COUNT * 4, nullptr, GL_STREAM_DRAW);
+
+        for (GLuint location = ATTRIBUTE_POSITION_X; location < ATTRIBUTE_COUNT; location++) {
+            auto offset = reinterpret_cast<const void*>(location * capacity * 4);
+            glEnableVertexAttribArray(location);
+            if (location == ATTRIBUTE_COLOR) {
+                glVertexAttribPointer(location, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, offset);
+            } else {
+                glVertexAttribPointer(location, 1, GL_FLOAT, GL_FALSE, 0, offset);
+            }
+            glVertexAttribDivisor(location, 1);
+        }
+        glBindVertexArray(0);
+    }
+
+    void ParticleSystem::renderWithCamera(const Camera& camera) {
+        if (count == 0) return;
+        if (!gpuInitialized) createGpuResources();
+        if (!vao) return;
+
+        // Stary obsah sa zahodi (orphaning), driver nemusi cakat na predchadzajuci frame
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, capacity * ATTRIBUTE_COUNT * 4, nullptr, GL_STREAM_DRAW);
+        const void* arrays[ATTRIBUTE_COUNT] = {positionX.data(), positionY.data(), positionZ.data(),
+                                               size.data(), age.data(), color.data()};
+        for (GLuint location = ATTRIBUTE_POSITION_X; location < ATTRIBUTE_COUNT; location++) {
+            glBufferSubData(GL_ARRAY_BUFFER, location * capacity * 4, count * 4, arrays[location]);
+        }
+
+        shader->use();
+        particleView.set(camera.getViewMatrix());
+        particleProjection.set(camera.getProjectionMatrix());
+
+        // Castice testuju hlbku, ale nezapisuju ju, aby sa navzajom neorezavali
+        glDepthMask(GL_FALSE);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, additive ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA);
+
+        glBindVertexArray(vao);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)count);
+        glBindVertexArray(0);
+
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glDepthMask(GL_TRUE);
+    }
+
+    void ParticleSystem::benchmark(size_t particleCount, int frames) {
+        // Nesmrtelne castice, aby sa pocet pocas merania nemenil
+        ParticleSystem system(particleCount, "Benchmark");
+        system.emitterExtent = glm::vec3(50.0f);
+        system.velocitySpread = glm::vec3(1.0f);
+        system.lifetimeMin = system.lifetimeMax = 1e9f;
+        system.drag = 0.1f;
+
+        float emit = averageTime(frames, [&](int) {
+            system.clear();
+            system.emit(particleCount);
+        });
+        float serial = averageTime(frames, [&](int) { system.simulate(1.0f / 60.0f, false); });
+        float parallel = averageTime(frames, [&](int) { system.simulate(1.0f / 60.0f, true); });
+
+        // Polovica castic zanikne naraz, meria sa kompakcia
+        float compaction = averageTime(frames, [&](int) {
+            system.clear();
+            system.emit(particleCount);
+            for (size_t i = 0; i < system.count; i += 2) system.age[i] = 1.0f;
+            system.compact();
+        }) - emit;
+
+        std::cout << "Particles, " << particleCount << " particles (ms per frame):" << std::endl;
+        std::cout << "  emit all:           " << emit << std::endl;
+        std::cout << "  simulate serial:    " << serial << " (" << particleCount / serial << " particles/ms)" << std::endl;
+        std::cout << "  simulate parallel:  " << parallel << " (" << particleCount / parallel << " particles/ms)" << std::endl;
+        std::cout << "  compact half dead:  " << compaction << std::endl;
+    }
+
+} // namespace ppgso
@@ -5,4 +5,108 @@
 #ifndef PPGSO_PARTICLE_SYSTEM_H
 #define PPGSO_PARTICLE_SYSTEM_H
 
-#endif //PPGSO_PARTICLE_SYSTEM_H
\ No newline at end of file
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "../objects/object.h"
+
+namespace ppgso {
+
+    /**
+     * ParticleSystem - Castice v suvislych poliach (SoA), jeden draw na cely system
+     *
+     * Pozicia, rychlost, vek, velkost a farba su samostatne polia s pevnou kapacitou, zive
+     * castice su vzdy [0, count). Emitor pridava castice po davkach na koniec poli, mrtve
+     * castice sa odstrania vymenou s poslednou zivou (swap-remove), takze poradie nie je
+     * stabilne, ale polia zostanu huste.
+     *
+     * Simulacia bezi po blokoch: bloky si beru OpenMP vlakna, vnutorne cykly cez castice
+     * su ciste aritmeticke (#pragma omp simd). Vek je normalizovany (0 pri zrode, 1 pri
+     * zaniku), farba je zbalena RGBA8.
+     *
+     * Castice su vo svetovom priestore, emitor je na pozicii uzla. Vykreslenie je jeden
+     * instanced draw billboardov, ktory cita polia priamo z jedneho bufferu (kazde pole
+     * ma svoj usek), bez prebalovania na CPU. Obalka zivych castic sa zbiera pri odstraneni
+     * mrtvych a kazdy update ju publikuje ako lokalnu obalku uzla, system sa tak oreze sam.
+     */
+    class ParticleSystem : public Object {
+    public:
+        explicit ParticleSystem(size_t capacity, const std::string& name = "ParticleSystem");
+        ~ParticleSystem() override;
+
+        // Emitovanie podla emissionRate a simulacia
+        void update(float deltaTime) override;
+
+        // Jeden instanced draw, bez zapisu do hlbky
+        void renderWithCamera(const Camera& camera) override;
+        bool isTransparent() const override { return true; }
+
+        // Davka novych castic naraz (orezana na volnu kapacitu)
+        void emit(size_t particleCount);
+
+        // Pohyb, starnutie a odstranenie mrtvych castic
+        void simulate(float deltaTime, bool parallel = true);
+
+        void clear() { count = 0; }
+        size_t getCount() const { return count; }
+        size_t getCapacity() const { return capacity; }
+
+        // Emitor: castice za sekundu, box (polovicne rozmery) okolo pozicie uzla
+        float emissionRate = 100.0f;
+        glm::vec3 emitterExtent = glm::vec3(0.0f);
+
+        // Pociatocny stav: zakladna hodnota + nahodna odchylka v rozsahu <-spread, spread>
+        glm::vec3 velocity = glm::vec3(0.0f);
+        glm::vec3 velocitySpread = glm::vec3(0.0f);
+        float lifetimeMin = 1.0f, lifetimeMax = 2.0f;
+        float sizeMin = 0.1f, sizeMax = 0.2f;
+        glm::vec4 colorMin = glm::vec4(1.0f), colorMax = glm::vec4(1.0f);
+
+        // Simulacia: gravitacia a vietor, odpor vzduchu, rast velkosti, pod floorHeight castica zanikne
+        glm::vec3 acceleration = glm::vec3(0.0f, -9.81f, 0.0f);
+        float drag = 0.0f;
+        float sizeGrowth = 0.0f;
+        float floorHeight = -std::numeric_limits<float>::infinity();
+
+        // Aditivne miesanie (iskry, sprej) namiesto beznej priehladnosti
+        bool additive = false;
+
+        // Zmeria simulate() s particleCount casticami bez GL (seriovo aj paralelne)
+        // a vypise cas na frame a castice za milisekundu
+        static void benchmark(size_t particleCount, int frames = 20);
+
+    protected:
+        // SoA stav castic, polia maju velkost capacity
+        std::vector<float> positionX, positionY, positionZ;
+        std::vector<float> velocityX, velocityY, velocityZ;
+        std::vector<float> age, ageRate;       // ageRate = 1 / zivotnost
+        std::vector<float> size;
+        std::vector<uint32_t> color;
+        size_t count = 0;
+        size_t capacity;
+
+        float emitAccumulator = 0.0f;
+        uint32_t spawnCounter = 0;             // Zaklad nahodnych cisel dalsej davky
+
+        // Svetovy AABB stredov zivych castic a najvacsia velkost (plati, ked count > 0)
+        glm::vec3 liveMin = glm::vec3(0.0f), liveMax = glm::vec3(0.0f);
+        float liveSize = 0.0f;
+        void publishBounds();
+
+        // GL objekty sa vytvoria az pri prvom vykresleni (simulacia funguje aj bez kontextu)
+        bool gpuInitialized = false;
+        GLuint vao = 0;
+        GLuint buffer = 0;
+        ppgso::Shader::Uniform<glm::mat4> particleView, particleProjection;
+        void createGpuResources();
+
+        static const int BLOCK = 1024;
+        void simulateBlock(size_t first, size_t n, float deltaTime);
+        void compact();
+    };
+
+} // namespace ppgso
+
+#endif //PPGSO_PARTICLE_SYSTEM_H
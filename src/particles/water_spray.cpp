@@ -2,4 +2,26 @@
 // Created by mrepi on 20. 11. 2025.
 //
 
-#include "water_spray.h"
\ No newline at end of file
+#include "water_spray.h"
+
+namespace ppgso {
+
+    WaterSpray::WaterSpray(size_t capacity) : ParticleSystem(capacity, "WaterSpray") {
+        // Kuzel kvapiek smerom hore, padaju spat plnou gravitaciou a rozplyvaju sa
+        emitterExtent = glm::vec3(0.3f, 0.1f, 0.3f);
+        emissionRate = 8000.0f;
+        velocity = glm::vec3(0.0f, 6.0f, 0.0f);
+        velocitySpread = glm::vec3(1.5f, 1.5f, 1.5f);
+        acceleration = glm::vec3(0.0f, -9.81f, 0.0f);
+        drag = 0.3f;
+        sizeGrowth = 0.1f;
+        lifetimeMin = 0.8f;
+        lifetimeMax = 1.6f;
+        sizeMin = 0.04f;
+        sizeMax = 0.1f;
+        colorMin = glm::vec4(0.55f, 0.70f, 0.90f, 0.25f);
+        colorMax = glm::vec4(0.90f, 0.95f, 1.00f, 0.45f);
+        additive = true;
+    }
+
+} // namespace ppgso
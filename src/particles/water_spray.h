@@ -5,4 +5,18 @@
 #ifndef PPGSO_WATER_SPRAY_H
 #define PPGSO_WATER_SPRAY_H
 
-#endif //PPGSO_WATER_SPRAY_H
\ No newline at end of file
+#include "particle_system.h"
+
+namespace ppgso {
+
+    /**
+     * WaterSpray - Vodna trieste (vodopad, vlny na pobrezi), aditivne miesana
+     */
+    class WaterSpray : public ParticleSystem {
+    public:
+        explicit WaterSpray(size_t capacity = 50000);
+    };
+
+} // namespace ppgso
+
+#endif //PPGSO_WATER_SPRAY_H
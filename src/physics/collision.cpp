@@ -2,4 +2,113 @@
 // Created by mrepi on 20. 11. 2025.
 //
 
-#include "collision.h"
\ No newline at end of file
+#include "collision.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ppgso {
+
+    void GroundPlane::collide(const RigidBodyStore& bodies, const std::vector<uint32_t>& slots,
+                              std::vector<Contact>& contacts) const {
+        for (uint32_t slot : slots) {
+            float depth = height + bodies.radii[slot] - bodies.positions[slot].y;
+            if (depth > 0.0f) contacts.push_back({slot, Contact::STATIC, glm::vec3(0.0f, 1.0f, 0.0f), depth});
+        }
+    }
+
+    void CollisionDetector::detect(const RigidBodyStore& bodies, std::vector<Contact>& contacts) {
+        contacts.clear();
+        pairTests = 0;
+        const uint32_t count = (uint32_t)bodies.size();
+        const auto& positions = bodies.positions;
+        const auto& radii = bodies.radii;
+        const auto& inverseMasses = bodies.inverseMasses;
+        const auto& awake = bodies.awake;
+
+        // Bunky mriezky maju velkost najvacsieho priemeru, dotykat sa mozu len gule zo susednych buniek
+        float maxRadius = 0.0f;
+        for (uint32_t i = 0; i < count; i++) maxRadius = std::max(maxRadius, radii[i]);
+        const float inverseCell = 1.0f / std::max(2.0f * maxRadius, 1e-3f);
+
+        // Kluc bunky (x, y, z) po 21 bitov, lexikograficke poradie = poradie klucov
+        static_assert(CELL_OFFSET == 1 << 20, "kluc ma 21 bitov na os");
+        auto cellKey = [](int x, int y, int z) {
+            return (uint64_t)(uint32_t)(x + CELL_OFFSET) << 42 | (uint64_t)(uint32_t)(y + CELL_OFFSET) << 21
+                 | (uint64_t)(uint32_t)(z + CELL_OFFSET);
+        };
+        entries.resize(count);
+        for (uint32_t i = 0; i < count; i++) {
+            glm::vec3 cell = glm::floor(positions[i] * inverseCell);
+            glm::ivec3 c = glm::clamp(glm::ivec3(cell), glm::ivec3(-CELL_OFFSET), glm::ivec3(CELL_OFFSET - 1));
+            entries[i] = {cellKey(c.x, c.y, c.z), i};
+        }
+
+        // Telesa zoradene podla bunky, v bunke podla slotu, poradie je vzdy rovnake
+        std::sort(entries.begin(), entries.end());
+        cells.clear();
+        for (uint32_t i = 0; i < count; i++) {
+            if (cells.empty() || cells.back().key != entries[i].first) cells.push_back({entries[i].first, i, i});
+            cells.back().end = i + 1;
+        }
+
+        auto test = [&](uint32_t a, uint32_t b) {
+            // Aspon jedno teleso musi byt hore (staticke nie je nikdy)
+            if (!awake[a] && !awake[b]) return;
+            pairTests++;
+
+            glm::vec3 delta = positions[a] - positions[b];
+            float distanceSquared = glm::dot(delta, delta);
+            float radius = radii[a] + radii[b];
+            if (distanceSquared >= radius * radius) return;
+
+            // a je vzdy dynamicke teleso, pri dvoch dynamickych ten s mensim slotom
+            float distance = std::sqrt(distanceSquared);
+            glm::vec3 normal = distance > 1e-6f ? delta / distance : glm::vec3(0.0f, 1.0f, 0.0f);
+            bool swap = inverseMasses[a] == 0.0f || (inverseMasses[b] != 0.0f && b < a);
+            if (swap) contacts.push_back({b, a, -normal, radius - distance});
+            else contacts.push_back({a, b, normal, radius - distance});
+        };
+        auto testCells = [&](const Cell& first, const Cell& second) {
+            for (uint32_t i = first.begin; i < first.end; i++) {
+                for (uint32_t j = second.begin; j < second.end; j++) test(entries[i].second, entries[j].second);
+            }
+        };
+
+        // Susedne rady buniek s vacsim klucom (dx, dy) = (0, 1), (1, -1), (1, 0), (1, 1), v kazdej
+        // tri bunky z - 1 .. z + 1. Bunky idu vzostupne, takze kurzory rad sa hybu len dopredu
+        const uint64_t rowOffsets[4] = {
+            (uint64_t)1 << 21,
+            ((uint64_t)1 << 42) - ((uint64_t)1 << 21),
+            (uint64_t)1 << 42,
+            ((uint64_t)1 << 42) + ((uint64_t)1 << 21),
+        };
+        size_t cursors[4] = {0, 0, 0, 0};
+
+        for (size_t index = 0; index < cells.size(); index++) {
+            const Cell& cell = cells[index];
+
+            // Dvojice v bunke a so susedom z + 1 v tom istom rade
+            for (uint32_t i = cell.begin; i < cell.end; i++) {
+                for (uint32_t j = i + 1; j < cell.end; j++) test(entries[i].second, entries[j].second);
+            }
+            if (index + 1 < cells.size() && cells[index + 1].key == cell.key + 1) testCells(cell, cells[index + 1]);
+
+            for (int row = 0; row < 4; row++) {
+                const uint64_t first = cell.key + rowOffsets[row] - 1;
+                size_t& cursor = cursors[row];
+                while (cursor < cells.size() && cells[cursor].key < first) cursor++;
+                for (size_t other = cursor; other < cells.size() && cells[other].key <= first + 2; other++) {
+                    testCells(cell, cells[other]);
+                }
+            }
+        }
+
+        // Staticka geometria len pre telesa, ktore sa hybu
+        awakeSlots.clear();
+        for (uint32_t i = 0; i < count; i++) {
+            if (awake[i]) awakeSlots.push_back(i);
+        }
+        for (auto& collider : colliders) collider->collide(bodies, awakeSlots, contacts);
+    }
+
+} // namespace ppgso
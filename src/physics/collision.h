@@ -5,4 +5,88 @@
 #ifndef PPGSO_COLLISION_H
 #define PPGSO_COLLISION_H
 
-#endif //PPGSO_COLLISION_H
\ No newline at end of file
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "rigid_body.h"
+
+namespace ppgso {
+
+    /**
+     * Contact - Prienik dvoch teles alebo telesa so statickou geometriou
+     * Normala smeruje od b k a, posunutim a o depth pozdlz normaly sa prienik zrusi
+     */
+    struct Contact {
+        static const uint32_t STATIC = 0xffffffffu;
+
+        uint32_t a;          // Slot dynamickeho telesa
+        uint32_t b;          // Slot druheho telesa alebo STATIC
+        glm::vec3 normal;
+        float depth;
+    };
+
+    /**
+     * Collider - Staticka geometria sveta (zem, teren), s ktorou koliduju gule teles
+     */
+    class Collider {
+    public:
+        virtual ~Collider() = default;
+
+        // Prida kontakty pre telesa zo slots (dynamicke a hore), vsetky v jednej davke
+        virtual void collide(const RigidBodyStore& bodies, const std::vector<uint32_t>& slots,
+                             std::vector<Contact>& contacts) const = 0;
+    };
+
+    /**
+     * GroundPlane - Nekonecna vodorovna rovina y = height
+     */
+    class GroundPlane : public Collider {
+    public:
+        explicit GroundPlane(float height = 0.0f) : height(height) {}
+
+        void collide(const RigidBodyStore& bodies, const std::vector<uint32_t>& slots,
+                     std::vector<Contact>& contacts) const override;
+
+        float height;
+    };
+
+    /**
+     * CollisionDetector - Kontakty medzi gulami a so statickymi colliderami
+     *
+     * Dvojice teles hlada v mriezke s bunkou velkosti najvacsieho priemeru: telesa sa
+     * zoradia podla kluca bunky a kazda bunka sa porovna sama so sebou a s 13 susedmi
+     * s vacsim klucom (kazda dvojica buniek raz, bez hladania - kurzory idu len dopredu). Dvojice dvoch spiacich alebo dvoch statickych teles sa preskocia.
+     * Kontakty su v poradi, ktore zavisi len od poloh teles, nie od vlakien.
+     *
+     * Jedno velke teleso zvacsi bunky pre vsetky, velka staticka geometria patri do Collider.
+     */
+    class CollisionDetector {
+    public:
+        void addCollider(std::shared_ptr<Collider> collider) { colliders.push_back(std::move(collider)); }
+        void clearColliders() { colliders.clear(); }
+
+        // Nahradi obsah contacts
+        void detect(const RigidBodyStore& bodies, std::vector<Contact>& contacts);
+
+        size_t getPairTests() const { return pairTests; }
+
+    private:
+        std::vector<std::shared_ptr<Collider>> colliders;
+        struct Cell {
+            uint64_t key;
+            uint32_t begin, end;                // Rozsah v entries
+        };
+        static const int CELL_OFFSET = 1 << 20;
+
+        std::vector<std::pair<uint64_t, uint32_t>> entries;   // (kluc bunky, slot) zoradene
+        std::vector<Cell> cells;                // Neprazdne bunky zoradene podla kluca
+        std::vector<uint32_t> awakeSlots;
+        size_t pairTests = 0;
+    };
+
+} // namespace ppgso
+
+#endif //PPGSO_COLLISION_H
@@ -2,4 +2,30 @@
 // Created by mrepi on 20. 11. 2025.
 //
 
-#include "force_system.h"
\ No newline at end of file
+#include "force_system.h"
+#include <algorithm>
+
+namespace ppgso {
+
+    void ForceSystem::integrateVelocities(RigidBodyStore& bodies, float deltaTime, bool parallel) {
+        for (auto& generator : generators) generator(bodies, deltaTime);
+
+        const int count = (int)bodies.size();
+        const glm::vec3 dv = gravity * deltaTime;
+        const float damping = std::max(0.0f, 1.0f - linearDamping * deltaTime);
+        glm::vec3* velocities = bodies.velocities.data();
+        glm::vec3* forces = bodies.forces.data();
+        const float* inverseMasses = bodies.inverseMasses.data();
+        const uint8_t* awake = bodies.awake.data();
+
+        // Kazde teleso samostatne, poradie vlakien nemeni vysledok
+        #pragma omp parallel for schedule(static) if(parallel && count > 4096)
+        for (int i = 0; i < count; i++) {
+            if (awake[i]) {
+                velocities[i] = (velocities[i] + dv + forces[i] * (inverseMasses[i] * deltaTime)) * damping;
+            }
+            forces[i] = glm::vec3(0.0f);
+        }
+    }
+
+} // namespace ppgso
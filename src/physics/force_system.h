@@ -5,4 +5,43 @@
 #ifndef PPGSO_FORCE_SYSTEM_H
 #define PPGSO_FORCE_SYSTEM_H
 
-#endif //PPGSO_FORCE_SYSTEM_H
\ No newline at end of file
+#include <functional>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "rigid_body.h"
+
+namespace ppgso {
+
+    /**
+     * ForceSystem - Sily posobiace na telesa a integracia rychlosti a pozicii
+     *
+     * Generatory (vietor, vztlak...) sa volaju na zaciatku kazdeho pevneho kroku a pridavaju
+     * sily cez RigidBodyStore::applyForce. Potom sa pre vsetky hore telesa v jednom
+     * prechode polami pripocita gravitacia, akumulovane sily a tlmenie.
+     */
+    class ForceSystem {
+    public:
+        using Generator = std::function<void(RigidBodyStore& bodies, float deltaTime)>;
+
+        glm::vec3 gravity = glm::vec3(0.0f, -9.81f, 0.0f);
+        float linearDamping = 0.05f;            // Podiel rychlosti strateny za sekundu
+
+        void addGenerator(Generator generator) { generators.push_back(std::move(generator)); }
+        void clearGenerators() { generators.clear(); }
+
+        // Zavola generatory, v = (v + (g + F / m) dt) * tlmenie, vynuluje sily
+        void integrateVelocities(RigidBodyStore& bodies, float deltaTime, bool parallel = true);
+
+        // p += v dt pre slot (PhysicsWorld ho vola po vyrieseni kontaktov ostrova)
+        static void integratePosition(RigidBodyStore& bodies, uint32_t slot, float deltaTime) {
+            bodies.positions[slot] += bodies.velocities[slot] * deltaTime;
+        }
+
+    private:
+        std::vector<Generator> generators;
+    };
+
+} // namespace ppgso
+
+#endif //PPGSO_FORCE_SYSTEM_H
@@ -0,0 +1,261 @@
+#include "physics_world.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <ppgso/timing.h>
+
+namespace ppgso {
+
+    static const uint32_t NONE = 0xffffffffu;
+
+    PhysicsWorld::PhysicsWorld(float fixedDelta, int maxSubsteps)
+        : fixedDelta(fixedDelta)
+        , maxSubsteps(maxSubsteps)
+    {
+    }
+
+    int PhysicsWorld::update(float frameDelta) {
+        accumulator += frameDelta;
+
+        int steps = 0;
+        while (accumulator >= fixedDelta && steps < maxSubsteps) {
+            step();
+            accumulator -= fixedDelta;
+            steps++;
+        }
+
+        // Ak simulacia nestiha, zvysny cas sa zahodi (spomalenie namiesto hromadenia krokov)
+        if (accumulator >= fixedDelta) accumulator = 0.0f;
+
+        alpha = accumulator / fixedDelta;
+        stats.steps = steps;
+        return steps;
+    }
+
+    void PhysicsWorld::step() {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        // Interpolacia vychadza z polohy pred krokom, aj pre telesa, ktore sa nehybu
+        bodies.previousPositions = bodies.positions;
+
+        forces.integrateVelocities(bodies, fixedDelta, parallel);
+        collisions.detect(bodies, contacts);
+        buildIslands();
+
+        // Cielova rychlost odrazu z rychlosti pred riesenim, impulzy od nuly
+        normalImpulses.assign(contacts.size(), 0.0f);
+        tangentImpulses.assign(contacts.size(), glm::vec3(0.0f));
+        bounceVelocities.resize(contacts.size());
+        for (size_t i = 0; i < contacts.size(); i++) {
+            const Contact& c = contacts[i];
+            glm::vec3 relative = bodies.velocities[c.a];
+            float restitution = bodies.restitutions[c.a];
+            if (c.b != Contact::STATIC) {
+                relative -= bodies.velocities[c.b];
+                restitution = std::max(restitution, bodies.restitutions[c.b]);
+            }
+            float approach = glm::dot(relative, c.normal);
+            bounceVelocities[i] = approach < -restitutionThreshold ? -restitution * approach : 0.0f;
+        }
+
+        // Ostrovy nezdielaju dynamicke telesa ani kontakty, staticke telesa sa len citaju
+        const int islands = (int)islandBodyStart.size() - 1;
+        #pragma omp parallel for schedule(dynamic, 16) if(parallel && islands > 1)
+        for (int island = 0; island < islands; island++) {
+            solveIsland((uint32_t)island);
+        }
+
+        stats.bodies = (int)bodies.size();
+        stats.awake = (int)std::count(bodies.awake.begin(), bodies.awake.end(), 1);
+        stats.contacts = (int)contacts.size();
+        stats.islands = islands;
+        stats.largestIsland = 0;
+        for (int island = 0; island < islands; island++) {
+            stats.largestIsland = std::max(stats.largestIsland, (int)(islandBodyStart[island + 1] - islandBodyStart[island]));
+        }
+        stats.pairTests = collisions.getPairTests();
+
+        auto end = std::chrono::high_resolution_clock::now();
+        stats.stepMs = std::chrono::duration<float, std::milli>(end - start).count();
+    }
+
+    uint32_t PhysicsWorld::find(uint32_t slot) {
+        // Skracovanie cesty na polovicu
+        while (parent[slot] != slot) {
+            parent[slot] = parent[parent[slot]];
+            slot = parent[slot];
+        }
+        return slot;
+    }
+
+    void PhysicsWorld::unite(uint32_t a, uint32_t b) {
+        // Korenom je mensi slot, vysledok nezavisi od poradia spajania
+        a = find(a);
+        b = find(b);
+        if (a < b) parent[b] = a;
+        else if (b < a) parent[a] = b;
+    }
+
+    void PhysicsWorld::buildIslands() {
+        const uint32_t count = (uint32_t)bodies.size();
+        parent.resize(count);
+        for (uint32_t i = 0; i < count; i++) parent[i] = i;
+
+        // Do ostrovov idu telesa hore a spiace telesa, ktorych sa telesa hore dotykaju
+        islandOf.assign(count, NONE);
+        for (const Contact& c : contacts) {
+            if (c.b == Contact::STATIC || bodies.inverseMasses[c.b] == 0.0f) continue;
+            unite(c.a, c.b);
+            islandOf[c.a] = islandOf[c.b] = 0;
+        }
+
+        // Cisla ostrovov podla najmensieho slotu, pocty teles
+        rootIsland.assign(count, NONE);
+        islandBodyStart.clear();
+        for (uint32_t i = 0; i < count; i++) {
+            if (!bodies.awake[i] && islandOf[i] == NONE) continue;
+            uint32_t root = find(i);
+            if (rootIsland[root] == NONE) {
+                rootIsland[root] = (uint32_t)islandBodyStart.size();
+                islandBodyStart.push_back(0);
+            }
+            islandOf[i] = rootIsland[root];
+            islandBodyStart[islandOf[i]]++;
+        }
+        const uint32_t islands = (uint32_t)islandBodyStart.size();
+
+        // Telesa zoradene podla ostrova (counting sort, v ostrove podla slotu)
+        uint32_t offset = 0;
+        for (uint32_t island = 0; island < islands; island++) {
+            uint32_t size = islandBodyStart[island];
+            islandBodyStart[island] = offset;
+            offset += size;
+        }
+        islandBodyStart.push_back(offset);
+        islandBodies.resize(offset);
+        fill.assign(islandBodyStart.begin(), islandBodyStart.end() - 1);
+        for (uint32_t i = 0; i < count; i++) {
+            if (islandOf[i] != NONE) islandBodies[fill[islandOf[i]]++] = i;
+        }
+
+        // Kontakty podla ostrova dynamickeho telesa a, v ostrove v poradi detekcie
+        islandContactStart.assign(islands + 1, 0);
+        for (const Contact& c : contacts) islandContactStart[islandOf[c.a] + 1]++;
+        for (uint32_t island = 0; island < islands; island++) {
+            islandContactStart[island + 1] += islandContactStart[island];
+        }
+        fill.assign(islandContactStart.begin(), islandContactStart.end() - 1);
+        islandContacts.resize(contacts.size());
+        for (uint32_t i = 0; i < (uint32_t)contacts.size(); i++) {
+            islandContacts[fill[islandOf[contacts[i].a]]++] = i;
+        }
+    }
+
+    void PhysicsWorld::solveIsland(uint32_t island) {
+        auto& velocities = bodies.velocities;
+        const auto& inverseMasses = bodies.inverseMasses;
+        const uint32_t* bodyBegin = islandBodies.data() + islandBodyStart[island];
+        const uint32_t* bodyEnd = islandBodies.data() + islandBodyStart[island + 1];
+        const uint32_t* contactBegin = islandContacts.data() + islandContactStart[island];
+        const uint32_t* contactEnd = islandContacts.data() + islandContactStart[island + 1];
+
+        // Spiace telesa v ostrove sa zobudia spolu s nim
+        for (const uint32_t* body = bodyBegin; body != bodyEnd; body++) {
+            if (!bodies.awake[*body]) {
+                bodies.awake[*body] = 1;
+                bodies.sleepTimers[*body] = 0.0f;
+            }
+        }
+
+        const float biasFactor = baumgarte / fixedDelta;
+        for (int iteration = 0; iteration < solverIterations; iteration++) {
+            for (const uint32_t* index = contactBegin; index != contactEnd; index++) {
+                const Contact& c = contacts[*index];
+                const bool dynamicB = c.b != Contact::STATIC && inverseMasses[c.b] != 0.0f;
+                const float inverseA = inverseMasses[c.a];
+                const float inverseB = dynamicB ? inverseMasses[c.b] : 0.0f;
+                const float inverseSum = inverseA + inverseB;
+                const glm::vec3 velocityB = c.b != Contact::STATIC ? velocities[c.b] : glm::vec3(0.0f);
+
+                // Normala: rychlost oddalovania aspon na odraz alebo opravu prieniku
+                glm::vec3 relative = velocities[c.a] - velocityB;
+                float target = std::max(bounceVelocities[*index], biasFactor * std::max(c.depth - penetrationSlop, 0.0f));
+                float lambda = (target - glm::dot(relative, c.normal)) / inverseSum;
+                float previous = normalImpulses[*index];
+                normalImpulses[*index] = std::max(previous + lambda, 0.0f);
+                glm::vec3 impulse = c.normal * (normalImpulses[*index] - previous);
+                velocities[c.a] += impulse * inverseA;
+                if (dynamicB) velocities[c.b] -= impulse * inverseB;
+
+                // Trenie: tangencialny impulz obmedzeny Coulombovym kuzelom
+                relative = velocities[c.a] - (dynamicB ? velocities[c.b] : velocityB);
+                glm::vec3 tangent = relative - c.normal * glm::dot(relative, c.normal);
+                float friction = c.b != Contact::STATIC ? 0.5f * (bodies.frictions[c.a] + bodies.frictions[c.b])
+                                                        : bodies.frictions[c.a];
+                glm::vec3 previousTangent = tangentImpulses[*index];
+                glm::vec3 accumulated = previousTangent - tangent / inverseSum;
+                float limit = friction * normalImpulses[*index];
+                float length = glm::length(accumulated);
+                if (length > limit) accumulated *= limit / length;
+                tangentImpulses[*index] = accumulated;
+                impulse = accumulated - previousTangent;
+                velocities[c.a] += impulse * inverseA;
+                if (dynamicB) velocities[c.b] -= impulse * inverseB;
+            }
+        }
+
+        // Integracia polohy a spanok celeho ostrova naraz
+        float minSleepTimer = sleepTime;
+        const float sleepVelocitySquared = sleepVelocity * sleepVelocity;
+        for (const uint32_t* body = bodyBegin; body != bodyEnd; body++) {
+            ForceSystem::integratePosition(bodies, *body, fixedDelta);
+            float speedSquared = glm::dot(velocities[*body], velocities[*body]);
+            bodies.sleepTimers[*body] = speedSquared < sleepVelocitySquared ? bodies.sleepTimers[*body] + fixedDelta : 0.0f;
+            minSleepTimer = std::min(minSleepTimer, bodies.sleepTimers[*body]);
+        }
+        if (minSleepTimer >= sleepTime) {
+            for (const uint32_t* body = bodyBegin; body != bodyEnd; body++) {
+                bodies.awake[*body] = 0;
+                velocities[*body] = glm::vec3(0.0f);
+            }
+        }
+    }
+
+    void PhysicsWorld::benchmark(int bodyCount, int steps, uint32_t seed) {
+        // Gule padaju do ohradeneho stvorca a usadia sa v kope
+        auto setup = [&](PhysicsWorld& world) {
+            std::mt19937 rng(seed);
+            std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+            float extent = 0.6f * std::sqrt((float)bodyCount);
+            world.collisions.addCollider(std::make_shared<GroundPlane>(0.0f));
+            for (int i = 0; i < bodyCount; i++) {
+                glm::vec3 position((2.0f * unit(rng) - 1.0f) * extent, 1.0f + 10.0f * unit(rng), (2.0f * unit(rng) - 1.0f) * extent);
+                float radius = 0.3f + 0.2f * unit(rng);
+                auto handle = world.bodies.create(position, radius, radius * radius * radius);
+                world.bodies.setVelocity(handle, glm::vec3(unit(rng) - 0.5f, 0.0f, unit(rng) - 0.5f));
+            }
+        };
+
+        PhysicsWorld serial, parallel;
+        serial.parallel = false;
+        setup(serial);
+        setup(parallel);
+
+        float serialMs = averageTime(steps, [&](int) { serial.step(); });
+        float parallelMs = averageTime(steps, [&](int) { parallel.step(); });
+
+        bool identical = std::memcmp(serial.bodies.positions.data(), parallel.bodies.positions.data(),
+                                     serial.bodies.positions.size() * sizeof(glm::vec3)) == 0;
+
+        const Stats& stats = parallel.getStats();
+        std::cout << "Physics, " << bodyCount << " bodies, " << steps << " steps (ms per step):" << std::endl;
+        std::cout << "  serial:    " << serialMs << std::endl;
+        std::cout << "  parallel:  " << parallelMs << std::endl;
+        std::cout << "  last step: " << stats.awake << " awake, " << stats.contacts << " contacts, "
+                  << stats.islands << " islands (largest " << stats.largestIsland << ")" << std::endl;
+        std::cout << "  serial and parallel results " << (identical ? "identical" : "DIFFERENT") << std::endl;
+    }
+
+} // namespace ppgso
@@ -0,0 +1,106 @@
+#ifndef PPGSO_PHYSICS_WORLD_H
+#define PPGSO_PHYSICS_WORLD_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "rigid_body.h"
+#include "force_system.h"
+#include "collision.h"
+
+namespace ppgso {
+
+    /**
+     * PhysicsWorld - Simulacia teles s pevnym casovym krokom
+     *
+     * update() dostane premenlivy cas frame, prida ho do akumulatora a spusti tolko pevnych
+     * krokov fixedDelta, kolko sa do neho zmesti (najviac maxSubsteps, zvysok sa zahodi).
+     * Zostatok urcuje alpha, vykreslenie interpoluje medzi poslednymi dvoma krokmi.
+     *
+     * Jeden krok: sily a gravitacia -> kontakty -> ostrovy -> riesenie ostrovov. Ostrov su
+     * telesa spojene kontaktmi (union-find, staticka geometria ostrovy nespaja). Ostrovy
+     * nezdielaju ziadne dynamicke teleso, preto sa riesia paralelne, kazdy sekvencnymi
+     * impulzmi v pevnom poradi kontaktov - vysledok nezavisi od poctu vlakien.
+     *
+     * Ostrov, ktoreho vsetky telesa su sleepTime sekund takmer v pokoji, zaspi cely. Spiace
+     * telesa sa neintegruju ani netestuju medzi sebou, zobudi ich kontakt s telesom, ktore
+     * je hore (cely ostrov), alebo sila / impulz / zmena polohy.
+     */
+    class PhysicsWorld {
+    public:
+        struct Stats {
+            int steps = 0;             // Pevne kroky v poslednom update()
+            int bodies = 0;
+            int awake = 0;
+            int contacts = 0;
+            int islands = 0;
+            int largestIsland = 0;
+            size_t pairTests = 0;
+            float stepMs = 0.0f;       // Cas posledneho kroku
+        };
+
+        explicit PhysicsWorld(float fixedDelta = 1.0f / 60.0f, int maxSubsteps = 5);
+
+        RigidBodyStore bodies;
+        ForceSystem forces;
+        CollisionDetector collisions;
+
+        // Nastavenia solvera
+        int solverIterations = 8;
+        float baumgarte = 0.2f;                // Podiel prieniku opraveny za krok
+        float penetrationSlop = 0.01f;         // Prienik, ktory sa toleruje (stabilne stohy)
+        float restitutionThreshold = 1.0f;     // Pomalsie narazy sa neodrazaju
+        float sleepVelocity = 0.08f;
+        float sleepTime = 0.5f;
+        bool parallel = true;
+
+        // Premenlivy cas frame, vrati pocet vykonanych pevnych krokov
+        int update(float frameDelta);
+
+        // Jeden pevny krok fixedDelta
+        void step();
+
+        // Poloha na vykreslenie, medzi poslednymi dvoma krokmi podla zostatku akumulatora
+        glm::vec3 getRenderPosition(RigidBodyStore::Handle handle) const {
+            return bodies.getInterpolatedPosition(handle, alpha);
+        }
+
+        float getFixedDelta() const { return fixedDelta; }
+        float getAlpha() const { return alpha; }
+        const Stats& getStats() const { return stats; }
+
+        // Zhodi bodyCount gul na zem, odmeria krok seriovo aj paralelne z rovnakeho stavu
+        // a porovna vysledne polohy (musia byt bitovo rovnake)
+        static void benchmark(int bodyCount, int steps = 300, uint32_t seed = 1);
+
+    private:
+        float fixedDelta;
+        int maxSubsteps;
+        float accumulator = 0.0f;
+        float alpha = 0.0f;
+        Stats stats;
+
+        std::vector<Contact> contacts;
+
+        // Akumulovane impulzy a cielova rychlost odrazu podla kontaktu
+        std::vector<float> normalImpulses;
+        std::vector<glm::vec3> tangentImpulses;
+        std::vector<float> bounceVelocities;
+
+        // Ostrovy: telesa a kontakty zoradene podla ostrova, ostrov i je [start[i], start[i + 1])
+        std::vector<uint32_t> parent;          // Union-find podla slotu
+        std::vector<uint32_t> islandOf;        // Ostrov slotu alebo NONE
+        std::vector<uint32_t> islandBodies, islandBodyStart;
+        std::vector<uint32_t> islandContacts, islandContactStart;
+        std::vector<uint32_t> rootIsland, fill;  // Pomocne polia buildIslands
+
+        uint32_t find(uint32_t slot);
+        void unite(uint32_t a, uint32_t b);
+        void buildIslands();
+        void solveIsland(uint32_t island);
+    };
+
+} // namespace ppgso
+
+#endif // PPGSO_PHYSICS_WORLD_H
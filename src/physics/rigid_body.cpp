@@ -2,4 +2,120 @@
 // Created by mrepi on 20. 11. 2025.
 //
 
-#include "rigid_body.h"
\ No newline at end of file
+#include "rigid_body.h"
+
+namespace ppgso {
+
+    RigidBodyStore::Handle RigidBodyStore::create(const glm::vec3& position, float radius, float mass) {
+        Handle handle;
+        if (!freeHandles.empty()) {
+            handle = freeHandles.back();
+            freeHandles.pop_back();
+        } else {
+            handle = (Handle)slotOf.size();
+            slotOf.push_back(0);
+        }
+
+        slotOf[handle] = (uint32_t)handleOf.size();
+        handleOf.push_back(handle);
+        positions.push_back(position);
+        previousPositions.push_back(position);
+        velocities.push_back(glm::vec3(0.0f));
+        forces.push_back(glm::vec3(0.0f));
+        inverseMasses.push_back(mass > 0.0f ? 1.0f / mass : 0.0f);
+        radii.push_back(radius);
+        restitutions.push_back(0.2f);
+        frictions.push_back(0.5f);
+        sleepTimers.push_back(0.0f);
+        awake.push_back(mass > 0.0f ? 1 : 0);
+        return handle;
+    }
+
+    void RigidBodyStore::destroy(Handle handle) {
+        // Posledne teleso sa presunie do uvolneneho slotu
+        uint32_t slot = slotOf[handle];
+        uint32_t last = (uint32_t)handleOf.size() - 1;
+        if (slot != last) {
+            handleOf[slot] = handleOf[last];
+            slotOf[handleOf[slot]] = slot;
+            positions[slot] = positions[last];
+            previousPositions[slot] = previousPositions[last];
+            velocities[slot] = velocities[last];
+            forces[slot] = forces[last];
+            inverseMasses[slot] = inverseMasses[last];
+            radii[slot] = radii[last];
+            restitutions[slot] = restitutions[last];
+            frictions[slot] = frictions[last];
+            sleepTimers[slot] = sleepTimers[last];
+            awake[slot] = awake[last];
+        }
+
+        handleOf.pop_back();
+        positions.pop_back();
+        previousPositions.pop_back();
+        velocities.pop_back();
+        forces.pop_back();
+        inverseMasses.pop_back();
+        radii.pop_back();
+        restitutions.pop_back();
+        frictions.pop_back();
+        sleepTimers.pop_back();
+        awake.pop_back();
+
+        slotOf[handle] = NONE;
+        freeHandles.push_back(handle);
+    }
+
+    void RigidBodyStore::clear() {
+        handleOf.clear();
+        slotOf.clear();
+        freeHandles.clear();
+        positions.clear();
+        previousPositions.clear();
+        velocities.clear();
+        forces.clear();
+        inverseMasses.clear();
+        radii.clear();
+        restitutions.clear();
+        frictions.clear();
+        sleepTimers.clear();
+        awake.clear();
+    }
+
+    void RigidBodyStore::setPosition(Handle handle, const glm::vec3& position) {
+        // Teleporta, bez interpolacie zo starej pozicie
+        uint32_t slot = slotOf[handle];
+        positions[slot] = position;
+        previousPositions[slot] = position;
+        wake(handle);
+    }
+
+    void RigidBodyStore::setVelocity(Handle handle, const glm::vec3& velocity) {
+        velocities[slotOf[handle]] = velocity;
+        wake(handle);
+    }
+
+    glm::vec3 RigidBodyStore::getInterpolatedPosition(Handle handle, float alpha) const {
+        uint32_t slot = slotOf[handle];
+        return glm::mix(previousPositions[slot], positions[slot], alpha);
+    }
+
+    void RigidBodyStore::applyForce(Handle handle, const glm::vec3& force) {
+        forces[slotOf[handle]] += force;
+        wake(handle);
+    }
+
+    void RigidBodyStore::applyImpulse(Handle handle, const glm::vec3& impulse) {
+        uint32_t slot = slotOf[handle];
+        velocities[slot] += impulse * inverseMasses[slot];
+        wake(handle);
+    }
+
+    void RigidBodyStore::wake(Handle handle) {
+        uint32_t slot = slotOf[handle];
+        if (inverseMasses[slot] == 0.0f) return;
+        awake[slot] = 1;
+        sleepTimers[slot] = 0.0f;
+    }
+
+} // namespace ppgso
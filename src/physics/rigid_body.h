@@ -5,4 +5,76 @@
 #ifndef PPGSO_RIGID_BODY_H
 #define PPGSO_RIGID_BODY_H
 
-#endif //PPGSO_RIGID_BODY_H
\ No newline at end of file
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace ppgso {
+
+    /**
+     * RigidBodyStore - Stav vsetkych teles v suvislych poliach (SoA)
+     *
+     * Telesa su gule (pozicia, rychlost, polomer), rotacia sa nesimuluje. Kazda vlastnost
+     * je samostatne pole indexovane slotom, zive telesa su vzdy [0, size()). Zrusene
+     * teleso nahradi posledne (swap-remove), handle zostava stabilny.
+     *
+     * Poradie slotov zavisi len od poradia create() / destroy(), nie od vlakien, takze
+     * simulacia nad nimi je pri rovnakom vstupe vzdy rovnaka.
+     *
+     * Staticke teleso ma hmotnost 0 (nekonecnu), nehybe sa a nikdy nie je "hore".
+     */
+    class RigidBodyStore {
+    public:
+        using Handle = uint32_t;
+        static const Handle NONE = 0xffffffffu;
+
+        // mass 0 = staticke teleso
+        Handle create(const glm::vec3& position, float radius, float mass = 1.0f);
+        void destroy(Handle handle);
+        void clear();
+
+        void setPosition(Handle handle, const glm::vec3& position);
+        void setVelocity(Handle handle, const glm::vec3& velocity);
+        const glm::vec3& getPosition(Handle handle) const { return positions[slotOf[handle]]; }
+        const glm::vec3& getVelocity(Handle handle) const { return velocities[slotOf[handle]]; }
+
+        // Pozicia medzi poslednymi dvoma krokmi, alpha 0 = predchadzajuci krok, 1 = posledny
+        glm::vec3 getInterpolatedPosition(Handle handle, float alpha) const;
+
+        // Materialy kontaktu (pouzije sa vacsia restitucia a priemer trenia oboch teles)
+        void setRestitution(Handle handle, float restitution) { restitutions[slotOf[handle]] = restitution; }
+        void setFriction(Handle handle, float friction) { frictions[slotOf[handle]] = friction; }
+
+        // Sila plati do konca nasledujuceho kroku, impulz zmeni rychlost hned. Oboje zobudi teleso
+        void applyForce(Handle handle, const glm::vec3& force);
+        void applyImpulse(Handle handle, const glm::vec3& impulse);
+
+        void wake(Handle handle);
+        bool isAwake(Handle handle) const { return awake[slotOf[handle]] != 0; }
+        bool isStatic(Handle handle) const { return inverseMasses[slotOf[handle]] == 0.0f; }
+
+        size_t size() const { return handleOf.size(); }
+        uint32_t getSlot(Handle handle) const { return slotOf[handle]; }
+        Handle getHandle(uint32_t slot) const { return handleOf[slot]; }
+
+        // Polia podla slotu, pre ForceSystem, detekciu kolizii a PhysicsWorld
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> previousPositions;
+        std::vector<glm::vec3> velocities;
+        std::vector<glm::vec3> forces;          // Akumulovane do konca kroku
+        std::vector<float> inverseMasses;
+        std::vector<float> radii;
+        std::vector<float> restitutions;
+        std::vector<float> frictions;
+        std::vector<float> sleepTimers;         // Ako dlho je teleso takmer v pokoji
+        std::vector<uint8_t> awake;
+
+    private:
+        std::vector<Handle> handleOf;
+        std::vector<uint32_t> slotOf;           // Podla handle, NONE pre volny handle
+        std::vector<Handle> freeHandles;
+    };
+
+} // namespace ppgso
+
+#endif //PPGSO_RIGID_BODY_H
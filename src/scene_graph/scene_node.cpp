@@ -8,6 +8,7 @@ namespace ppgso {
         , parent(nullptr)
         , visible(true)
         , active(true)
+        , listener(nullptr)
     {
     }
 
@@ -42,6 +43,11 @@ namespace ppgso {
         // Nastav hierarchicku transformaciu
         child->transform.setParent(&this->transform);
 
+        // Podstrom sa prihlasi listeneru stromu (napr. render list sceny)
+        if (listener != nullptr) {
+            child->attachListener(listener);
+        }
+
         onChildAdded(child);
     }
 
@@ -52,6 +58,7 @@ namespace ppgso {
         if (it != children.end()) {
             child->parent = nullptr;
             child->transform.setParent(nullptr);
+            child->detachListener();
             onChildRemoved(child);
             children.erase(it);
         }
@@ -109,13 +116,72 @@ namespace ppgso {
 
     // Viditelnost
     void SceneNode::setVisible(bool visible) {
+        if (this->visible == visible) return;
         this->visible = visible;
+
+        if (listener != nullptr) {
+            listener->onNodeVisibilityChanged(this);
+        }
     }
 
     bool SceneNode::isVisible() const {
         return visible;
     }
 
+    bool SceneNode::isVisibleInHierarchy() const {
+        for (const SceneNode* node = this; node != nullptr; node = node->parent) {
+            if (!node->visible) return false;
+        }
+        return true;
+    }
+
+    // Obalky
+    void SceneNode::setLocalBounds(const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+        transform.setLocalBounds(boundsMin, boundsMax);
+    }
+
+    void SceneNode::clearLocalBounds() {
+        transform.clearLocalBounds();
+    }
+
+    bool SceneNode::isCulled() const {
+        return transform.isCulled();
+    }
+
+    bool SceneNode::isSubtreeCulled() const {
+        return transform.isSubtreeCulled();
+    }
+
+    // Listener
+    void SceneNode::setListener(SceneNodeListener* listener) {
+        if (this->listener == listener) return;
+
+        detachListener();
+        if (listener != nullptr) {
+            attachListener(listener);
+        }
+    }
+
+    void SceneNode::attachListener(SceneNodeListener* listener) {
+        this->listener = listener;
+        listener->onNodeAdded(this);
+
+        for (auto& child : children) {
+            child->attachListener(listener);
+        }
+    }
+
+    void SceneNode::detachListener() {
+        if (listener == nullptr) return;
+
+        listener->onNodeRemoved(this);
+        listener = nullptr;
+
+        for (auto& child : children) {
+            child->detachListener();
+        }
+    }
+
     // Aktivita
     void SceneNode::setActive(bool active) {
         this->active = active;
@@ -138,8 +204,9 @@ namespace ppgso {
     }
 
     void SceneNode::renderRecursive() {
-        if (visible) {
-            render();
+        // Podstrom cely mimo frusta sa preskoci naraz
+        if (visible && !transform.isSubtreeCulled()) {
+            if (!transform.isCulled()) render();
 
             // Render vsetkych deti
             for (auto& child : children) {
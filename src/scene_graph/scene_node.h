@@ -12,6 +12,19 @@ namespace ppgso {
 
     // Forward declaration
     class Scene;
+    class SceneNode;
+
+    /**
+     * SceneNodeListener - Dostava zmeny stromu, ku ktoremu je pripojeny (cez root)
+     * Notifikacie prichadzaju pre kazdy uzol pridaneho / odobraneho podstromu
+     */
+    class SceneNodeListener {
+    public:
+        virtual ~SceneNodeListener() = default;
+        virtual void onNodeAdded(SceneNode* node) = 0;
+        virtual void onNodeRemoved(SceneNode* node) = 0;
+        virtual void onNodeVisibilityChanged(SceneNode* node) = 0;
+    };
 
     /**
      * SceneNode - Uzol v grafe sceny
@@ -45,6 +58,19 @@ namespace ppgso {
         // Viditelnost
         void setVisible(bool visible);
         bool isVisible() const;
+        bool isVisibleInHierarchy() const;   // Uzol aj vsetci predkovia su viditelni
+
+        // Obalka geometrie uzla v jeho lokalnom priestore (AABB), spaja sa do obalok podstromov.
+        // Uzol bez obalky nema vlastnu geometriu a oreze sa len s celym podstromom predka
+        void setLocalBounds(const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+        void clearLocalBounds();
+
+        // Vysledok posledneho frustum cullingu (TransformStore::cull)
+        bool isCulled() const;
+        bool isSubtreeCulled() const;
+
+        // Listener celeho podstromu, nastavuje sa na roote (deti ho dedia pri addChild)
+        void setListener(SceneNodeListener* listener);
 
         // Aktivita (ci sa vola update)
         void setActive(bool active);
@@ -61,10 +87,15 @@ namespace ppgso {
         std::vector<std::shared_ptr<SceneNode>> children;
         bool visible;
         bool active;
+        SceneNodeListener* listener;
 
         // Pomocne metody pre deti
         virtual void onChildAdded(std::shared_ptr<SceneNode> child);
         virtual void onChildRemoved(std::shared_ptr<SceneNode> child);
+
+    private:
+        void attachListener(SceneNodeListener* listener);
+        void detachListener();
     };
 
 } // namespace ppgso
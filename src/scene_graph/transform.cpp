@@ -5,136 +5,170 @@
 namespace ppgso {
 
     Transform::Transform()
-        : position(0.0f, 0.0f, 0.0f)
-        , rotation(1.0f, 0.0f, 0.0f, 0.0f) // identity quaternion
-        , scale(1.0f, 1.0f, 1.0f)
-        , parent(nullptr)
-        , localMatrixDirty(true)
+        : store(&TransformStore::getDefault())
+        , handle(store->create(this))
     {
     }
 
     Transform::Transform(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
-        : position(position)
-        , rotation(rotation)
-        , scale(scale)
-        , parent(nullptr)
-        , localMatrixDirty(true)
+        : store(&TransformStore::getDefault())
+        , handle(store->create(this))
     {
+        store->setPosition(handle, position);
+        store->setRotation(handle, rotation);
+        store->setScale(handle, scale);
+    }
+
+    Transform::~Transform() {
+        store->destroy(handle);
+    }
+
+    Transform::Transform(const Transform& other)
+        : store(other.store)
+        , handle(store->create(this))
+    {
+        store->setPosition(handle, other.getPosition());
+        store->setRotation(handle, other.getRotation());
+        store->setScale(handle, other.getScale());
+    }
+
+    Transform& Transform::operator=(const Transform& other) {
+        store->setPosition(handle, other.getPosition());
+        store->setRotation(handle, other.getRotation());
+        store->setScale(handle, other.getScale());
+        return *this;
     }
 
     // Pozicia
     void Transform::setPosition(const glm::vec3& position) {
-        this->position = position;
-        localMatrixDirty = true;
+        store->setPosition(handle, position);
     }
 
     glm::vec3 Transform::getPosition() const {
-        return position;
+        return store->getPosition(handle);
     }
 
     void Transform::translate(const glm::vec3& offset) {
-        position += offset;
-        localMatrixDirty = true;
+        store->setPosition(handle, store->getPosition(handle) + offset);
     }
 
     // Rotacia
     void Transform::setRotation(const glm::quat& rotation) {
-        this->rotation = rotation;
-        localMatrixDirty = true;
+        store->setRotation(handle, rotation);
     }
 
     void Transform::setRotation(const glm::vec3& eulerAngles) {
-        rotation = glm::quat(eulerAngles);
-        localMatrixDirty = true;
+        store->setRotation(handle, glm::quat(eulerAngles));
     }
 
     glm::quat Transform::getRotation() const {
-        return rotation;
+        return store->getRotation(handle);
     }
 
     void Transform::rotate(const glm::quat& rotation) {
-        this->rotation = rotation * this->rotation;
-        localMatrixDirty = true;
+        store->setRotation(handle, rotation * store->getRotation(handle));
     }
 
     void Transform::rotate(float angle, const glm::vec3& axis) {
-        rotation = glm::angleAxis(angle, glm::normalize(axis)) * rotation;
-        localMatrixDirty = true;
+        store->setRotation(handle, glm::angleAxis(angle, glm::normalize(axis)) * store->getRotation(handle));
     }
 
     // Skala
     void Transform::setScale(const glm::vec3& scale) {
-        this->scale = scale;
-        localMatrixDirty = true;
+        store->setScale(handle, scale);
     }
 
     void Transform::setScale(float uniformScale) {
-        this->scale = glm::vec3(uniformScale);
-        localMatrixDirty = true;
+        store->setScale(handle, glm::vec3(uniformScale));
     }
 
     glm::vec3 Transform::getScale() const {
-        return scale;
+        return store->getScale(handle);
     }
 
     // Maticove operacie
     glm::mat4 Transform::getLocalMatrix() const {
-        if (localMatrixDirty) {
-            // TRS (Translate, Rotate, Scale) transformacia
-            glm::mat4 translationMatrix = glm::translate(glm::mat4(1.0f), position);
-            glm::mat4 rotationMatrix = glm::toMat4(rotation);
-            glm::mat4 scaleMatrix = glm::scale(glm::mat4(1.0f), scale);
-            
-            cachedLocalMatrix = translationMatrix * rotationMatrix * scaleMatrix;
-            localMatrixDirty = false;
-        }
-        return cachedLocalMatrix;
+        return store->getLocalMatrix(handle);
     }
 
     glm::mat4 Transform::getWorldMatrix() const {
-        if (parent != nullptr) {
-            // Kombinacia s parent transformaciou
-            return parent->getWorldMatrix() * getLocalMatrix();
-        }
-        return getLocalMatrix();
+        return store->getWorldMatrix(handle);
+    }
+
+    void Transform::updateWorldMatrices() {
+        store->update();
+    }
+
+    bool Transform::isWorldMatrixDirty() const {
+        return store->isWorldMatrixDirty(handle);
     }
 
     // Hierarchia
     void Transform::setParent(Transform* parent) {
-        this->parent = parent;
+        store->setParent(handle, parent ? parent->handle : TransformStore::NONE);
     }
 
     Transform* Transform::getParent() const {
-        return parent;
+        TransformStore::Handle parent = store->getParent(handle);
+        return parent == TransformStore::NONE ? nullptr : store->getOwner(parent);
+    }
+
+    // Obalky
+    void Transform::setLocalBounds(const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+        store->setLocalBounds(handle, boundsMin, boundsMax);
+    }
+
+    void Transform::clearLocalBounds() {
+        store->clearLocalBounds(handle);
+    }
+
+    bool Transform::hasLocalBounds() const {
+        return store->hasLocalBounds(handle);
+    }
+
+    bool Transform::isCulled() const {
+        return store->isCulled(handle);
+    }
+
+    bool Transform::isSubtreeCulled() const {
+        return store->isSubtreeCulled(handle);
+    }
+
+    bool Transform::getSubtreeBounds(glm::vec3& boundsMin, glm::vec3& boundsMax) const {
+        return store->getSubtreeBounds(handle, boundsMin, boundsMax);
+    }
+
+    TransformStore::Handle Transform::getHandle() const {
+        return handle;
     }
 
     // Pomocne smery v lokalnom priestore
     glm::vec3 Transform::getForward() const {
-        return rotation * glm::vec3(0.0f, 0.0f, -1.0f);
+        return getRotation() * glm::vec3(0.0f, 0.0f, -1.0f);
     }
 
     glm::vec3 Transform::getRight() const {
-        return rotation * glm::vec3(1.0f, 0.0f, 0.0f);
+        return getRotation() * glm::vec3(1.0f, 0.0f, 0.0f);
     }
 
     glm::vec3 Transform::getUp() const {
-        return rotation * glm::vec3(0.0f, 1.0f, 0.0f);
+        return getRotation() * glm::vec3(0.0f, 1.0f, 0.0f);
     }
 
     // Pomocne smery v svetovom priestore
     glm::vec3 Transform::getWorldForward() const {
-        glm::mat4 worldMat = getWorldMatrix();
+        const glm::mat4& worldMat = store->getWorldMatrix(handle);
         return glm::normalize(glm::vec3(worldMat * glm::vec4(0.0f, 0.0f, -1.0f, 0.0f)));
     }
 
     glm::vec3 Transform::getWorldRight() const {
-        glm::mat4 worldMat = getWorldMatrix();
+        const glm::mat4& worldMat = store->getWorldMatrix(handle);
         return glm::normalize(glm::vec3(worldMat * glm::vec4(1.0f, 0.0f, 0.0f, 0.0f)));
     }
 
     glm::vec3 Transform::getWorldUp() const {
-        glm::mat4 worldMat = getWorldMatrix();
+        const glm::mat4& worldMat = store->getWorldMatrix(handle);
         return glm::normalize(glm::vec3(worldMat * glm::vec4(0.0f, 1.0f, 0.0f, 0.0f)));
     }
 
-} // namespace ppgso
\ No newline at end of file
+} // namespace ppgso
@@ -5,17 +5,29 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+#include "transform_store.h"
+
 namespace ppgso {
 
     /**
      * Transform - Reprezentuje poziciu, rotaciu a skalu objektu
      * Podporuje hierarchicke transformacie pomocou parent-child vztahov
+     *
+     * Data su v spolocnom TransformStore (SoA, rodicia pred detmi), Transform drzi len
+     * handle. Zmena lokalnej transformacie oznaci uzol a cely jeho podstrom ako dirty
+     * (kaskada konci na uz dirty uzle). updateWorldMatrices() potom jednym linearnym
+     * prechodom storu prepocita dirty uzly, getWorldMatrix() inak len vrati cache.
      */
     class Transform {
     public:
         // Konstruktory
         Transform();
         Transform(const glm::vec3& position, const glm::quat& rotation = glm::quat(1,0,0,0), const glm::vec3& scale = glm::vec3(1.0f));
+        ~Transform();
+
+        // Kopiruje sa len pozicia, rotacia a skala, hierarchia zostava
+        Transform(const Transform& other);
+        Transform& operator=(const Transform& other);
 
         // Pozicia
         void setPosition(const glm::vec3& position);
@@ -38,10 +50,27 @@ namespace ppgso {
         glm::mat4 getLocalMatrix() const;      // Lokalna transformacna matica
         glm::mat4 getWorldMatrix() const;      // Svetova transformacna matica (s parentom)
 
+        // Prepocita svetove matice vsetkych dirty uzlov v store (rodicia pred detmi)
+        void updateWorldMatrices();
+        bool isWorldMatrixDirty() const;
+
         // Hierarchia
         void setParent(Transform* parent);
         Transform* getParent() const;
 
+        // Lokalna obalka (AABB v priestore uzla) pre frustum culling
+        void setLocalBounds(const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+        void clearLocalBounds();
+        bool hasLocalBounds() const;
+
+        // Vysledok posledneho TransformStore::cull()
+        bool isCulled() const;
+        bool isSubtreeCulled() const;
+        bool getSubtreeBounds(glm::vec3& boundsMin, glm::vec3& boundsMax) const;
+
+        // Miesto v store
+        TransformStore::Handle getHandle() const;
+
         // Pomocne smery v lokalnom priestore
         glm::vec3 getForward() const;
         glm::vec3 getRight() const;
@@ -53,14 +82,8 @@ namespace ppgso {
         glm::vec3 getWorldUp() const;
 
     private:
-        glm::vec3 position;
-        glm::quat rotation;
-        glm::vec3 scale;
-        Transform* parent;
-
-        // Cache pre optimalizaciu (volitelne)
-        mutable glm::mat4 cachedLocalMatrix;
-        mutable bool localMatrixDirty;
+        TransformStore* store;
+        TransformStore::Handle handle;
     };
 
 } // namespace ppgso
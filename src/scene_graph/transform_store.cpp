@@ -0,0 +1,551 @@
+#include "transform_store.h"
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <type_traits>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/quaternion.hpp>
+#include <ppgso/timing.h>
+
+namespace ppgso {
+
+    TransformStore::TransformStore() {
+    }
+
+    TransformStore& TransformStore::getDefault() {
+        static TransformStore store;
+        return store;
+    }
+
+    glm::mat4 TransformStore::composeTRS(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) {
+        // T * R * S bez nasobenia celych matic
+        glm::mat3 r = glm::toMat3(rotation);
+        glm::mat4 m;
+        m[0] = glm::vec4(r[0] * scale.x, 0.0f);
+        m[1] = glm::vec4(r[1] * scale.y, 0.0f);
+        m[2] = glm::vec4(r[2] * scale.z, 0.0f);
+        m[3] = glm::vec4(position, 1.0f);
+        return m;
+    }
+
+    TransformStore::Handle TransformStore::create(Transform* owner) {
+        Handle handle;
+        if (!freeHandles.empty()) {
+            handle = freeHandles.back();
+            freeHandles.pop_back();
+        } else {
+            handle = (Handle)links.size();
+            links.emplace_back();
+        }
+
+        // Novy koren ide na koniec, preorder zostava platny
+        uint32_t slot = (uint32_t)handleOf.size();
+        links[handle] = Link();
+        links[handle].slot = slot;
+        links[handle].owner = owner;
+
+        positions.push_back(glm::vec3(0.0f));
+        rotations.push_back(glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+        scales.push_back(glm::vec3(1.0f));
+        localMatrices.push_back(glm::mat4(1.0f));
+        worldMatrices.push_back(glm::mat4(1.0f));
+        parentSlot.push_back(-1);
+        subtreeEnd.push_back(slot + 1);
+        localDirty.push_back(0);
+        worldDirty.push_back(0);
+        handleOf.push_back(handle);
+        localBoundsMin.push_back(glm::vec3(0.0f));
+        localBoundsMax.push_back(glm::vec3(0.0f));
+        hasBounds.push_back(0);
+        cullFlags.push_back(0);
+
+        return handle;
+    }
+
+    void TransformStore::destroy(Handle handle) {
+        // Deti sa stanu korenmi
+        while (links[handle].firstChild != NONE) {
+            Handle child = links[handle].firstChild;
+            detach(child);
+            markWorldDirty(child);
+        }
+        detach(handle);
+
+        // Slot sa uvolni pri najblizsom preusporiadani
+        handleOf[links[handle].slot] = NONE;
+        links[handle] = Link();
+        freeHandles.push_back(handle);
+        orderDirty = true;
+    }
+
+    void TransformStore::setPosition(Handle handle, const glm::vec3& position) {
+        positions[links[handle].slot] = position;
+        markLocalDirty(handle);
+    }
+
+    void TransformStore::setRotation(Handle handle, const glm::quat& rotation) {
+        rotations[links[handle].slot] = rotation;
+        markLocalDirty(handle);
+    }
+
+    void TransformStore::setScale(Handle handle, const glm::vec3& scale) {
+        scales[links[handle].slot] = scale;
+        markLocalDirty(handle);
+    }
+
+    const glm::vec3& TransformStore::getPosition(Handle handle) const {
+        return positions[links[handle].slot];
+    }
+
+    const glm::quat& TransformStore::getRotation(Handle handle) const {
+        return rotations[links[handle].slot];
+    }
+
+    const glm::vec3& TransformStore::getScale(Handle handle) const {
+        return scales[links[handle].slot];
+    }
+
+    const glm::mat4& TransformStore::getLocalMatrix(Handle handle) const {
+        uint32_t slot = links[handle].slot;
+        if (localDirty[slot]) {
+            localMatrices[slot] = composeTRS(positions[slot], rotations[slot], scales[slot]);
+            localDirty[slot] = 0;
+        }
+        return localMatrices[slot];
+    }
+
+    const glm::mat4& TransformStore::getWorldMatrix(Handle handle) const {
+        uint32_t slot = links[handle].slot;
+        if (worldDirty[slot]) {
+            // Ide len cez dirty predkov, cisty rodic vrati cache
+            Handle parent = links[handle].parent;
+            if (parent != NONE) {
+                worldMatrices[slot] = getWorldMatrix(parent) * getLocalMatrix(handle);
+            } else {
+                worldMatrices[slot] = getLocalMatrix(handle);
+            }
+            worldDirty[slot] = 0;
+        }
+        return worldMatrices[slot];
+    }
+
+    bool TransformStore::isWorldMatrixDirty(Handle handle) const {
+        return worldDirty[links[handle].slot] != 0;
+    }
+
+    void TransformStore::setParent(Handle handle, Handle parent) {
+        if (links[handle].parent == parent) return;
+
+        detach(handle);
+        if (parent != NONE) {
+            Link& p = links[parent];
+            links[handle].parent = parent;
+            links[handle].prevSibling = p.lastChild;
+            if (p.lastChild != NONE) {
+                links[p.lastChild].nextSibling = handle;
+            } else {
+                p.firstChild = handle;
+            }
+            p.lastChild = handle;
+        }
+
+        orderDirty = true;
+        markWorldDirty(handle);
+    }
+
+    TransformStore::Handle TransformStore::getParent(Handle handle) const {
+        return links[handle].parent;
+    }
+
+    Transform* TransformStore::getOwner(Handle handle) const {
+        return links[handle].owner;
+    }
+
+    void TransformStore::detach(Handle handle) {
+        Link& link = links[handle];
+        if (link.parent == NONE) return;
+
+        Link& p = links[link.parent];
+        if (link.prevSibling != NONE) links[link.prevSibling].nextSibling = link.nextSibling;
+        else p.firstChild = link.nextSibling;
+        if (link.nextSibling != NONE) links[link.nextSibling].prevSibling = link.prevSibling;
+        else p.lastChild = link.prevSibling;
+
+        link.parent = link.prevSibling = link.nextSibling = NONE;
+        orderDirty = true;
+    }
+
+    void TransformStore::markLocalDirty(Handle handle) {
+        localDirty[links[handle].slot] = 1;
+        markWorldDirty(handle);
+    }
+
+    void TransformStore::markWorldDirty(Handle handle) {
+        // Dirty uzol ma dirty cely podstrom, kaskada na nom konci
+        uint32_t first = links[handle].slot;
+        if (worldDirty[first]) return;
+
+        // Pri platnom poradi je podstrom suvisly usek slotov
+        if (!orderDirty) {
+            std::fill(worldDirty.begin() + first, worldDirty.begin() + subtreeEnd[first], 1);
+            dirtyBegin = std::min(dirtyBegin, (size_t)first);
+            return;
+        }
+
+        markStack.assign(1, handle);
+        while (!markStack.empty()) {
+            Handle h = markStack.back();
+            markStack.pop_back();
+
+            uint32_t slot = links[h].slot;
+            if (worldDirty[slot]) continue;
+            worldDirty[slot] = 1;
+            dirtyBegin = std::min(dirtyBegin, (size_t)slot);
+
+            for (Handle child = links[h].firstChild; child != NONE; child = links[child].nextSibling) {
+                markStack.push_back(child);
+            }
+        }
+    }
+
+    void TransformStore::rebuildOrder() {
+        // Preorder cez vsetky korene v doterajsom poradi
+        std::vector<Handle> order;
+        order.reserve(handleOf.size());
+        for (Handle root : handleOf) {
+            if (root == NONE || links[root].parent != NONE) continue;
+
+            Handle h = root;
+            while (true) {
+                order.push_back(h);
+                if (links[h].firstChild != NONE) {
+                    h = links[h].firstChild;
+                    continue;
+                }
+                while (h != root && links[h].nextSibling == NONE) h = links[h].parent;
+                if (h == root) break;
+                h = links[h].nextSibling;
+            }
+        }
+
+        auto gather = [&order, this](auto& values) {
+            typename std::remove_reference<decltype(values)>::type sorted(order.size());
+            for (size_t i = 0; i < order.size(); i++) sorted[i] = values[links[order[i]].slot];
+            values.swap(sorted);
+        };
+        gather(positions);
+        gather(rotations);
+        gather(scales);
+        gather(localMatrices);
+        gather(worldMatrices);
+        gather(localDirty);
+        gather(worldDirty);
+        gather(localBoundsMin);
+        gather(localBoundsMax);
+        gather(hasBounds);
+        gather(cullFlags);
+
+        handleOf = order;
+        for (size_t i = 0; i < order.size(); i++) links[order[i]].slot = (uint32_t)i;
+
+        parentSlot.resize(order.size());
+        dirtyBegin = order.size();
+        for (size_t i = 0; i < order.size(); i++) {
+            Handle parent = links[order[i]].parent;
+            parentSlot[i] = parent == NONE ? -1 : (int32_t)links[parent].slot;
+            if (worldDirty[i]) dirtyBegin = std::min(dirtyBegin, i);
+        }
+
+        // Koniec podstromu: deti su za rodicom, takze staci jeden prechod odzadu
+        subtreeEnd.resize(order.size());
+        for (size_t i = 0; i < order.size(); i++) subtreeEnd[i] = (uint32_t)i + 1;
+        for (size_t i = order.size(); i-- > 0;) {
+            if (parentSlot[i] >= 0) {
+                subtreeEnd[parentSlot[i]] = std::max(subtreeEnd[parentSlot[i]], subtreeEnd[i]);
+            }
+        }
+
+        orderDirty = false;
+        stats.reorders++;
+    }
+
+    void TransformStore::update(bool parallel) {
+        if (orderDirty) rebuildOrder();
+
+        const int count = (int)handleOf.size();
+        const int begin = (int)dirtyBegin;
+        int localCount = 0, worldCount = 0;
+
+        // Lokalne matice su nezavisle
+        #pragma omp parallel for reduction(+:localCount) if(parallel && count - begin > 4096)
+        for (int i = begin; i < count; i++) {
+            if (!localDirty[i]) continue;
+            localMatrices[i] = composeTRS(positions[i], rotations[i], scales[i]);
+            localDirty[i] = 0;
+            localCount++;
+        }
+
+        // Svetove matice jednym prechodom, rodic je vzdy skor a uz hotovy
+        for (int i = begin; i < count; i++) {
+            if (!worldDirty[i]) continue;
+            int parent = parentSlot[i];
+            worldMatrices[i] = parent < 0 ? localMatrices[i] : worldMatrices[parent] * localMatrices[i];
+            worldDirty[i] = 0;
+            worldCount++;
+        }
+
+        dirtyBegin = count;
+        stats.nodes = count;
+        stats.localUpdates = localCount;
+        stats.worldUpdates = worldCount;
+    }
+
+    void TransformStore::setLocalBounds(Handle handle, const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+        uint32_t slot = links[handle].slot;
+        localBoundsMin[slot] = glm::min(boundsMin, boundsMax);
+        localBoundsMax[slot] = glm::max(boundsMin, boundsMax);
+        hasBounds[slot] = 1;
+    }
+
+    void TransformStore::clearLocalBounds(Handle handle) {
+        uint32_t slot = links[handle].slot;
+        hasBounds[slot] = 0;
+        cullFlags[slot] = 0;
+    }
+
+    bool TransformStore::hasLocalBounds(Handle handle) const {
+        return hasBounds[links[handle].slot] != 0;
+    }
+
+    bool TransformStore::isCulled(Handle handle) const {
+        return (cullFlags[links[handle].slot] & CULLED) != 0;
+    }
+
+    bool TransformStore::isSubtreeCulled(Handle handle) const {
+        return (cullFlags[links[handle].slot] & SUBTREE_CULLED) != 0;
+    }
+
+    bool TransformStore::getSubtreeBounds(Handle handle, glm::vec3& boundsMin, glm::vec3& boundsMax) const {
+        uint32_t slot = links[handle].slot;
+        if (slot >= subtreeBounded.size() || !subtreeBounded[slot]) return false;
+        boundsMin = subtreeMin[slot];
+        boundsMax = subtreeMax[slot];
+        return true;
+    }
+
+    void TransformStore::cull(const Frustum& frustum, bool parallel) {
+        update(parallel);
+
+        const int count = (int)handleOf.size();
+        worldBoundsMin.resize(count);
+        worldBoundsMax.resize(count);
+        subtreeMin.resize(count);
+        subtreeMax.resize(count);
+        subtreeBounded.assign(count, 0);
+        subtreeOpen.assign(count, 0);
+
+        // Lokalny AABB do sveta (Arvo): stred cez maticu, polovicne rozmery cez |M|
+        #pragma omp parallel for if(parallel && count > 4096)
+        for (int i = 0; i < count; i++) {
+            if (!hasBounds[i]) continue;
+            const glm::mat4& m = worldMatrices[i];
+            glm::vec3 center = (localBoundsMin[i] + localBoundsMax[i]) * 0.5f;
+            glm::vec3 extent = (localBoundsMax[i] - localBoundsMin[i]) * 0.5f;
+            glm::vec3 worldCenter = glm::vec3(m * glm::vec4(center, 1.0f));
+            glm::vec3 worldExtent = glm::abs(glm::vec3(m[0])) * extent.x
+                                  + glm::abs(glm::vec3(m[1])) * extent.y
+                                  + glm::abs(glm::vec3(m[2])) * extent.z;
+            worldBoundsMin[i] = worldCenter - worldExtent;
+            worldBoundsMax[i] = worldCenter + worldExtent;
+        }
+
+        // Obalky podstromov odzadu, deti su hotove skor ako ich rodic
+        int bounded = 0;
+        auto merge = [this](int slot, const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+            if (subtreeBounded[slot]) {
+                subtreeMin[slot] = glm::min(subtreeMin[slot], boundsMin);
+                subtreeMax[slot] = glm::max(subtreeMax[slot], boundsMax);
+            } else {
+                subtreeMin[slot] = boundsMin;
+                subtreeMax[slot] = boundsMax;
+                subtreeBounded[slot] = 1;
+            }
+        };
+        for (int i = count; i-- > 0;) {
+            if (hasBounds[i]) {
+                merge(i, worldBoundsMin[i], worldBoundsMax[i]);
+                bounded++;
+            } else {
+                subtreeOpen[i] = 1;
+            }
+            if (parentSlot[i] >= 0) {
+                if (subtreeBounded[i]) merge(parentSlot[i], subtreeMin[i], subtreeMax[i]);
+                subtreeOpen[parentSlot[i]] |= subtreeOpen[i];
+            }
+        }
+
+        // Dopredu: cely podstrom mimo / vnutri sa vybavi jednym testom a preskoci
+        CullStats result;
+        result.bounded = bounded;
+        int i = 0;
+        while (i < count) {
+            int end = (int)subtreeEnd[i];
+            if (!subtreeBounded[i]) {
+                std::fill(cullFlags.begin() + i, cullFlags.begin() + end, 0);
+                i = end;
+                continue;
+            }
+
+            result.tested++;
+            Frustum::Containment containment = frustum.classify(subtreeMin[i], subtreeMax[i]);
+            if (containment != Frustum::INTERSECTS || end == i + 1) {
+                bool outside = containment == Frustum::OUTSIDE;
+                std::fill(cullFlags.begin() + i, cullFlags.begin() + end, 0);
+                if (outside) {
+                    // Uzly bez obalky nie su v obalke podstromu (castice...), tie zostavaju
+                    for (int j = i; j < end; j++) {
+                        if (!hasBounds[j]) continue;
+                        cullFlags[j] = subtreeOpen[j] ? CULLED : CULLED | SUBTREE_CULLED;
+                        result.culled++;
+                        if (j != i) result.skipped++;
+                    }
+                }
+                i = end;
+                continue;
+            }
+
+            // Podstrom pretina hranicu: uzol sam za seba, deti sa testuju dalej
+            cullFlags[i] = 0;
+            if (hasBounds[i]) {
+                result.tested++;
+                if (!frustum.intersects(worldBoundsMin[i], worldBoundsMax[i])) {
+                    cullFlags[i] = CULLED;
+                    result.culled++;
+                }
+            }
+            i++;
+        }
+        cullStats = result;
+    }
+
+    void TransformStore::benchmark(int nodeCount, int iterations) {
+        // Nahodny strom: rodic kazdeho uzla je niektory skorsi uzol
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+        std::vector<int> parents(nodeCount, -1);
+        for (int i = 1; i < nodeCount; i++) {
+            parents[i] = (i % 100 == 0) ? -1 : (int)(rng() % i);
+        }
+
+        // Referencia: uzly na halde s detmi v shared_ptr, rekurzivny prechod
+        struct Node {
+            glm::vec3 position;
+            glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+            glm::vec3 scale = glm::vec3(1.0f);
+            glm::mat4 world;
+            std::vector<std::shared_ptr<Node>> children;
+        };
+        std::vector<std::shared_ptr<Node>> nodes(nodeCount), roots;
+
+        TransformStore store;
+        std::vector<Handle> handles(nodeCount);
+
+        for (int i = 0; i < nodeCount; i++) {
+            glm::vec3 position(offset(rng), offset(rng), offset(rng));
+            glm::quat rotation = glm::angleAxis(offset(rng), glm::vec3(0.0f, 1.0f, 0.0f));
+
+            nodes[i] = std::make_shared<Node>();
+            nodes[i]->position = position;
+            nodes[i]->rotation = rotation;
+            if (parents[i] < 0) roots.push_back(nodes[i]);
+            else nodes[parents[i]]->children.push_back(nodes[i]);
+
+            handles[i] = store.create();
+            store.setPosition(handles[i], position);
+            store.setRotation(handles[i], rotation);
+            if (parents[i] >= 0) store.setParent(handles[i], handles[parents[i]]);
+        }
+        store.update();
+
+        struct Walk {
+            static void update(const std::shared_ptr<Node>& node, const glm::mat4& parentWorld) {
+                node->world = parentWorld * composeTRS(node->position, node->rotation, node->scale);
+                for (auto& child : node->children) update(child, node->world);
+            }
+        };
+
+        // Kazdy frame sa pohne kazdy uzol
+        float tree = averageTime(iterations, [&](int) {
+            for (auto& node : nodes) node->position.x += 0.001f;
+            for (auto& root : roots) Walk::update(root, glm::mat4(1.0f));
+        });
+        float flat = averageTime(iterations, [&](int) {
+            for (Handle h : handles) {
+                glm::vec3 p = store.getPosition(h);
+                p.x += 0.001f;
+                store.setPosition(h, p);
+            }
+            store.update();
+        });
+
+        // Kontrola, ze obe strany pocitaju to iste
+        float maxError = 0.0f;
+        for (int i = 0; i < nodeCount; i += std::max(1, nodeCount / 1000)) {
+            glm::mat4 a = store.getWorldMatrix(handles[i]);
+            glm::mat4 b = nodes[i]->world;
+            for (int c = 0; c < 4; c++) maxError = std::max(maxError, glm::length(a[c] - b[c]));
+        }
+
+        // Kazdy frame sa pohne 1% uzlov (tree aj tak prechadza vsetko)
+        int moved = std::max(1, nodeCount / 100);
+        float sparse = averageTime(iterations, [&](int frame) {
+            for (int i = 0; i < moved; i++) {
+                Handle h = handles[(frame * 7919 + i * 104729) % nodeCount];
+                glm::vec3 p = store.getPosition(h);
+                p.x += 0.001f;
+                store.setPosition(h, p);
+            }
+            store.update();
+        });
+
+        std::cout << "Transform update, " << nodeCount << " nodes (ms per frame):" << std::endl;
+        std::cout << "  pointer tree, all moved:  " << tree << std::endl;
+        std::cout << "  flat store, all moved:    " << flat << std::endl;
+        std::cout << "  flat store, 1% moved:     " << sparse << std::endl;
+        std::cout << "  max difference:           " << maxError << std::endl;
+
+        // Orezanie: kazdy desiaty uzol bez obalky, aj pod predkom, ktory sa oreze cely
+        for (int i = 0; i < nodeCount; i++) {
+            if (i % 10 != 0) store.setLocalBounds(handles[i], glm::vec3(-0.2f), glm::vec3(0.2f));
+        }
+        Frustum frustum(glm::perspective(0.8f, 1.0f, 0.1f, 20.0f) *
+                        glm::lookAt(glm::vec3(0.0f, 0.0f, -8.0f), glm::vec3(3.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+        float cull = averageTime(iterations, [&](int) { store.cull(frustum); });
+
+        // Kontrola: uzol s obalkou je orezany prave vtedy, ked jeho obalka je mimo frusta, uzol
+        // bez obalky nikdy a orezany podstrom znamena orezane vsetky deti
+        int errors = 0, openUnderCulled = 0;
+        for (int i = 0; i < nodeCount; i++) {
+            bool expected = false;
+            if (i % 10 != 0) {
+                const glm::mat4& m = store.getWorldMatrix(handles[i]);
+                glm::vec3 center = glm::vec3(m[3]);
+                glm::vec3 extent = glm::abs(glm::vec3(m[0])) * 0.2f + glm::abs(glm::vec3(m[1])) * 0.2f
+                                 + glm::abs(glm::vec3(m[2])) * 0.2f;
+                expected = !frustum.intersects(center - extent, center + extent);
+            }
+            if (store.isCulled(handles[i]) != expected) errors++;
+            if (parents[i] >= 0 && store.isCulled(handles[parents[i]])) {
+                if (i % 10 == 0) openUnderCulled++;
+                if (store.isSubtreeCulled(handles[parents[i]]) && !store.isSubtreeCulled(handles[i])) errors++;
+            }
+        }
+
+        const CullStats& stats = store.getCullStats();
+        std::cout << "Transform cull, " << nodeCount << " nodes: " << cull << " ms, " << stats.tested
+                  << " tests, " << stats.culled << " culled (" << stats.skipped << " by an ancestor), "
+                  << openUnderCulled << " unbounded under a culled parent, mismatches " << errors << std::endl;
+    }
+
+} // namespace ppgso
@@ -0,0 +1,159 @@
+#ifndef PPGSO_TRANSFORM_STORE_H
+#define PPGSO_TRANSFORM_STORE_H
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "../camera/frustum.h"
+
+namespace ppgso {
+
+    class Transform;
+
+    /**
+     * TransformStore - Vsetky transformacie v suvislych poliach (SoA)
+     *
+     * Pozicie, rotacie, skaly, lokalne a svetove matice su v samostatnych poliach
+     * zoradenych v preorderi (rodic je vzdy pred svojimi detmi). Svetove matice sa tak
+     * pocitaju jednym linearnym prechodom, ktory zacina od prveho dirty slotu.
+     *
+     * Handle je stabilny identifikator, slot je aktualna pozicia v poliach. Zmena
+     * hierarchie len poznaci, ze poradie treba prebudovat - to sa stane pri dalsom
+     * update(), takze pridanie tisicov uzlov stoji jedno preusporiadanie.
+     *
+     * Uzol moze mat lokalny AABB (napr. z meshu). cull() ich prevedie do sveta, spoji
+     * do obalok podstromov (jeden prechod odzadu) a potom prechadza sloty dopredu:
+     * podstrom cely mimo frusta alebo cely vnutri sa vybavi jednym testom a preskoci.
+     */
+    class TransformStore {
+    public:
+        using Handle = uint32_t;
+        static const Handle NONE = 0xffffffffu;
+
+        // Prehlad posledneho update()
+        struct Stats {
+            int nodes = 0;
+            int localUpdates = 0;
+            int worldUpdates = 0;
+            int reorders = 0;      // Kolkokrat sa prebudovalo poradie od resetStats
+        };
+
+        // Prehlad posledneho cull()
+        struct CullStats {
+            int bounded = 0;       // Uzly s obalkou
+            int tested = 0;        // Testy obalok proti frustu
+            int culled = 0;        // Uzly s obalkou mimo frusta
+            int skipped = 0;       // Z toho vybavene testom predka (cely podstrom naraz)
+        };
+
+        TransformStore();
+
+        // Spolocny store pre vsetky Transform objekty
+        static TransformStore& getDefault();
+
+        Handle create(Transform* owner = nullptr);
+        void destroy(Handle handle);
+
+        // Lokalna transformacia
+        void setPosition(Handle handle, const glm::vec3& position);
+        void setRotation(Handle handle, const glm::quat& rotation);
+        void setScale(Handle handle, const glm::vec3& scale);
+        const glm::vec3& getPosition(Handle handle) const;
+        const glm::quat& getRotation(Handle handle) const;
+        const glm::vec3& getScale(Handle handle) const;
+
+        // Matice, dirty hodnoty sa dopocitaju na poziadanie
+        const glm::mat4& getLocalMatrix(Handle handle) const;
+        const glm::mat4& getWorldMatrix(Handle handle) const;
+        bool isWorldMatrixDirty(Handle handle) const;
+
+        // Hierarchia (dieta sa prida na koniec deti noveho rodica)
+        void setParent(Handle handle, Handle parent);
+        Handle getParent(Handle handle) const;
+        Transform* getOwner(Handle handle) const;
+
+        // Prepocita lokalne a svetove matice vsetkych dirty uzlov, rodicia pred detmi
+        void update(bool parallel = true);
+
+        // Lokalna obalka uzla (v priestore uzla). Uzol bez obalky sa neoreze nikdy, jeho
+        // geometria (ak nejaku ma) nie je v ziadnej obalke
+        void setLocalBounds(Handle handle, const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+        void clearLocalBounds(Handle handle);
+        bool hasLocalBounds(Handle handle) const;
+
+        // Spoji svetove obalky podstromov a oznaci uzly mimo frusta (vola update())
+        void cull(const Frustum& frustum, bool parallel = true);
+
+        // Vysledky posledneho cull(): obalka uzla je mimo frusta / cely podstrom ma obalky
+        // a su mimo frusta
+        bool isCulled(Handle handle) const;
+        bool isSubtreeCulled(Handle handle) const;
+
+        // Svetova obalka podstromu z posledneho cull(), false ak v nom nic obalku nema
+        bool getSubtreeBounds(Handle handle, glm::vec3& boundsMin, glm::vec3& boundsMax) const;
+
+        size_t size() const { return handleOf.size(); }
+        const Stats& getStats() const { return stats; }
+        const CullStats& getCullStats() const { return cullStats; }
+
+        // Zmeria update() na nahodnej hierarchii s nodeCount uzlami proti stromu
+        // uzlov na halde s rekurzivnym prechodom a vypise oba casy (ms na frame).
+        // Potom zmeria cull() (desatina uzlov bez obalky) a porovna ho s testom
+        // kazdej obalky zvlast.
+        static void benchmark(int nodeCount, int iterations = 20);
+
+    private:
+        // Polia podla slotu (preorder)
+        std::vector<glm::vec3> positions;
+        std::vector<glm::quat> rotations;
+        std::vector<glm::vec3> scales;
+        mutable std::vector<glm::mat4> localMatrices;
+        mutable std::vector<glm::mat4> worldMatrices;
+        std::vector<int32_t> parentSlot;
+        std::vector<uint32_t> subtreeEnd;     // Podstrom slotu i su sloty [i, subtreeEnd[i])
+        mutable std::vector<uint8_t> localDirty;
+        mutable std::vector<uint8_t> worldDirty;
+        std::vector<Handle> handleOf;          // NONE pre zruseny slot
+
+        // Obalky podla slotu: lokalna sa preusporiadava s uzlom, svetove plni cull()
+        std::vector<glm::vec3> localBoundsMin, localBoundsMax;
+        std::vector<uint8_t> hasBounds;
+        std::vector<uint8_t> cullFlags;        // CULLED | SUBTREE_CULLED
+        std::vector<glm::vec3> worldBoundsMin, worldBoundsMax;
+        std::vector<glm::vec3> subtreeMin, subtreeMax;
+        std::vector<uint8_t> subtreeBounded;
+        std::vector<uint8_t> subtreeOpen;      // V podstrome je uzol bez obalky
+
+        // Polia podla handle: slot a hierarchia ako zretazene zoznamy
+        struct Link {
+            uint32_t slot = 0;
+            Handle parent = NONE;
+            Handle firstChild = NONE, lastChild = NONE;
+            Handle prevSibling = NONE, nextSibling = NONE;
+            Transform* owner = nullptr;
+        };
+        std::vector<Link> links;
+        std::vector<Handle> freeHandles;
+        std::vector<Handle> markStack;
+
+        bool orderDirty = false;              // Preorder a subtreeEnd neplatia do rebuildOrder
+        size_t dirtyBegin = 0;                 // Sloty pred nim su cele aktualne
+        Stats stats;
+        CullStats cullStats;
+
+        static const uint8_t CULLED = 1;
+        static const uint8_t SUBTREE_CULLED = 2;
+
+        void markLocalDirty(Handle handle);
+        void markWorldDirty(Handle handle);
+        void detach(Handle handle);
+        void rebuildOrder();
+
+        static glm::mat4 composeTRS(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+    };
+
+} // namespace ppgso
+
+#endif // PPGSO_TRANSFORM_STORE_H
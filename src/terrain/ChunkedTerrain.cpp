@@ -0,0 +1,436 @@
+#include "ChunkedTerrain.h"
+#include "Terrain.h"
+#include "GridNormals.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include <stdexcept>
+
+#include <shaders/terrain_vert_glsl.h>
+#include <shaders/terrain_frag_glsl.h>
+
+// Static member initialization
+std::unique_ptr<ppgso::Shader> ChunkedTerrain::shader;
+int ChunkedTerrain::instanceCount = 0;
+
+ChunkedTerrain::ChunkedTerrain(Terrain &source, const ChunkSettings &settings)
+        : source(source), settings(settings), sourceRevision(source.getRevision()) {
+
+    int res = settings.chunkResolution;
+    if (res < 2 || (res & (res - 1)) != 0) {
+        throw std::runtime_error("ChunkedTerrain: chunk resolution must be a power of two");
+    }
+
+    // The coarsest level still needs an inner vertex row for the border strips
+    this->settings.lodLevels = std::max(1, settings.lodLevels);
+    while ((res >> (this->settings.lodLevels - 1)) < 2) {
+        this->settings.lodLevels--;
+    }
+    this->settings.ringWidth = std::max(1, settings.ringWidth);
+
+    cellSize = settings.chunkSize / res;
+
+    instanceCount++;
+
+    if (!shader) {
+        shader = std::make_unique<ppgso::Shader>(terrain_vert_glsl, terrain_frag_glsl);
+    }
+
+    createIndexBuffers();
+}
+
+ChunkedTerrain::~ChunkedTerrain() {
+    clear();
+    glDeleteBuffers((GLsizei)indexBuffers.size(), indexBuffers.data());
+
+    instanceCount--;
+
+    if (instanceCount == 0) {
+        shader.reset();
+    }
+}
+
+// ===================== Streaming =========================
+
+uint64_t ChunkedTerrain::chunkKey(int cx, int cz, int lod) {
+    // 25 bits per chunk coordinate (two's complement), 5 bits for the level
+    return ((uint64_t)(cx & 0x1FFFFFF) << 30) | ((uint64_t)(cz & 0x1FFFFFF) << 5) | (uint64_t)lod;
+}
+
+int ChunkedTerrain::desiredLod(int dx, int dz) const {
+    // Square rings: chunks next to each other are at most one level apart
+    int ring = std::max(std::abs(dx), std::abs(dz)) / settings.ringWidth;
+    return std::min(ring, settings.lodLevels - 1);
+}
+
+std::list<ChunkedTerrain::Chunk>::iterator ChunkedTerrain::findChunk(int cx, int cz, int lod) {
+    auto it = lookup.find(chunkKey(cx, cz, lod));
+    return it == lookup.end() ? chunks.end() : it->second;
+}
+
+int ChunkedTerrain::closestCachedLod(int cx, int cz, int lod, int lo, int hi) {
+    for (int offset = 0; offset < settings.lodLevels; offset++) {
+        if (lod + offset <= hi && lod + offset >= lo && findChunk(cx, cz, lod + offset) != chunks.end()) return lod + offset;
+        if (lod - offset >= lo && lod - offset <= hi && findChunk(cx, cz, lod - offset) != chunks.end()) return lod - offset;
+    }
+    return -1;
+}
+
+void ChunkedTerrain::update(const glm::vec3 &cameraPosition) {
+    frame++;
+
+    // Cached chunks are stale once the height function changes
+    if (source.getRevision() != sourceRevision) {
+        clear();
+        sourceRevision = source.getRevision();
+    }
+
+    const int radius = settings.viewRadius;
+    const int span = 2 * radius + 1;
+    const int camX = (int)std::floor(cameraPosition.x / settings.chunkSize);
+    const int camZ = (int)std::floor(cameraPosition.z / settings.chunkSize);
+
+    // Queue every visible chunk that is missing at its desired level, nearest first
+    std::vector<ChunkData> missing;
+    std::vector<int> missingDistance;
+    for (int dz = -radius; dz <= radius; dz++) {
+        for (int dx = -radius; dx <= radius; dx++) {
+            int lod = desiredLod(dx, dz);
+            if (findChunk(camX + dx, camZ + dz, lod) == chunks.end()) {
+                missing.push_back({camX + dx, camZ + dz, lod, {}, {}, {}});
+                missingDistance.push_back(dx * dx + dz * dz);
+            }
+        }
+    }
+
+    std::vector<int> order(missing.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = (int)i;
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return missingDistance[a] < missingDistance[b];
+    });
+
+    // Generate a bounded number of chunks per frame; builds are independent and
+    // only upload once every thread is done
+    const int buildCount = std::min((int)missing.size(), std::max(settings.maxBuildsPerFrame, 0));
+    pendingChunks = (int)missing.size() - buildCount;
+
+    if (buildCount > 0) {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        std::vector<ChunkData> builds(buildCount);
+        for (int i = 0; i < buildCount; i++) {
+            builds[i] = std::move(missing[order[i]]);
+        }
+
+        #pragma omp parallel for schedule(dynamic) if(parallelGeneration)
+        for (int i = 0; i < buildCount; i++) {
+            buildChunk(builds[i]);
+        }
+
+        for (auto &data : builds) {
+            uploadChunk(data);
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+        lastBuildTime = std::chrono::duration<float, std::milli>(end - start).count();
+    }
+
+    // Rendered level per visible chunk: the desired one, or the closest cached
+    // level while the desired one is still streaming in
+    std::vector<int> levels((size_t)span * span, -1), desired((size_t)span * span);
+    for (int dz = -radius; dz <= radius; dz++) {
+        for (int dx = -radius; dx <= radius; dx++) {
+            size_t cell = (size_t)(dz + radius) * span + (dx + radius);
+            desired[cell] = desiredLod(dx, dz);
+            levels[cell] = closestCachedLod(camX + dx, camZ + dz, desired[cell], 0, settings.lodLevels - 1);
+        }
+    }
+
+    // The stitching only closes seams to a neighbour one level coarser. Desired levels
+    // already keep to that, so every violation involves a fallback: it moves to another
+    // cached level within one of its neighbours, or stays hidden until streamed in.
+    auto neighbourRange = [&](int x, int z, int &lo, int &hi) {
+        lo = 0;
+        hi = settings.lodLevels - 1;
+        const int nx[] = {x, x, x - 1, x + 1}, nz[] = {z - 1, z + 1, z, z};
+        for (int n = 0; n < 4; n++) {
+            if (nx[n] < 0 || nz[n] < 0 || nx[n] >= span || nz[n] >= span) continue;
+            int level = levels[(size_t)nz[n] * span + nx[n]];
+            if (level < 0) continue;
+            lo = std::max(lo, level - 1);
+            hi = std::min(hi, level + 1);
+        }
+    };
+
+    bool changed = true;
+    for (int pass = 0; changed && pass < settings.lodLevels * span; pass++) {
+        changed = false;
+        for (int z = 0; z < span; z++) {
+            for (int x = 0; x < span; x++) {
+                size_t cell = (size_t)z * span + x;
+                if (levels[cell] < 0 || levels[cell] == desired[cell]) continue;
+
+                int lo, hi;
+                neighbourRange(x, z, lo, hi);
+                if (levels[cell] >= lo && levels[cell] <= hi) continue;
+
+                levels[cell] = lo > hi ? -1 : closestCachedLod(camX + x - radius, camZ + z - radius,
+                                                                desired[cell], lo, hi);
+                changed = true;
+            }
+        }
+    }
+
+    std::vector<Chunk *> visible((size_t)span * span, nullptr);
+    for (int z = 0; z < span; z++) {
+        for (int x = 0; x < span; x++) {
+            size_t cell = (size_t)z * span + x;
+            if (levels[cell] < 0) continue;
+
+            // Fallbacks still out of range after the passes wait for their chunk
+            int lo, hi;
+            neighbourRange(x, z, lo, hi);
+            if (levels[cell] != desired[cell] && (levels[cell] < lo || levels[cell] > hi)) continue;
+
+            auto it = findChunk(camX + x - radius, camZ + z - radius, levels[cell]);
+            it->lastUsed = frame;
+            chunks.splice(chunks.begin(), chunks, it);
+            visible[cell] = &*it;
+        }
+    }
+
+    // Stitch every edge that borders a coarser neighbour
+    auto lodAt = [&](int x, int z) {
+        if (x < 0 || z < 0 || x >= span || z >= span) return -1;
+        const Chunk *c = visible[(size_t)z * span + x];
+        return c ? c->lod : -1;
+    };
+
+    drawList.clear();
+    for (int z = 0; z < span; z++) {
+        for (int x = 0; x < span; x++) {
+            const Chunk *c = visible[(size_t)z * span + x];
+            if (!c) continue;
+
+            int mask = 0;
+            if (lodAt(x, z - 1) > c->lod) mask |= STITCH_NORTH;
+            if (lodAt(x, z + 1) > c->lod) mask |= STITCH_SOUTH;
+            if (lodAt(x - 1, z) > c->lod) mask |= STITCH_WEST;
+            if (lodAt(x + 1, z) > c->lod) mask |= STITCH_EAST;
+            drawList.push_back({c, mask});
+        }
+    }
+
+    enforceBudget();
+}
+
+void ChunkedTerrain::enforceBudget() {
+    // Least recently used chunks go first; chunks drawn this frame are never evicted
+    while (residentBytes > settings.memoryBudget && !chunks.empty()) {
+        auto last = std::prev(chunks.end());
+        if (last->lastUsed == frame) break;
+        evict(last);
+    }
+}
+
+void ChunkedTerrain::evict(std::list<Chunk>::iterator it) {
+    glDeleteVertexArrays(1, &it->vao);
+    glDeleteBuffers(1, &it->vbo);
+    glDeleteBuffers(1, &it->nbo);
+    glDeleteBuffers(1, &it->tbo);
+
+    residentBytes -= it->bytes;
+    lookup.erase(chunkKey(it->cx, it->cz, it->lod));
+    chunks.erase(it);
+}
+
+void ChunkedTerrain::clear() {
+    while (!chunks.empty()) {
+        evict(chunks.begin());
+    }
+    drawList.clear();
+}
+
+// ===================== Chunk Generation =========================
+
+void ChunkedTerrain::buildChunk(ChunkData &data) {
+    const int cells = chunkCells(data.lod);
+    const int stride = 1 << data.lod;       // LOD 0 lattice steps between vertices
+    const int rowSize = cells + 1;
+    const int apron = cells + 3;            // one extra sample on every side for normals
+    const float step = cellSize * stride;
+    const float size = source.getSize();
+
+    // Vertices sit on a global integer lattice, so neighbouring chunks compute
+    // bit-identical edge positions whatever level they are at
+    const int originX = data.cx * settings.chunkResolution;
+    const int originZ = data.cz * settings.chunkResolution;
+
+    std::vector<float> xs(apron);
+    std::vector<float> heights((size_t)apron * apron);
+    for (int i = 0; i < apron; i++) {
+        xs[i] = (float)(originX + (i - 1) * stride) * cellSize;
+    }
+    for (int j = 0; j < apron; j++) {
+        float wz = (float)(originZ + (j - 1) * stride) * cellSize;
+        source.sampleHeightRow(xs.data(), wz, &heights[(size_t)j * apron], apron);
+    }
+
+    // Normals over the apron grid, so edge vertices see the neighbouring chunk's heights
+    // (this already runs inside the parallel chunk loop)
+    std::vector<glm::vec3> apronNormals((size_t)apron * apron);
+    gridnormals::Grid grid{heights.data(), apron, apron, 1, apron, step, step};
+    gridnormals::compute(grid, apronNormals.data(), 1, 1, apron - 2, apron - 2, false);
+
+    data.positions.resize((size_t)rowSize * rowSize);
+    data.normals.resize(data.positions.size());
+    data.uvs.resize(data.positions.size());
+
+    for (int z = 0; z < rowSize; z++) {
+        float wz = (float)(originZ + z * stride) * cellSize;
+        size_t apronRow = (size_t)(z + 1) * apron + 1;
+
+        for (int x = 0; x < rowSize; x++) {
+            float wx = xs[x + 1];
+            int idx = z * rowSize + x;
+
+            data.positions[idx] = {wx, heights[apronRow + x], wz};
+            data.normals[idx] = apronNormals[apronRow + x];
+            data.uvs[idx] = {wx / size + 0.5f, wz / size + 0.5f};
+        }
+    }
+}
+
+void ChunkedTerrain::uploadChunk(const ChunkData &data) {
+    Chunk chunk;
+    chunk.cx = data.cx;
+    chunk.cz = data.cz;
+    chunk.lod = data.lod;
+    chunk.lastUsed = frame;
+
+    glGenVertexArrays(1, &chunk.vao);
+    glBindVertexArray(chunk.vao);
+
+    glGenBuffers(1, &chunk.vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, chunk.vbo);
+    glBufferData(GL_ARRAY_BUFFER, data.positions.size() * sizeof(glm::vec3),
+                 data.positions.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    glGenBuffers(1, &chunk.nbo);
+    glBindBuffer(GL_ARRAY_BUFFER, chunk.nbo);
+    glBufferData(GL_ARRAY_BUFFER, data.normals.size() * sizeof(glm::vec3),
+                 data.normals.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    glGenBuffers(1, &chunk.tbo);
+    glBindBuffer(GL_ARRAY_BUFFER, chunk.tbo);
+    glBufferData(GL_ARRAY_BUFFER, data.uvs.size() * sizeof(glm::vec2),
+                 data.uvs.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    chunk.bytes = data.positions.size() * sizeof(glm::vec3)
+                + data.normals.size() * sizeof(glm::vec3)
+                + data.uvs.size() * sizeof(glm::vec2);
+
+    chunks.push_front(chunk);
+    lookup[chunkKey(chunk.cx, chunk.cz, chunk.lod)] = chunks.begin();
+    residentBytes += chunk.bytes;
+}
+
+// ===================== Stitched Index Buffers =========================
+
+void ChunkedTerrain::createIndexBuffers() {
+    const int variants = settings.lodLevels * 16;
+    indexBuffers.resize(variants);
+    indexCounts.resize(variants);
+    glGenBuffers(variants, indexBuffers.data());
+
+    for (int lod = 0; lod < settings.lodLevels; lod++) {
+        for (int mask = 0; mask < 16; mask++) {
+            std::vector<unsigned int> indices = buildIndices(chunkCells(lod), mask);
+            int variant = lod * 16 + mask;
+
+            // Uploaded through GL_ARRAY_BUFFER so no VAO has to be bound here,
+            // each draw binds the variant it needs as its element buffer
+            glBindBuffer(GL_ARRAY_BUFFER, indexBuffers[variant]);
+            glBufferData(GL_ARRAY_BUFFER, indices.size() * sizeof(unsigned int),
+                         indices.data(), GL_STATIC_DRAW);
+            indexCounts[variant] = (GLsizei)indices.size();
+        }
+    }
+}
+
+std::vector<unsigned int> ChunkedTerrain::buildIndices(int cells, int stitchMask) {
+    const int rowSize = cells + 1;
+    std::vector<unsigned int> indices;
+
+    auto emit = [&](glm::ivec2 a, glm::ivec2 b, glm::ivec2 c) {
+        // Keep the winding of the Terrain mesh: (x, z), (x, z + 1), (x + 1, z)
+        glm::ivec2 e1 = b - a, e2 = c - a;
+        if (e1.x * e2.y - e1.y * e2.x > 0) std::swap(b, c);
+        indices.push_back(a.y * rowSize + a.x);
+        indices.push_back(b.y * rowSize + b.x);
+        indices.push_back(c.y * rowSize + c.x);
+    };
+
+    // Interior cells use the same triangulation as the Terrain mesh
+    for (int z = 1; z < cells - 1; z++) {
+        for (int x = 1; x < cells - 1; x++) {
+            emit({x, z}, {x, z + 1}, {x + 1, z});
+            emit({x + 1, z}, {x, z + 1}, {x + 1, z + 1});
+        }
+    }
+
+    // Every side of the border ring is a strip between the outer edge and the
+    // first inner row, zipped together by position along the edge. A stitched
+    // edge only uses every second outer vertex, which are exactly the vertices
+    // of the coarser neighbour, so the shared edge has no T-junction gaps.
+    auto strip = [&](glm::ivec2 origin, glm::ivec2 along, glm::ivec2 inward, bool stitched) {
+        const int outerStep = stitched ? 2 : 1;
+        auto outer = [&](int t) { return origin + along * t; };
+        auto inner = [&](int t) { return origin + along * t + inward; };
+
+        int a = 0, b = 1;
+        while (a < cells || b < cells - 1) {
+            bool advanceOuter = b >= cells - 1 || (a < cells && a + outerStep <= b + 1);
+            if (advanceOuter) {
+                emit(outer(a), outer(a + outerStep), inner(b));
+                a += outerStep;
+            } else {
+                emit(outer(a), inner(b + 1), inner(b));
+                b++;
+            }
+        }
+    };
+
+    strip({0, 0}, {1, 0}, {0, 1}, (stitchMask & STITCH_NORTH) != 0);
+    strip({0, cells}, {1, 0}, {0, -1}, (stitchMask & STITCH_SOUTH) != 0);
+    strip({0, 0}, {0, 1}, {1, 0}, (stitchMask & STITCH_WEST) != 0);
+    strip({cells, 0}, {0, 1}, {-1, 0}, (stitchMask & STITCH_EAST) != 0);
+
+    return indices;
+}
+
+// ===================== Rendering =========================
+
+void ChunkedTerrain::render(const glm::mat4 &view, const glm::mat4 &projection) {
+    if (drawList.empty()) return;
+
+    shader->use();
+    shader->setUniform("modelMatrix", glm::mat4(1.f));
+    shader->setUniform("viewMatrix", view);
+    shader->setUniform("projectionMatrix", projection);
+
+    for (const auto &item : drawList) {
+        int variant = item.chunk->lod * 16 + item.stitchMask;
+
+        glBindVertexArray(item.chunk->vao);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffers[variant]);
+        glDrawElements(GL_TRIANGLES, indexCounts[variant], GL_UNSIGNED_INT, nullptr);
+    }
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <ppgso/ppgso.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <cstdint>
+
+class Terrain;
+
+struct ChunkSettings {
+    float chunkSize = 64.0f;             // World size of one chunk edge
+    int chunkResolution = 64;            // Cells per chunk edge at LOD 0 (power of two)
+    int lodLevels = 4;                   // Every level halves the chunk resolution
+    int ringWidth = 2;                   // Width of one LOD ring in chunks
+    int viewRadius = 12;                 // Chunks kept around the camera in each direction
+    size_t memoryBudget = 64u << 20;     // Bytes of vertex data allowed to stay resident
+    int maxBuildsPerFrame = 8;           // Chunk generations per update call
+};
+
+/*!
+ * Streaming terrain made of fixed-size square chunks around the camera.
+ *
+ * Heights come from the Terrain height function, so the world is not limited to
+ * the Terrain mesh. Chunks are generated on demand, their level of detail drops
+ * every `ringWidth` chunks away from the camera and neighbouring levels never
+ * differ by more than one. Seams between levels are closed by index buffer
+ * variants that skip every second vertex along the edges facing a coarser
+ * neighbour; the 16 variants per level are shared by all chunks. Chunks that
+ * fall out of view stay cached until the memory budget forces the least
+ * recently used ones out.
+ */
+class ChunkedTerrain {
+public:
+    ChunkedTerrain(Terrain &source, const ChunkSettings &settings = ChunkSettings());
+    ~ChunkedTerrain();
+
+    ChunkedTerrain(const ChunkedTerrain &) = delete;
+    ChunkedTerrain &operator=(const ChunkedTerrain &) = delete;
+
+    // Streams chunks in and out around the camera, call once per frame before render
+    void update(const glm::vec3 &cameraPosition);
+    void render(const glm::mat4 &view, const glm::mat4 &projection);
+
+    // Drops every cached chunk (they are rebuilt on the following updates)
+    void clear();
+
+    void setParallelGeneration(bool enabled) { parallelGeneration = enabled; }
+    bool isParallelGeneration() const { return parallelGeneration; }
+
+    // Statistics
+    size_t getResidentChunks() const { return chunks.size(); }
+    size_t getResidentBytes() const { return residentBytes; }
+    size_t getDrawnChunks() const { return drawList.size(); }
+    int getPendingChunks() const { return pendingChunks; }
+    float getLastBuildTime() const { return lastBuildTime; }
+
+private:
+    struct Chunk {
+        int cx, cz, lod;
+        GLuint vao = 0, vbo = 0, nbo = 0, tbo = 0;
+        size_t bytes = 0;
+        unsigned long lastUsed = 0;
+    };
+
+    // CPU side result of a chunk build, uploaded on the GL thread
+    struct ChunkData {
+        int cx, cz, lod;
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> normals;
+        std::vector<glm::vec2> uvs;
+    };
+
+    struct DrawItem {
+        const Chunk *chunk;
+        int stitchMask;
+    };
+
+    // Edge flags of the stitch mask (set when the neighbour on that side is coarser)
+    enum StitchEdge { STITCH_NORTH = 1, STITCH_SOUTH = 2, STITCH_WEST = 4, STITCH_EAST = 8 };
+
+    Terrain &source;
+    ChunkSettings settings;
+    float cellSize;
+    bool parallelGeneration = true;
+    unsigned int sourceRevision;
+
+    // Chunk cache, most recently used at the front
+    std::list<Chunk> chunks;
+    std::unordered_map<uint64_t, std::list<Chunk>::iterator> lookup;
+    size_t residentBytes = 0;
+    unsigned long frame = 0;
+
+    // Shared index buffers, 16 stitch variants per LOD level
+    std::vector<GLuint> indexBuffers;
+    std::vector<GLsizei> indexCounts;
+
+    std::vector<DrawItem> drawList;
+    int pendingChunks = 0;
+    float lastBuildTime = 0.0f;
+
+    static uint64_t chunkKey(int cx, int cz, int lod);
+    int chunkCells(int lod) const { return settings.chunkResolution >> lod; }
+    int desiredLod(int dx, int dz) const;
+    std::list<Chunk>::iterator findChunk(int cx, int cz, int lod);
+
+    // Cached level of a chunk in [lo, hi] closest to lod, -1 when none is cached
+    int closestCachedLod(int cx, int cz, int lod, int lo, int hi);
+
+    void buildChunk(ChunkData &data);
+    void uploadChunk(const ChunkData &data);
+    void evict(std::list<Chunk>::iterator it);
+    void enforceBudget();
+
+    void createIndexBuffers();
+    static std::vector<unsigned int> buildIndices(int cells, int stitchMask);
+
+    // Shader (shared across all chunked terrain instances)
+    static std::unique_ptr<ppgso::Shader> shader;
+    static int instanceCount;
+};
@@ -0,0 +1,142 @@
+#include "GridNormals.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace gridnormals {
+
+// Unnormalized normals of the two triangles of quad (qx, qz)
+static glm::vec3 faceA(const Grid &g, int qx, int qz) {
+    glm::vec3 p0(qx * g.spacingX, g.at(qx, qz), qz * g.spacingZ);
+    glm::vec3 p1((qx + 1) * g.spacingX, g.at(qx + 1, qz), qz * g.spacingZ);
+    glm::vec3 p2(qx * g.spacingX, g.at(qx, qz + 1), (qz + 1) * g.spacingZ);
+    return glm::cross(p2 - p0, p1 - p0);
+}
+
+static glm::vec3 faceB(const Grid &g, int qx, int qz) {
+    glm::vec3 p1((qx + 1) * g.spacingX, g.at(qx + 1, qz), qz * g.spacingZ);
+    glm::vec3 p2(qx * g.spacingX, g.at(qx, qz + 1), (qz + 1) * g.spacingZ);
+    glm::vec3 p3((qx + 1) * g.spacingX, g.at(qx + 1, qz + 1), (qz + 1) * g.spacingZ);
+    return glm::cross(p2 - p1, p3 - p1);
+}
+
+static glm::vec3 normalizeOrUp(const glm::vec3 &n) {
+    float len = glm::length(n);
+    return len > 0.0001f ? n / len : glm::vec3(0, 1, 0);
+}
+
+// Border vertices: gather the triangles that exist around (x, z)
+static glm::vec3 gatherFaces(const Grid &g, int x, int z) {
+    bool left = x > 0, right = x < g.columns - 1;
+    bool down = z > 0, up = z < g.rows - 1;
+
+    glm::vec3 n(0.f);
+    if (right && up) n += faceA(g, x, z);
+    if (left && up) n += faceA(g, x - 1, z) + faceB(g, x - 1, z);
+    if (right && down) n += faceA(g, x, z - 1) + faceB(g, x, z - 1);
+    if (left && down) n += faceB(g, x - 1, z - 1);
+
+    return normalizeOrUp(n);
+}
+
+Grid fromPositions(const glm::vec3 *positions, int columns, int rows, float spacingX, float spacingZ) {
+    return {&positions[0].y, columns, rows, 3, 3 * columns, spacingX, spacingZ};
+}
+
+void compute(const Grid &grid, glm::vec3 *normals, int x0, int z0, int x1, int z1, bool parallel) {
+    x0 = std::max(x0, 0);
+    z0 = std::max(z0, 0);
+    x1 = std::min(x1, grid.columns - 1);
+    z1 = std::min(z1, grid.rows - 1);
+    if (x0 > x1 || z0 > z1) return;
+
+    const int columns = grid.columns;
+    const float sx = grid.spacingX, sz = grid.spacingZ;
+    const float ny = 6.0f * sx * sz;
+
+    // Interior columns handled by the stencil loop
+    const int ix0 = std::max(x0, 1);
+    const int ix1 = std::min(x1, columns - 2);
+
+    #pragma omp parallel if(parallel)
+    {
+        // Contiguous copies of the three rows the stencil reads
+        std::vector<float> down(columns), mid(columns), up(columns);
+
+        #pragma omp for schedule(static)
+        for (int z = z0; z <= z1; z++) {
+            glm::vec3 *row = normals + (size_t)z * columns;
+
+            if (z == 0 || z == grid.rows - 1 || ix0 > ix1) {
+                for (int x = x0; x <= x1; x++) row[x] = gatherFaces(grid, x, z);
+                continue;
+            }
+
+            for (int x = ix0 - 1; x <= ix1 + 1; x++) {
+                down[x] = grid.at(x, z - 1);
+                mid[x] = grid.at(x, z);
+                up[x] = grid.at(x, z + 1);
+            }
+
+            const float *d = down.data(), *m = mid.data(), *u = up.data();
+
+            #pragma omp simd
+            for (int x = ix0; x <= ix1; x++) {
+                float nx = -sz * (2.0f * (m[x + 1] - m[x - 1]) + (u[x] - u[x - 1]) + (d[x + 1] - d[x]));
+                float nz = -sx * (2.0f * (u[x] - d[x]) + (u[x - 1] - m[x - 1]) + (m[x + 1] - d[x + 1]));
+                float inv = 1.0f / std::sqrt(nx * nx + ny * ny + nz * nz);
+
+                row[x].x = nx * inv;
+                row[x].y = ny * inv;
+                row[x].z = nz * inv;
+            }
+
+            if (x0 == 0) row[0] = gatherFaces(grid, 0, z);
+            if (x1 == columns - 1) row[columns - 1] = gatherFaces(grid, columns - 1, z);
+        }
+    }
+}
+
+void compute(const Grid &grid, glm::vec3 *normals, bool parallel) {
+    compute(grid, normals, 0, 0, grid.columns - 1, grid.rows - 1, parallel);
+}
+
+void computeFaceAveraged(const Grid &grid, glm::vec3 *normals) {
+    const int columns = grid.columns;
+    const size_t count = (size_t)columns * grid.rows;
+    std::fill(normals, normals + count, glm::vec3(0.f));
+
+    for (int z = 0; z < grid.rows - 1; z++) {
+        for (int x = 0; x < columns - 1; x++) {
+            int i0 = z * columns + x;
+            int i1 = i0 + 1;
+            int i2 = i0 + columns;
+            int i3 = i2 + 1;
+
+            glm::vec3 a = faceA(grid, x, z);
+            glm::vec3 b = faceB(grid, x, z);
+            normals[i0] += a; normals[i2] += a; normals[i1] += a;
+            normals[i1] += b; normals[i2] += b; normals[i3] += b;
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        normals[i] = normalizeOrUp(normals[i]);
+    }
+}
+
+float measureError(const Grid &grid) {
+    const size_t count = (size_t)grid.columns * grid.rows;
+    std::vector<glm::vec3> stencil(count), reference(count);
+
+    compute(grid, stencil.data());
+    computeFaceAveraged(grid, reference.data());
+
+    float maxError = 0.0f;
+    for (size_t i = 0; i < count; i++) {
+        maxError = std::max(maxError, glm::length(stencil[i] - reference[i]));
+    }
+    return maxError;
+}
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+/*!
+ * Vertex normals for regular heightfield grids.
+ *
+ * Every normal is computed from the heights of its neighbours, so rows are
+ * independent and can be processed in parallel, and the inner loop runs over
+ * contiguous memory. The stencil is the sum of the six triangle normals around
+ * a vertex for the triangulation used by Terrain and Ocean (quad (x, z) split
+ * into (x, z), (x, z + 1), (x + 1, z) and (x + 1, z), (x, z + 1), (x + 1, z + 1)):
+ *
+ *   nx = -sz * (2 (h[x+1,z] - h[x-1,z]) + (h[x,z+1] - h[x-1,z+1]) + (h[x+1,z-1] - h[x,z-1]))
+ *   ny =  6 sx sz
+ *   nz = -sx * (2 (h[x,z+1] - h[x,z-1]) + (h[x-1,z+1] - h[x-1,z]) + (h[x+1,z] - h[x+1,z-1]))
+ *
+ * which matches the area weighted face normals of the mesh. Border vertices have
+ * fewer triangles and are gathered face by face.
+ */
+namespace gridnormals {
+
+    // Heights of a (columns x rows) grid. Samples of one row are `stride` floats
+    // apart and rows `rowStride` floats apart, so the y channel of a glm::vec3
+    // position array can be used in place (stride 3, rowStride 3 * columns).
+    struct Grid {
+        const float *heights;
+        int columns, rows;
+        int stride, rowStride;
+        float spacingX, spacingZ;
+
+        float at(int x, int z) const { return heights[(size_t)z * rowStride + (size_t)x * stride]; }
+    };
+
+    // Grid over the y channel of a dense row-major position array
+    Grid fromPositions(const glm::vec3 *positions, int columns, int rows, float spacingX, float spacingZ);
+
+    // Normals of the vertices in the inclusive rectangle [x0, x1] x [z0, z1],
+    // written to normals[z * columns + x]
+    void compute(const Grid &grid, glm::vec3 *normals, int x0, int z0, int x1, int z1, bool parallel = true);
+
+    // Whole grid
+    void compute(const Grid &grid, glm::vec3 *normals, bool parallel = true);
+
+    // Reference: face normals scattered through every triangle of the grid
+    void computeFaceAveraged(const Grid &grid, glm::vec3 *normals);
+
+    // Largest distance between the stencil normals and the face averaged reference
+    float measureError(const Grid &grid);
+
+    constexpr float TOLERANCE = 1e-4f;
+
+}
@@ -0,0 +1,704 @@
+#include "HeightfieldCollider.h"
+#include "Terrain.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <ppgso/timing.h>
+
+// Points per block for the batched queries (what one thread takes at a time)
+static const int BLOCK = 256;
+
+// Largest number of contacts one sphere gets from the terrain
+static const int MAX_SPHERE_CONTACTS = 4;
+
+// ===================== Geometry helpers =========================
+
+// Closest point on triangle abc to p (Ericson, Real-Time Collision Detection 5.1.5)
+static glm::vec3 closestPointOnTriangle(const glm::vec3 &p, const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c) {
+    glm::vec3 ab = b - a, ac = c - a, ap = p - a;
+    float d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) return a;
+
+    glm::vec3 bp = p - b;
+    float d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) return b;
+
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) return a + ab * (d1 / (d1 - d3));
+
+    glm::vec3 cp = p - c;
+    float d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) return c;
+
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) return a + ac * (d2 / (d2 - d6));
+
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    }
+
+    float denom = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+// Upward facing unit normal of a terrain triangle
+static glm::vec3 triangleNormal(const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c) {
+    glm::vec3 n = glm::normalize(glm::cross(b - a, c - a));
+    return n.y < 0.0f ? -n : n;
+}
+
+// Ray / triangle (Moller-Trumbore), both sides, t in [0, tMax)
+static bool rayTriangle(const glm::vec3 &origin, const glm::vec3 &direction,
+                        const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c, float tMax, float &t) {
+    glm::vec3 e1 = b - a, e2 = c - a;
+    glm::vec3 p = glm::cross(direction, e2);
+    float det = glm::dot(e1, p);
+    if (std::abs(det) < 1e-12f) return false;
+
+    float inverse = 1.0f / det;
+    glm::vec3 s = origin - a;
+    float u = glm::dot(s, p) * inverse;
+    if (u < 0.0f || u > 1.0f) return false;
+
+    glm::vec3 q = glm::cross(s, e1);
+    float v = glm::dot(direction, q) * inverse;
+    if (v < 0.0f || u + v > 1.0f) return false;
+
+    float hit = glm::dot(e2, q) * inverse;
+    if (hit < 0.0f || hit >= tMax) return false;
+    t = hit;
+    return true;
+}
+
+// Ray / sphere, entry t in [0, tMax)
+static bool raySphere(const glm::vec3 &origin, const glm::vec3 &direction, const glm::vec3 &center,
+                      float radius, float tMax, float &t) {
+    glm::vec3 m = origin - center;
+    float a = glm::dot(direction, direction);
+    float b = glm::dot(m, direction);
+    float c = glm::dot(m, m) - radius * radius;
+    float discriminant = b * b - a * c;
+    if (a < 1e-12f || discriminant < 0.0f) return false;
+
+    float hit = (-b - std::sqrt(discriminant)) / a;
+    if (hit < 0.0f || hit >= tMax) return false;
+    t = hit;
+    return true;
+}
+
+// Ray / cylinder of the given radius around segment ab (without caps), entry t in [0, tMax)
+static bool rayCylinder(const glm::vec3 &origin, const glm::vec3 &direction, const glm::vec3 &a,
+                        const glm::vec3 &b, float radius, float tMax, float &t) {
+    glm::vec3 axis = b - a, m = origin - a;
+    float md = glm::dot(m, axis), nd = glm::dot(direction, axis), dd = glm::dot(axis, axis);
+    float qa = dd * glm::dot(direction, direction) - nd * nd;
+    float qb = dd * glm::dot(m, direction) - nd * md;
+    float qc = dd * (glm::dot(m, m) - radius * radius) - md * md;
+    float discriminant = qb * qb - qa * qc;
+    if (std::abs(qa) < 1e-12f || discriminant < 0.0f) return false;
+
+    float hit = (-qb - std::sqrt(discriminant)) / qa;
+    if (hit < 0.0f || hit >= tMax) return false;
+
+    float along = md + hit * nd;
+    if (along < 0.0f || along > dd) return false;
+    t = hit;
+    return true;
+}
+
+// Sphere moving along origin + t * direction against triangle abc, first contact t in [0, tMax).
+// Returns t = 0 when the sphere already touches the triangle.
+static bool sweepTriangle(const glm::vec3 &origin, const glm::vec3 &direction, float radius,
+                          const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c, float tMax, float &t) {
+    if (tMax <= 0.0f) return false;
+
+    glm::vec3 closest = closestPointOnTriangle(origin, a, b, c);
+    glm::vec3 offset = origin - closest;
+    if (glm::dot(offset, offset) < radius * radius) {
+        t = 0.0f;
+        return true;
+    }
+
+    bool found = false;
+    float best = tMax, hit;
+
+    // Face: the sphere touches the plane, the touching point has to be inside the triangle
+    glm::vec3 n = triangleNormal(a, b, c);
+    float distance = glm::dot(origin - a, n);
+    float side = distance >= 0.0f ? 1.0f : -1.0f;
+    float approach = -side * glm::dot(direction, n);
+    if (approach > 1e-12f) {
+        hit = (side * distance - radius) / approach;
+        if (hit >= 0.0f && hit < best) {
+            glm::vec3 p = origin + direction * hit - n * (side * radius);
+            glm::vec3 v0 = b - a, v1 = c - a, v2 = p - a;
+            float d00 = glm::dot(v0, v0), d01 = glm::dot(v0, v1), d11 = glm::dot(v1, v1);
+            float d20 = glm::dot(v2, v0), d21 = glm::dot(v2, v1);
+            float denom = d00 * d11 - d01 * d01;
+            float v = (d11 * d20 - d01 * d21) / denom;
+            float w = (d00 * d21 - d01 * d20) / denom;
+            if (v >= 0.0f && w >= 0.0f && v + w <= 1.0f) {
+                best = hit;
+                found = true;
+            }
+        }
+    }
+
+    // Edges and corners
+    const glm::vec3 *corners[3] = {&a, &b, &c};
+    for (int i = 0; i < 3; i++) {
+        if (rayCylinder(origin, direction, *corners[i], *corners[(i + 1) % 3], radius, best, hit)) {
+            best = hit;
+            found = true;
+        }
+        if (raySphere(origin, direction, *corners[i], radius, best, hit)) {
+            best = hit;
+            found = true;
+        }
+    }
+
+    if (found) t = best;
+    return found;
+}
+
+// Entry and exit of origin + t * direction through a box, clipped to [0, tMax]
+static bool rayBox(const glm::vec3 &origin, const glm::vec3 &direction, const glm::vec3 &boxMin,
+                   const glm::vec3 &boxMax, float tMax, float &tEnter) {
+    float enter = 0.0f, exit = tMax;
+    for (int axis = 0; axis < 3; axis++) {
+        if (std::abs(direction[axis]) < 1e-12f) {
+            if (origin[axis] < boxMin[axis] || origin[axis] > boxMax[axis]) return false;
+            continue;
+        }
+        float inverse = 1.0f / direction[axis];
+        float t0 = (boxMin[axis] - origin[axis]) * inverse;
+        float t1 = (boxMax[axis] - origin[axis]) * inverse;
+        if (t0 > t1) std::swap(t0, t1);
+        enter = std::max(enter, t0);
+        exit = std::min(exit, t1);
+        if (enter > exit) return false;
+    }
+    tEnter = enter;
+    return true;
+}
+
+// Height and gradient (per cell, not per world unit) of the triangle under a point.
+// Branchless so the loops over a block vectorize, the four loads become gathers.
+static inline void sampleGrid(const float *data, int cells, float origin, float inverseCell, float x, float z,
+                              float &h, float &gradientX, float &gradientZ) {
+    const int stride = cells + 1;
+    float fx = std::min(std::max((x - origin) * inverseCell, 0.0f), (float)cells);
+    float fz = std::min(std::max((z - origin) * inverseCell, 0.0f), (float)cells);
+    int ix = std::min((int)fx, cells - 1);
+    int iz = std::min((int)fz, cells - 1);
+    float tx = fx - ix, tz = fz - iz;
+
+    const float *row = data + (size_t)iz * stride + ix;
+    float h00 = row[0], h10 = row[1], h01 = row[stride], h11 = row[stride + 1];
+
+    // Triangle (00, 01, 10) below the diagonal, (10, 01, 11) above it
+    float upper = tx + tz > 1.0f ? 1.0f : 0.0f;
+    gradientX = (h10 - h00) + upper * ((h11 - h01) - (h10 - h00));
+    gradientZ = (h01 - h00) + upper * ((h11 - h10) - (h01 - h00));
+    float base = h00 + upper * (h01 + h10 - h11 - h00);
+    h = base + gradientX * tx + gradientZ * tz;
+}
+
+// ===================== Construction =========================
+
+HeightfieldCollider::HeightfieldCollider(const Terrain &terrain) : terrain(terrain), revision(terrain.getGridRevision()) {
+    rebuild();
+}
+
+bool HeightfieldCollider::sync() {
+    const unsigned int latest = terrain.getGridRevision();
+    if (revision == latest) return false;
+
+    // A single change since the last sync is a rectangle, more need the whole grid
+    if (latest - revision == 1) {
+        const Terrain::GridRegion &change = terrain.getLastChange();
+        rebuildRegion(change.x0, change.z0, change.x1, change.z1);
+    } else {
+        rebuild();
+    }
+    revision = latest;
+    return true;
+}
+
+void HeightfieldCollider::rebuild() {
+    revision = terrain.getGridRevision();
+    cells = terrain.getResolution();
+    cellSize = terrain.getSize() / cells;
+    origin = -0.5f * terrain.getSize();
+    heightData.resize((size_t)(cells + 1) * (cells + 1));
+
+    // Pyramid levels: every level halves the node count per side down to one node
+    levels.clear();
+    for (int width = cells;; width = (width + 1) / 2) {
+        Level level;
+        level.width = width;
+        level.minimum.resize((size_t)width * width);
+        level.maximum.resize((size_t)width * width);
+        levels.push_back(std::move(level));
+        if (width == 1) break;
+    }
+
+    rebuildRegion(0, 0, cells, cells);
+}
+
+void HeightfieldCollider::rebuildRegion(int x0, int z0, int x1, int z1) {
+    x0 = std::max(x0, 0);
+    z0 = std::max(z0, 0);
+    x1 = std::min(x1, cells);
+    z1 = std::min(z1, cells);
+    if (x0 > x1 || z0 > z1) return;
+
+    const auto &positions = terrain.getPositions();
+    for (int z = z0; z <= z1; z++) {
+        for (int x = x0; x <= x1; x++) {
+            size_t index = (size_t)z * (cells + 1) + x;
+            heightData[index] = positions[index].y;
+        }
+    }
+
+    updatePyramid(x0, z0, x1, z1);
+}
+
+void HeightfieldCollider::updatePyramid(int x0, int z0, int x1, int z1) {
+    // Cells that use one of the changed vertices
+    int cx0 = std::max(x0 - 1, 0), cz0 = std::max(z0 - 1, 0);
+    int cx1 = std::min(x1, cells - 1), cz1 = std::min(z1, cells - 1);
+
+    Level &base = levels[0];
+    for (int z = cz0; z <= cz1; z++) {
+        for (int x = cx0; x <= cx1; x++) {
+            float h00 = vertexHeight(x, z), h10 = vertexHeight(x + 1, z);
+            float h01 = vertexHeight(x, z + 1), h11 = vertexHeight(x + 1, z + 1);
+            size_t index = (size_t)z * base.width + x;
+            base.minimum[index] = std::min(std::min(h00, h10), std::min(h01, h11));
+            base.maximum[index] = std::max(std::max(h00, h10), std::max(h01, h11));
+        }
+    }
+
+    // Each parent is the range of its (up to) four children
+    for (size_t l = 1; l < levels.size(); l++) {
+        const Level &child = levels[l - 1];
+        Level &level = levels[l];
+        cx0 >>= 1; cz0 >>= 1; cx1 >>= 1; cz1 >>= 1;
+
+        for (int z = cz0; z <= cz1; z++) {
+            for (int x = cx0; x <= cx1; x++) {
+                float low = std::numeric_limits<float>::max();
+                float high = -std::numeric_limits<float>::max();
+                for (int dz = 0; dz < 2; dz++) {
+                    for (int dx = 0; dx < 2; dx++) {
+                        int childX = 2 * x + dx, childZ = 2 * z + dz;
+                        if (childX >= child.width || childZ >= child.width) continue;
+                        size_t index = (size_t)childZ * child.width + childX;
+                        low = std::min(low, child.minimum[index]);
+                        high = std::max(high, child.maximum[index]);
+                    }
+                }
+                level.minimum[(size_t)z * level.width + x] = low;
+                level.maximum[(size_t)z * level.width + x] = high;
+            }
+        }
+    }
+}
+
+// ===================== Height queries =========================
+
+void HeightfieldCollider::sample(float x, float z, float &h, float &gradientX, float &gradientZ) const {
+    sampleGrid(heightData.data(), cells, origin, 1.0f / cellSize, x, z, h, gradientX, gradientZ);
+    gradientX /= cellSize;
+    gradientZ /= cellSize;
+}
+
+float HeightfieldCollider::height(float x, float z) const {
+    float h, gx, gz;
+    sample(x, z, h, gx, gz);
+    return h;
+}
+
+glm::vec3 HeightfieldCollider::normal(float x, float z) const {
+    float h, gx, gz;
+    sample(x, z, h, gx, gz);
+    return glm::normalize(glm::vec3(-gx, 1.0f, -gz));
+}
+
+void HeightfieldCollider::heights(const float *x, const float *z, float *outHeight, int count, bool parallel) const {
+    const int blocks = (count + BLOCK - 1) / BLOCK;
+    const float inverseCell = 1.0f / cellSize;
+    const float *data = heightData.data();
+
+    #pragma omp parallel for schedule(static) if(parallel && blocks > 1)
+    for (int b = 0; b < blocks; b++) {
+        int first = b * BLOCK;
+        int last = std::min(first + BLOCK, count);
+
+        #pragma omp simd
+        for (int i = first; i < last; i++) {
+            float h, gx, gz;
+            sampleGrid(data, cells, origin, inverseCell, x[i], z[i], h, gx, gz);
+            outHeight[i] = h;
+        }
+    }
+}
+
+void HeightfieldCollider::heightsAndNormals(const float *x, const float *z, float *outHeight, glm::vec3 *outNormal,
+                                            int count, bool parallel) const {
+    const int blocks = (count + BLOCK - 1) / BLOCK;
+    const float inverseCell = 1.0f / cellSize;
+    const float *data = heightData.data();
+
+    #pragma omp parallel for schedule(static) if(parallel && blocks > 1)
+    for (int b = 0; b < blocks; b++) {
+        int first = b * BLOCK;
+        int last = std::min(first + BLOCK, count);
+
+        #pragma omp simd
+        for (int i = first; i < last; i++) {
+            float h, gx, gz;
+            sampleGrid(data, cells, origin, inverseCell, x[i], z[i], h, gx, gz);
+            outHeight[i] = h;
+
+            // (-gx, cellSize, -gz) is the normal scaled by cellSize
+            float length = std::sqrt(gx * gx + gz * gz + cellSize * cellSize);
+            outNormal[i] = glm::vec3(-gx, cellSize, -gz) / length;
+        }
+    }
+}
+
+void HeightfieldCollider::clampToGround(glm::vec3 *positions, int count, float offset, bool parallel) const {
+    const int blocks = (count + BLOCK - 1) / BLOCK;
+    const float inverseCell = 1.0f / cellSize;
+    const float *data = heightData.data();
+
+    #pragma omp parallel for schedule(static) if(parallel && blocks > 1)
+    for (int b = 0; b < blocks; b++) {
+        int first = b * BLOCK;
+        int last = std::min(first + BLOCK, count);
+
+        #pragma omp simd
+        for (int i = first; i < last; i++) {
+            float h, gx, gz;
+            sampleGrid(data, cells, origin, inverseCell, positions[i].x, positions[i].z, h, gx, gz);
+            positions[i].y = std::max(positions[i].y, h + offset);
+        }
+    }
+}
+
+// ===================== Ray and sweep queries =========================
+
+void HeightfieldCollider::cellTriangles(int x, int z, glm::vec3 corners[2][3]) const {
+    float x0 = origin + x * cellSize, x1 = x0 + cellSize;
+    float z0 = origin + z * cellSize, z1 = z0 + cellSize;
+    glm::vec3 p00(x0, vertexHeight(x, z), z0), p10(x1, vertexHeight(x + 1, z), z0);
+    glm::vec3 p01(x0, vertexHeight(x, z + 1), z1), p11(x1, vertexHeight(x + 1, z + 1), z1);
+
+    corners[0][0] = p00; corners[0][1] = p01; corners[0][2] = p10;
+    corners[1][0] = p10; corners[1][1] = p01; corners[1][2] = p11;
+}
+
+template<typename TestCell>
+float HeightfieldCollider::traverse(const glm::vec3 &origin, const glm::vec3 &direction, float tMax, float inflate,
+                                    TestCell testCell) const {
+    struct Node {
+        int level, x, z;
+        float enter;
+    };
+
+    // Box of a node: its cells in x / z and the height range, grown by inflate
+    auto nodeEnter = [&](int level, int x, int z, float tBest, float &enter) {
+        const Level &nodes = levels[level];
+        size_t index = (size_t)z * nodes.width + x;
+        int first = 1 << level;
+        float span = cellSize * first;
+        glm::vec3 boxMin(this->origin + x * span - inflate, nodes.minimum[index] - inflate,
+                         this->origin + z * span - inflate);
+        glm::vec3 boxMax(this->origin + std::min((x + 1) * first, cells) * cellSize + inflate,
+                         nodes.maximum[index] + inflate,
+                         this->origin + std::min((z + 1) * first, cells) * cellSize + inflate);
+        return rayBox(origin, direction, boxMin, boxMax, tBest, enter);
+    };
+
+    float tBest = tMax;
+    Node stack[4 * 32];
+    int top = 0;
+
+    const int rootLevel = (int)levels.size() - 1;
+    float enter;
+    if (nodeEnter(rootLevel, 0, 0, tBest, enter)) stack[top++] = {rootLevel, 0, 0, enter};
+
+    while (top > 0) {
+        Node node = stack[--top];
+        if (node.enter >= tBest) continue;
+
+        if (node.level == 0) {
+            tBest = testCell(node.x, node.z, tBest);
+            continue;
+        }
+
+        // Children pushed far to near, so the nearest one is tested first
+        Node children[4];
+        int childCount = 0;
+        const int childLevel = node.level - 1;
+        const int width = levels[childLevel].width;
+        for (int dz = 0; dz < 2; dz++) {
+            for (int dx = 0; dx < 2; dx++) {
+                int x = 2 * node.x + dx, z = 2 * node.z + dz;
+                if (x >= width || z >= width) continue;
+                if (nodeEnter(childLevel, x, z, tBest, enter)) children[childCount++] = {childLevel, x, z, enter};
+            }
+        }
+        std::sort(children, children + childCount, [](const Node &a, const Node &b) { return a.enter > b.enter; });
+        for (int i = 0; i < childCount; i++) stack[top++] = children[i];
+    }
+
+    return tBest;
+}
+
+bool HeightfieldCollider::raycast(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance, Hit &hit) const {
+    float length = glm::length(direction);
+    if (length < 1e-12f) return false;
+    glm::vec3 unit = direction / length;
+
+    int hitX = -1, hitZ = 0, hitTriangle = 0;
+    float t = traverse(origin, unit, maxDistance, 0.0f, [&](int x, int z, float tBest) {
+        glm::vec3 corners[2][3];
+        cellTriangles(x, z, corners);
+        for (int i = 0; i < 2; i++) {
+            float candidate;
+            if (rayTriangle(origin, unit, corners[i][0], corners[i][1], corners[i][2], tBest, candidate)) {
+                tBest = candidate;
+                hitX = x;
+                hitZ = z;
+                hitTriangle = i;
+            }
+        }
+        return tBest;
+    });
+    if (hitX < 0) return false;
+
+    glm::vec3 corners[2][3];
+    cellTriangles(hitX, hitZ, corners);
+    hit.distance = t;
+    hit.position = origin + unit * t;
+    hit.normal = triangleNormal(corners[hitTriangle][0], corners[hitTriangle][1], corners[hitTriangle][2]);
+    return true;
+}
+
+bool HeightfieldCollider::sweepSphere(const glm::vec3 &center, float radius, const glm::vec3 &displacement, Hit &hit) const {
+    int hitX = -1, hitZ = 0, hitTriangle = 0;
+    float t = traverse(center, displacement, 1.0f, radius, [&](int x, int z, float tBest) {
+        glm::vec3 corners[2][3];
+        cellTriangles(x, z, corners);
+        for (int i = 0; i < 2; i++) {
+            float candidate;
+            if (sweepTriangle(center, displacement, radius, corners[i][0], corners[i][1], corners[i][2],
+                              tBest, candidate)) {
+                tBest = candidate;
+                hitX = x;
+                hitZ = z;
+                hitTriangle = i;
+            }
+        }
+        return tBest;
+    });
+    if (hitX < 0) return false;
+
+    glm::vec3 corners[2][3];
+    cellTriangles(hitX, hitZ, corners);
+    const glm::vec3 *triangle = corners[hitTriangle];
+    glm::vec3 moved = center + displacement * t;
+    glm::vec3 closest = closestPointOnTriangle(moved, triangle[0], triangle[1], triangle[2]);
+    glm::vec3 offset = moved - closest;
+    float distance = glm::length(offset);
+
+    hit.distance = t;
+    hit.position = closest;
+    hit.normal = distance > 1e-6f ? offset / distance : triangleNormal(triangle[0], triangle[1], triangle[2]);
+    return true;
+}
+
+// ===================== Physics contacts =========================
+
+void HeightfieldCollider::collide(const ppgso::RigidBodyStore &bodies, const std::vector<uint32_t> &slots,
+                                  std::vector<ppgso::Contact> &contacts) const {
+    const float gridMax = origin + cells * cellSize;
+
+    for (uint32_t slot : slots) {
+        const glm::vec3 p = bodies.positions[slot];
+        const float r = bodies.radii[slot];
+        if (p.x + r < origin || p.x - r > gridMax || p.z + r < origin || p.z - r > gridMax) continue;
+
+        // Cells under the sphere's footprint
+        int cx0 = std::max((int)std::floor((p.x - r - origin) / cellSize), 0);
+        int cz0 = std::max((int)std::floor((p.z - r - origin) / cellSize), 0);
+        int cx1 = std::min((int)std::floor((p.x + r - origin) / cellSize), cells - 1);
+        int cz1 = std::min((int)std::floor((p.z + r - origin) / cellSize), cells - 1);
+
+        // Early out on the first pyramid level where the footprint spans at most 2 x 2 nodes
+        size_t level = 0;
+        while (level + 1 < levels.size() && ((cx1 >> level) - (cx0 >> level) > 1 || (cz1 >> level) - (cz0 >> level) > 1)) {
+            level++;
+        }
+        float highest = -std::numeric_limits<float>::max();
+        for (int z = cz0 >> level; z <= cz1 >> level; z++) {
+            for (int x = cx0 >> level; x <= cx1 >> level; x++) {
+                highest = std::max(highest, levels[level].maximum[(size_t)z * levels[level].width + x]);
+            }
+        }
+        if (p.y - r >= highest) continue;
+
+        // Centre under the surface: one contact straight out along the surface normal
+        float h, gx, gz;
+        sample(p.x, p.z, h, gx, gz);
+        if (p.y < h) {
+            glm::vec3 n = glm::normalize(glm::vec3(-gx, 1.0f, -gz));
+            contacts.push_back({slot, ppgso::Contact::STATIC, n, (h - p.y) * n.y + r});
+            continue;
+        }
+
+        // Closest points on the triangles around the sphere. Contacts with nearly the same
+        // normal (shared vertices and edges, flat neighbours) are merged into the deepest one.
+        ppgso::Contact found[MAX_SPHERE_CONTACTS];
+        int foundCount = 0;
+        for (int z = cz0; z <= cz1; z++) {
+            for (int x = cx0; x <= cx1; x++) {
+                if (p.y - r >= levels[0].maximum[(size_t)z * levels[0].width + x]) continue;
+
+                glm::vec3 corners[2][3];
+                cellTriangles(x, z, corners);
+                for (int i = 0; i < 2; i++) {
+                    glm::vec3 closest = closestPointOnTriangle(p, corners[i][0], corners[i][1], corners[i][2]);
+                    glm::vec3 offset = p - closest;
+                    float distanceSquared = glm::dot(offset, offset);
+                    if (distanceSquared >= r * r) continue;
+
+                    float distance = std::sqrt(distanceSquared);
+                    glm::vec3 n = distance > 1e-6f ? offset / distance
+                                                   : triangleNormal(corners[i][0], corners[i][1], corners[i][2]);
+                    ppgso::Contact contact = {slot, ppgso::Contact::STATIC, n, r - distance};
+
+                    int similar = -1;
+                    for (int c = 0; c < foundCount && similar < 0; c++) {
+                        if (glm::dot(found[c].normal, n) > 0.99f) similar = c;
+                    }
+                    if (similar >= 0) {
+                        if (contact.depth > found[similar].depth) found[similar] = contact;
+                    } else if (foundCount < MAX_SPHERE_CONTACTS) {
+                        found[foundCount++] = contact;
+                    } else {
+                        // Full: replace the shallowest one if this is deeper
+                        int shallowest = 0;
+                        for (int c = 1; c < foundCount; c++) {
+                            if (found[c].depth < found[shallowest].depth) shallowest = c;
+                        }
+                        if (contact.depth > found[shallowest].depth) found[shallowest] = contact;
+                    }
+                }
+            }
+        }
+        contacts.insert(contacts.end(), found, found + foundCount);
+    }
+}
+
+// ===================== Benchmark =========================
+
+void HeightfieldCollider::benchmark(const Terrain &terrain, int count) {
+    HeightfieldCollider collider(terrain);
+    const float half = 0.5f * terrain.getSize();
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> position(-half, half), unit(-1.0f, 1.0f);
+    std::vector<float> xs(count), zs(count), batched(count), scalar(count);
+    for (int i = 0; i < count; i++) {
+        xs[i] = position(rng);
+        zs[i] = position(rng);
+    }
+
+    // Ground heights: Terrain::getHeightAt per point vs one batched call
+    float scalarMs = ppgso::averageTime(20, [&](int) {
+        for (int i = 0; i < count; i++) scalar[i] = terrain.getHeightAt(xs[i], zs[i]);
+    });
+    float serialMs = ppgso::averageTime(20, [&](int) { collider.heights(xs.data(), zs.data(), batched.data(), count, false); });
+    float parallelMs = ppgso::averageTime(20, [&](int) { collider.heights(xs.data(), zs.data(), batched.data(), count, true); });
+
+    float maxDifference = 0.0f;
+    for (int i = 0; i < count; i++) {
+        maxDifference = std::max(maxDifference, std::abs(batched[i] - collider.height(xs[i], zs[i])));
+    }
+    std::cout << "Heightfield heights (" << count << " points): getHeightAt " << scalarMs
+              << " ms, batched " << serialMs << " ms serial / " << parallelMs << " ms parallel"
+              << " (max difference to height() " << maxDifference << ")\n";
+
+    // Rays from above the terrain in random directions, pyramid vs marching along the ray
+    const int rays = std::max(count / 10, 1);
+    std::vector<glm::vec3> origins(rays), directions(rays);
+    for (int i = 0; i < rays; i++) {
+        origins[i] = glm::vec3(position(rng), collider.levels.back().maximum[0] + 5.0f, position(rng));
+        directions[i] = glm::normalize(glm::vec3(unit(rng), -std::abs(unit(rng)) - 0.1f, unit(rng)));
+    }
+    const float maxDistance = terrain.getSize();
+
+    int pyramidHits = 0, marchHits = 0, mismatches = 0;
+    std::vector<float> pyramidDistance(rays), marchDistance(rays);
+    float pyramidMs = ppgso::averageTime(1, [&](int) {
+        pyramidHits = 0;
+        for (int i = 0; i < rays; i++) {
+            Hit hit;
+            bool found = collider.raycast(origins[i], directions[i], maxDistance, hit);
+            pyramidDistance[i] = found ? hit.distance : -1.0f;
+            pyramidHits += found;
+        }
+    });
+    float marchMs = ppgso::averageTime(1, [&](int) {
+        // Steps of a quarter cell until the ray is under the surface or leaves the grid, then bisection
+        marchHits = 0;
+        const float step = 0.25f * collider.cellSize;
+        for (int i = 0; i < rays; i++) {
+            marchDistance[i] = -1.0f;
+            float previous = 0.0f;
+            for (float t = step; t <= maxDistance; t += step) {
+                glm::vec3 p = origins[i] + directions[i] * t;
+                if (std::abs(p.x) > half || std::abs(p.z) > half) break;
+                if (p.y > collider.height(p.x, p.z)) {
+                    previous = t;
+                    continue;
+                }
+                float low = previous, high = t;
+                for (int k = 0; k < 20; k++) {
+                    float middle = 0.5f * (low + high);
+                    glm::vec3 q = origins[i] + directions[i] * middle;
+                    (q.y > collider.height(q.x, q.z) ? low : high) = middle;
+                }
+                marchDistance[i] = high;
+                marchHits++;
+                break;
+            }
+        }
+    });
+    for (int i = 0; i < rays; i++) {
+        // Marching can step over thin peaks, only rays it found are compared
+        if (marchDistance[i] >= 0.0f && std::abs(marchDistance[i] - pyramidDistance[i]) > 1e-2f) mismatches++;
+    }
+    std::cout << "Heightfield raycast (" << rays << " rays, " << collider.getLevelCount() << " levels): pyramid "
+              << pyramidMs << " ms (" << pyramidHits << " hits), ray march " << marchMs << " ms ("
+              << marchHits << " hits, " << mismatches << " mismatches)\n";
+
+    // Falling spheres swept one second down
+    int sweepHits = 0;
+    float sweepMs = ppgso::averageTime(1, [&](int) {
+        sweepHits = 0;
+        for (int i = 0; i < rays; i++) {
+            Hit hit;
+            sweepHits += collider.sweepSphere(origins[i], 1.0f, glm::vec3(0.0f, -maxDistance, 0.0f), hit);
+        }
+    });
+    std::cout << "Heightfield sphere sweep (" << rays << " spheres): " << sweepMs << " ms ("
+              << sweepHits << " hits)\n";
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "../physics/collision.h"
+
+class Terrain;
+
+/*!
+ * Collision shape over the height grid of a Terrain.
+ *
+ * The surface is made of the same two triangles per cell as the terrain mesh
+ * (split along the (x + 1, z) - (x, z + 1) diagonal), so queries agree with what is
+ * drawn and every triangle has an exact normal. Heights are copied into one
+ * contiguous array, outside the grid the edge vertices are clamped.
+ *
+ * A min/max pyramid over the cells (level 0 = one cell, every level halves both
+ * sides) lets rays and swept spheres skip whole blocks of cells whose height range
+ * they miss. Traversal goes front to back, so the first triangle hit usually ends it.
+ *
+ * Height and normal queries for many points are batched: blocks of points are
+ * spread over OpenMP threads and every point is a few loads and multiplies.
+ * Sphere contacts implement ppgso::Collider for the physics world.
+ *
+ * sync() follows the grid revision of the terrain: a single change since the last
+ * sync (e.g. Terrain::setHeights) copies only its rectangle, more copy everything.
+ */
+class HeightfieldCollider : public ppgso::Collider {
+public:
+    struct Hit {
+        float distance;        // Along the ray (world units) or fraction of the sweep
+        glm::vec3 position;    // Hit point on the surface
+        glm::vec3 normal;      // Surface normal, or direction from the surface to the sphere centre
+    };
+
+    explicit HeightfieldCollider(const Terrain &terrain);
+
+    // Copies heights changed since the last sync, returns true if there were any
+    bool sync();
+
+    // Copies all heights / heights of a vertex rectangle (inclusive) and updates the pyramid
+    void rebuild();
+    void rebuildRegion(int x0, int z0, int x1, int z1);
+
+    // Single point queries
+    float height(float x, float z) const;
+    glm::vec3 normal(float x, float z) const;
+
+    // Batched queries for count points given as separate x and z arrays
+    void heights(const float *x, const float *z, float *outHeight, int count, bool parallel = true) const;
+    void heightsAndNormals(const float *x, const float *z, float *outHeight, glm::vec3 *outNormal,
+                           int count, bool parallel = true) const;
+
+    // Raises every position that is less than offset above the ground to ground + offset
+    void clampToGround(glm::vec3 *positions, int count, float offset = 0.0f, bool parallel = true) const;
+
+    // First hit of the ray within maxDistance (direction does not have to be normalized)
+    bool raycast(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance, Hit &hit) const;
+
+    // First contact of a sphere moved by displacement, hit.distance is the fraction of the move
+    bool sweepSphere(const glm::vec3 &center, float radius, const glm::vec3 &displacement, Hit &hit) const;
+
+    // Sphere contacts for the physics world, bodies outside the grid get none
+    void collide(const ppgso::RigidBodyStore &bodies, const std::vector<uint32_t> &slots,
+                 std::vector<ppgso::Contact> &contacts) const override;
+
+    int getLevelCount() const { return (int)levels.size(); }
+
+    // Whether the point lies over the grid, at least margin inside its edges
+    bool contains(float x, float z, float margin = 0.0f) const {
+        float end = origin + cells * cellSize - margin;
+        return x >= origin + margin && x <= end && z >= origin + margin && z <= end;
+    }
+
+    // Compares batched and per point ground heights, pyramid raycasts with ray marching
+    // and prints the times for `count` points and rays over the terrain
+    static void benchmark(const Terrain &terrain, int count = 10000);
+
+private:
+    const Terrain &terrain;
+    unsigned int revision;          // Terrain grid revision of the copied heights
+
+    int cells = 0;                  // Cells per side, the grid has cells + 1 vertices per side
+    float cellSize = 1.0f;
+    float origin = 0.0f;            // World x and z of vertex 0
+    std::vector<float> heightData;  // (cells + 1)^2, row major in z
+
+    struct Level {
+        int width;                  // Nodes per side
+        std::vector<float> minimum, maximum;
+    };
+    std::vector<Level> levels;
+
+    float vertexHeight(int x, int z) const { return heightData[(size_t)z * (cells + 1) + x]; }
+
+    // Height and gradient of the triangle under a point (coordinates clamped to the grid)
+    void sample(float x, float z, float &h, float &gradientX, float &gradientZ) const;
+
+    void updatePyramid(int x0, int z0, int x1, int z1);
+
+    // Front to back walk of the pyramid along origin + t * direction for t in [0, tMax],
+    // boxes grown by `inflate`. testCell(x, z, tBest) returns a closer t or tBest.
+    template<typename TestCell>
+    float traverse(const glm::vec3 &origin, const glm::vec3 &direction, float tMax, float inflate,
+                   TestCell testCell) const;
+
+    // Corners of the two triangles of a cell
+    void cellTriangles(int x, int z, glm::vec3 corners[2][3]) const;
+};
@@ -0,0 +1,271 @@
+#include "Noise.h"
+#include <cmath>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace noise {
+
+// ===================== Scalar fallback =========================
+
+static inline float fade(float t) {
+    return t * t * t * (t * (t * 6 - 15) + 10);
+}
+
+static inline float lerp(float t, float a, float b) {
+    return a + t * (b - a);
+}
+
+static inline float grad(int hash, float x, float y) {
+    int h = hash & 7;
+    float u = h < 4 ? x : y;
+    float v = h < 4 ? y : x;
+    return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+}
+
+static inline float perlinScalar(const int *p, float x, float y) {
+    float fx = std::floor(x);
+    float fy = std::floor(y);
+    int X = (int)fx & 255;
+    int Y = (int)fy & 255;
+
+    x -= fx;
+    y -= fy;
+
+    float u = fade(x);
+    float v = fade(y);
+
+    int A  = p[X] + Y;
+    int AA = p[A];
+    int AB = p[A + 1];
+    int B  = p[X + 1] + Y;
+    int BA = p[B];
+    int BB = p[B + 1];
+
+    return lerp(v,
+        lerp(u, grad(p[AA], x, y),
+                grad(p[BA], x - 1, y)),
+        lerp(u, grad(p[AB], x, y - 1),
+                grad(p[BB], x - 1, y - 1))
+    );
+}
+
+static inline float fbmScalar(const int *p, float x, float y, int octaves, float frequency) {
+    float value = 0.f;
+    float amplitude = 0.5f;
+
+    for (int i = 0; i < octaves; i++) {
+        value += amplitude * perlinScalar(p, x * frequency, y * frequency);
+        frequency *= 2.f;
+        amplitude *= 0.5f;
+    }
+
+    return value;
+}
+
+static inline float ridgedScalar(const int *p, float x, float y, int octaves, float frequency) {
+    float h = fbmScalar(p, x, y, octaves, frequency);
+    h = 1.f - std::fabs(h);
+    return h * h;
+}
+
+// ===================== Vector kernels =========================
+//
+// The kernels are written once against the small Vec wrapper below, which is
+// defined for AVX2 or SSE2 depending on the target. They mirror the scalar code
+// above operation by operation, so results match it up to floating point contraction.
+
+#if defined(__AVX2__)
+#define NOISE_HAS_VEC 1
+
+struct Vec {
+    using F = __m256;
+    using I = __m256i;
+    static const int WIDTH = 8;
+
+    static F load(const float *p) { return _mm256_loadu_ps(p); }
+    static void store(float *p, F v) { _mm256_storeu_ps(p, v); }
+    static F set(float v) { return _mm256_set1_ps(v); }
+    static I seti(int v) { return _mm256_set1_epi32(v); }
+
+    static F add(F a, F b) { return _mm256_add_ps(a, b); }
+    static F sub(F a, F b) { return _mm256_sub_ps(a, b); }
+    static F mul(F a, F b) { return _mm256_mul_ps(a, b); }
+    static F floor(F a) { return _mm256_floor_ps(a); }
+    static F abs(F a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static F select(F mask, F a, F b) { return _mm256_blendv_ps(b, a, mask); }
+    static F flipSign(F a, I bit) { return _mm256_xor_ps(a, _mm256_castsi256_ps(bit)); }
+
+    static I toInt(F a) { return _mm256_cvttps_epi32(a); }
+    static I addi(I a, I b) { return _mm256_add_epi32(a, b); }
+    static I andi(I a, I b) { return _mm256_and_si256(a, b); }
+    static I shli(I a, int n) { return _mm256_slli_epi32(a, n); }
+    static F lessThan(I a, I b) { return _mm256_castsi256_ps(_mm256_cmpgt_epi32(b, a)); }
+    static I gather(const int *table, I idx) { return _mm256_i32gather_epi32(table, idx, 4); }
+};
+
+#elif defined(__SSE2__) || defined(_M_X64)
+#define NOISE_HAS_VEC 1
+
+struct Vec {
+    using F = __m128;
+    using I = __m128i;
+    static const int WIDTH = 4;
+
+    static F load(const float *p) { return _mm_loadu_ps(p); }
+    static void store(float *p, F v) { _mm_storeu_ps(p, v); }
+    static F set(float v) { return _mm_set1_ps(v); }
+    static I seti(int v) { return _mm_set1_epi32(v); }
+
+    static F add(F a, F b) { return _mm_add_ps(a, b); }
+    static F sub(F a, F b) { return _mm_sub_ps(a, b); }
+    static F mul(F a, F b) { return _mm_mul_ps(a, b); }
+    static F abs(F a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static F select(F mask, F a, F b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+    static F flipSign(F a, I bit) { return _mm_xor_ps(a, _mm_castsi128_ps(bit)); }
+
+    // SSE2 has no floor instruction: truncate and step down for negative fractions
+    static F floor(F a) {
+        F t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+        return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a), _mm_set1_ps(1.0f)));
+    }
+
+    static I toInt(F a) { return _mm_cvttps_epi32(a); }
+    static I addi(I a, I b) { return _mm_add_epi32(a, b); }
+    static I andi(I a, I b) { return _mm_and_si128(a, b); }
+    static I shli(I a, int n) { return _mm_slli_epi32(a, n); }
+    static F lessThan(I a, I b) { return _mm_castsi128_ps(_mm_cmplt_epi32(a, b)); }
+
+    // No gather on SSE2, the table lookups are done lane by lane
+    static I gather(const int *table, I idx) {
+        alignas(16) int lanes[4];
+        _mm_store_si128((I *)lanes, idx);
+        return _mm_set_epi32(table[lanes[3]], table[lanes[2]], table[lanes[1]], table[lanes[0]]);
+    }
+};
+
+#endif
+
+#ifdef NOISE_HAS_VEC
+
+static inline Vec::F fadeV(Vec::F t) {
+    Vec::F t3 = Vec::mul(Vec::mul(t, t), t);
+    Vec::F inner = Vec::add(Vec::mul(t, Vec::sub(Vec::mul(t, Vec::set(6.0f)), Vec::set(15.0f))), Vec::set(10.0f));
+    return Vec::mul(t3, inner);
+}
+
+static inline Vec::F lerpV(Vec::F t, Vec::F a, Vec::F b) {
+    return Vec::add(a, Vec::mul(t, Vec::sub(b, a)));
+}
+
+static inline Vec::F gradV(Vec::I hash, Vec::F x, Vec::F y) {
+    Vec::I h = Vec::andi(hash, Vec::seti(7));
+    Vec::F low = Vec::lessThan(h, Vec::seti(4));
+    Vec::F u = Vec::select(low, x, y);
+    Vec::F v = Vec::select(low, y, x);
+
+    // Bit 0 negates u, bit 1 negates v: move them into the float sign bit
+    u = Vec::flipSign(u, Vec::shli(Vec::andi(h, Vec::seti(1)), 31));
+    v = Vec::flipSign(v, Vec::shli(Vec::andi(h, Vec::seti(2)), 30));
+    return Vec::add(u, v);
+}
+
+static inline Vec::F perlinV(const int *p, Vec::F x, Vec::F y) {
+    Vec::F fx = Vec::floor(x);
+    Vec::F fy = Vec::floor(y);
+    Vec::I X = Vec::andi(Vec::toInt(fx), Vec::seti(255));
+    Vec::I Y = Vec::andi(Vec::toInt(fy), Vec::seti(255));
+
+    x = Vec::sub(x, fx);
+    y = Vec::sub(y, fy);
+
+    Vec::F u = fadeV(x);
+    Vec::F v = fadeV(y);
+
+    Vec::I one = Vec::seti(1);
+    Vec::I A  = Vec::addi(Vec::gather(p, X), Y);
+    Vec::I AA = Vec::gather(p, A);
+    Vec::I AB = Vec::gather(p, Vec::addi(A, one));
+    Vec::I B  = Vec::addi(Vec::gather(p, Vec::addi(X, one)), Y);
+    Vec::I BA = Vec::gather(p, B);
+    Vec::I BB = Vec::gather(p, Vec::addi(B, one));
+
+    Vec::F x1 = Vec::sub(x, Vec::set(1.0f));
+    Vec::F y1 = Vec::sub(y, Vec::set(1.0f));
+
+    return lerpV(v,
+        lerpV(u, gradV(Vec::gather(p, AA), x, y),
+                 gradV(Vec::gather(p, BA), x1, y)),
+        lerpV(u, gradV(Vec::gather(p, AB), x, y1),
+                 gradV(Vec::gather(p, BB), x1, y1))
+    );
+}
+
+static inline Vec::F fbmV(const int *p, Vec::F x, Vec::F y, int octaves, float frequency) {
+    Vec::F value = Vec::set(0.f);
+    float amplitude = 0.5f;
+
+    for (int i = 0; i < octaves; i++) {
+        Vec::F f = Vec::set(frequency);
+        value = Vec::add(value, Vec::mul(Vec::set(amplitude), perlinV(p, Vec::mul(x, f), Vec::mul(y, f))));
+        frequency *= 2.f;
+        amplitude *= 0.5f;
+    }
+
+    return value;
+}
+
+#endif
+
+// ===================== Public API =========================
+
+int batchWidth() {
+#ifdef NOISE_HAS_VEC
+    return Vec::WIDTH;
+#else
+    return 1;
+#endif
+}
+
+void perlin(const int *perm, const float *x, const float *y, float *out, int count) {
+    int i = 0;
+#ifdef NOISE_HAS_VEC
+    for (; i + Vec::WIDTH <= count; i += Vec::WIDTH) {
+        Vec::store(out + i, perlinV(perm, Vec::load(x + i), Vec::load(y + i)));
+    }
+#endif
+    for (; i < count; i++) {
+        out[i] = perlinScalar(perm, x[i], y[i]);
+    }
+}
+
+void fbm(const int *perm, const float *x, const float *y, float *out,
+         int count, int octaves, float frequency) {
+    int i = 0;
+#ifdef NOISE_HAS_VEC
+    for (; i + Vec::WIDTH <= count; i += Vec::WIDTH) {
+        Vec::store(out + i, fbmV(perm, Vec::load(x + i), Vec::load(y + i), octaves, frequency));
+    }
+#endif
+    for (; i < count; i++) {
+        out[i] = fbmScalar(perm, x[i], y[i], octaves, frequency);
+    }
+}
+
+void ridged(const int *perm, const float *x, const float *y, float *out,
+            int count, int octaves, float frequency) {
+    int i = 0;
+#ifdef NOISE_HAS_VEC
+    for (; i + Vec::WIDTH <= count; i += Vec::WIDTH) {
+        Vec::F h = fbmV(perm, Vec::load(x + i), Vec::load(y + i), octaves, frequency);
+        h = Vec::sub(Vec::set(1.f), Vec::abs(h));
+        Vec::store(out + i, Vec::mul(h, h));
+    }
+#endif
+    for (; i < count; i++) {
+        out[i] = ridgedScalar(perm, x[i], y[i], octaves, frequency);
+    }
+}
+
+}
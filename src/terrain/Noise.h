@@ -0,0 +1,30 @@
+#pragma once
+
+/*!
+ * Batched gradient noise used by terrain generation.
+ *
+ * Every function evaluates `count` sample points stored as separate x/y arrays.
+ * Points are processed 8 at a time with AVX2, 4 at a time with SSE2, and the
+ * remainder (or everything, on other targets) with a scalar fallback that follows
+ * Terrain::perlin / fbm / ridged operation by operation.
+ *
+ * The permutation table must hold 512 entries (256 values repeated twice),
+ * exactly like Terrain::permutation.
+ */
+namespace noise {
+
+    // Number of points evaluated by one vector kernel call (1 for the scalar fallback)
+    int batchWidth();
+
+    // Classic 2D Perlin noise
+    void perlin(const int *perm, const float *x, const float *y, float *out, int count);
+
+    // Fractal Brownian motion, amplitude starts at 0.5 and halves every octave
+    void fbm(const int *perm, const float *x, const float *y, float *out,
+             int count, int octaves, float frequency);
+
+    // Ridged noise: (1 - |fbm|)^2
+    void ridged(const int *perm, const float *x, const float *y, float *out,
+                int count, int octaves, float frequency);
+
+}
@@ -1,8 +1,10 @@
 #include "Terrain.h"
+#include "Noise.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
 #include <algorithm>
 #include <random>
+#include <chrono>
 
 #include <shaders/terrain_vert_glsl.h>
 #include <shaders/terrain_frag_glsl.h>
@@ -11,6 +13,7 @@
 std::unique_ptr<ppgso::Shader> Terrain::shader;
 int Terrain::instanceCount = 0;
 std::vector<int> Terrain::permutation;
+std::map<int, Terrain::SharedIndexBuffer> Terrain::indexBuffers;
 
 Terrain::Terrain(int resolution, float size, float height, TerrainType type)
         : resolution(resolution), size(size), maxHeight(height), type(type) {
@@ -38,7 +41,24 @@ Terrain::Terrain(int resolution, float size, float height, TerrainType type)
 
     initVoronoiCells();
     generateGrid();
-    computeNormals();
+    computeNormals(0, 0, resolution, resolution);
+
+#ifndef NDEBUG
+    // Batched noise must agree with the scalar reference implementation
+    float noiseError = measureNoiseError();
+    if (noiseError > NOISE_TOLERANCE) {
+        std::cerr << "Terrain: batched noise deviates from scalar reference by " << noiseError << "\n";
+    }
+
+    // Grid normals must agree with the face averaged normals of the mesh
+    float normalError = measureNormalError();
+    if (normalError > gridnormals::TOLERANCE) {
+        std::cerr << "Terrain: grid normals deviate from face averaged normals by " << normalError << "\n";
+    }
+#endif
+
+    std::cout << "Terrain generated in " << lastGenerationTime << " ms"
+              << (parallelGeneration ? " (parallel)" : " (serial)") << "\n";
 
     // Setup OpenGL buffers
     glGenVertexArrays(1, &vao);
@@ -47,14 +67,14 @@ Terrain::Terrain(int resolution, float size, float height, TerrainType type)
     glGenBuffers(1, &vbo);
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
     glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec3),
-                 positions.data(), GL_STATIC_DRAW);
+                 positions.data(), GL_DYNAMIC_DRAW);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
 
     glGenBuffers(1, &nbo);
     glBindBuffer(GL_ARRAY_BUFFER, nbo);
     glBufferData(GL_ARRAY_BUFFER, normals.size() * sizeof(glm::vec3),
-                 normals.data(), GL_STATIC_DRAW);
+                 normals.data(), GL_DYNAMIC_DRAW);
     glEnableVertexAttribArray(1);
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
 
@@ -65,12 +85,7 @@ Terrain::Terrain(int resolution, float size, float height, TerrainType type)
     glEnableVertexAttribArray(2);
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
 
-    glGenBuffers(1, &ebo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int),
-                 indices.data(), GL_STATIC_DRAW);
-
-    indexCount = indices.size();
+    acquireIndexBuffer();
 }
 
 Terrain::~Terrain() {
@@ -78,7 +93,7 @@ Terrain::~Terrain() {
     glDeleteBuffers(1, &vbo);
     glDeleteBuffers(1, &nbo);
     glDeleteBuffers(1, &tbo);
-    glDeleteBuffers(1, &ebo);
+    releaseIndexBuffer();
 
     instanceCount--;
 
@@ -191,6 +206,10 @@ float Terrain::canyon(float x, float y) {
     float base = fbm(x * 0.02f, y * 0.02f, 4);
     float detail = fbm(x * 0.1f, y * 0.1f, 3);
 
+    return canyonShape(x, base, detail);
+}
+
+float Terrain::canyonShape(float x, float base, float detail) {
     float channel = sin(x * 0.05f + detail * 2.0f) * 0.5f + 0.5f;
     channel = pow(channel, 3.0f);
 
@@ -199,11 +218,16 @@ float Terrain::canyon(float x, float y) {
 
 float Terrain::plateaus(float x, float y) {
     float h = fbm(x * 0.03f, y * 0.03f, 5);
+    float detail = fbm(x * 0.2f, y * 0.2f, 2);
 
+    return plateauShape(h, detail);
+}
+
+float Terrain::plateauShape(float h, float detail) {
     const int steps = 5;
     h = floor(h * steps) / steps;
 
-    h += fbm(x * 0.2f, y * 0.2f, 2) * 0.1f;
+    h += detail * 0.1f;
 
     return h;
 }
@@ -211,17 +235,22 @@ float Terrain::plateaus(float x, float y) {
 // ===================== Unified Island Generation =========================
 
 float Terrain::islandMask(float x, float y) {
+    // Create organic island shape using noise
+    float angle = atan2(y / size, x / size);
+
+    // Large-scale shape variation (makes island non-circular)
+    return islandMaskShape(x, y, perlin(angle * 2.0f, 0.0f), perlin(angle * 5.0f, 100.0f));
+}
+
+float Terrain::islandMaskShape(float x, float y, float shapeLow, float shapeHigh) {
     // Convert to normalized coordinates
     float nx = x / size;
     float ny = y / size;
     float distFromCenter = sqrt(nx * nx + ny * ny);
 
-    // Create organic island shape using noise
-    float angle = atan2(ny, nx);
-
     // Large-scale shape variation (makes island non-circular)
-    float shapeNoise = perlin(angle * 2.0f, 0.0f) * 0.15f;
-    shapeNoise += perlin(angle * 5.0f, 100.0f) * 0.08f;
+    float shapeNoise = shapeLow * 0.15f;
+    shapeNoise += shapeHigh * 0.08f;
 
     // Adjust distance based on shape noise
     float adjustedDist = distFromCenter - shapeNoise;
@@ -238,13 +267,16 @@ float Terrain::islandMask(float x, float y) {
 
 float Terrain::coastlineVariation(float x, float y) {
     // Single coherent noise for coastal features
-    float nx = x / size;
-    float ny = y / size;
-    float angle = atan2(ny, nx);
+    float angle = atan2(y / size, x / size);
 
+    return coastlineShape(perlin(angle * 3.0f + 50.0f, 0.0f),
+                          perlin(angle * 7.0f + 150.0f, 100.0f));
+}
+
+float Terrain::coastlineShape(float coastLow, float coastHigh) {
     // Coastal type variation (smooth, continuous)
-    float coastal = perlin(angle * 3.0f + 50.0f, 0.0f) * 0.5f + 0.5f;
-    coastal += perlin(angle * 7.0f + 150.0f, 100.0f) * 0.25f;
+    float coastal = coastLow * 0.5f + 0.5f;
+    coastal += coastHigh * 0.25f;
 
     return glm::clamp(coastal, 0.f, 1.f);
 }
@@ -257,41 +289,50 @@ float Terrain::erosionFilter(float height, float slope) {
 // ===================== MAIN HEIGHT FUNCTION =========================
 
 float Terrain::finalHeight(float x, float y) {
-    // Normalized position
-    float nx = x / size;
-    float ny = y / size;
-    float distFromCenter = sqrt(nx * nx + ny * ny);
-
     // Get island shape mask (handles non-circular shape)
     float islandShape = islandMask(x, y);
 
-    // Base terrain using selected type
-    float baseNoise = 0.f;
-    switch (type) {
-        case TerrainType::ISLAND:
-            baseNoise = fbm(x * 0.04f, y * 0.04f, 6);
-            break;
-        case TerrainType::RIDGED:
-            baseNoise = ridged(x * 0.03f, y * 0.03f);
-            break;
-        case TerrainType::VORONOI:
-            baseNoise = voronoi(x, y);
-            break;
-        case TerrainType::CANYON:
-            baseNoise = canyon(x, y);
-            break;
-        case TerrainType::PLATEAUS:
-            baseNoise = plateaus(x, y);
-            break;
+    // Coastal variation (determines beach vs cliff)
+    float coastType = coastlineVariation(x, y);
+
+    // Only evaluate the expensive layers where composeHeight reads them (as finalHeightRow)
+    float baseNoise = 0.f, rockNoise = 0.f, detailNoise = 0.f;
+    if (islandShape >= 0.40f) {
+        // Base terrain using selected type
+        switch (type) {
+            case TerrainType::ISLAND:
+                baseNoise = fbm(x * 0.04f, y * 0.04f, 6);
+                break;
+            case TerrainType::RIDGED:
+                baseNoise = ridged(x * 0.03f, y * 0.03f);
+                break;
+            case TerrainType::VORONOI:
+                baseNoise = voronoi(x, y);
+                break;
+            case TerrainType::CANYON:
+                baseNoise = canyon(x, y);
+                break;
+            case TerrainType::PLATEAUS:
+                baseNoise = plateaus(x, y);
+                break;
+        }
+
+        // Detail layer for inland terrain
+        detailNoise = fbm(x * 0.12f, y * 0.12f, 3);
+    } else if (islandShape >= 0.25f && !(coastType > 0.55f)) {
+        // Rocky texture for cliffs
+        rockNoise = fbm(x * 0.25f, y * 0.25f, 3);
     }
 
+    return composeHeight(x, y, islandShape, coastType, baseNoise, rockNoise, detailNoise);
+}
+
+float Terrain::composeHeight(float x, float y, float islandShape, float coastType,
+                             float baseNoise, float rockNoise, float detailNoise) {
     // Normalize base noise to 0-1 range
     baseNoise = (baseNoise + 1.0f) * 0.5f;
     baseNoise = glm::clamp(baseNoise, 0.f, 1.f);
 
-    // Coastal variation (determines beach vs cliff)
-    float coastType = coastlineVariation(x, y);
-
     // === HEIGHT PROFILE ===
 
     // Ocean floor depth
@@ -328,8 +369,7 @@ float Terrain::finalHeight(float x, float y) {
             elevation = glm::mix(-3.0f, 5.0f, glm::pow(t, 3.0f));
 
             // Rocky texture for cliffs
-            float rockDetail = fbm(x * 0.25f, y * 0.25f, 3) * 1.2f;
-            elevation += rockDetail;
+            elevation += rockNoise * 1.2f;
         }
     }
     else {
@@ -347,7 +387,7 @@ float Terrain::finalHeight(float x, float y) {
         elevation = glm::mix(coastalHeight, terrainHeight, glm::pow(t, 0.7f));
 
         // Add detail layers
-        elevation += fbm(x * 0.12f, y * 0.12f, 3) * 2.5f * t;
+        elevation += detailNoise * 2.5f * t;
 
         // Central peak/crater
         if (islandShape > 0.85f) {
@@ -366,6 +406,126 @@ float Terrain::finalHeight(float x, float y) {
     return elevation;
 }
 
+void Terrain::finalHeightRow(const float *xs, float y, float *out, int count, NoiseRow &row) {
+    const int *perm = permutation.data();
+
+    row.resize(count);
+
+    // Island outline and coast type only depend on the polar angle
+    for (int i = 0; i < count; i++) {
+        float angle = atan2(y / size, xs[i] / size);
+        row.in0[i] = angle * 2.0f;
+        row.in1[i] = angle * 5.0f;
+        row.in2[i] = angle * 3.0f + 50.0f;
+        row.in3[i] = angle * 7.0f + 150.0f;
+        row.zero[i] = 0.0f;
+        row.hundred[i] = 100.0f;
+    }
+
+    noise::perlin(perm, row.in0.data(), row.zero.data(), row.out0.data(), count);
+    noise::perlin(perm, row.in1.data(), row.hundred.data(), row.out1.data(), count);
+    noise::perlin(perm, row.in2.data(), row.zero.data(), row.out2.data(), count);
+    noise::perlin(perm, row.in3.data(), row.hundred.data(), row.out3.data(), count);
+
+    row.inland.clear();
+    row.cliffs.clear();
+    for (int i = 0; i < count; i++) {
+        row.shape[i] = islandMaskShape(xs[i], y, row.out0[i], row.out1[i]);
+        row.coast[i] = coastlineShape(row.out2[i], row.out3[i]);
+        row.base[i] = row.rock[i] = row.detail[i] = 0.0f;
+
+        // Only evaluate the expensive layers where composeHeight reads them
+        if (row.shape[i] >= 0.40f) {
+            row.inland.push_back(i);
+        } else if (row.shape[i] >= 0.25f && !(row.coast[i] > 0.55f)) {
+            row.cliffs.push_back(i);
+        }
+    }
+
+    // Batched fBm over a subset of the row, scattered back into target
+    auto sampleFbm = [&](const std::vector<int> &subset, float scale, int octaves, bool isRidged,
+                         std::vector<float> &target) {
+        int n = (int)subset.size();
+        for (int j = 0; j < n; j++) {
+            row.in0[j] = xs[subset[j]] * scale;
+            row.in1[j] = y * scale;
+        }
+        if (isRidged) {
+            noise::ridged(perm, row.in0.data(), row.in1.data(), row.out0.data(), n, octaves, noiseFrequency);
+        } else {
+            noise::fbm(perm, row.in0.data(), row.in1.data(), row.out0.data(), n, octaves, noiseFrequency);
+        }
+        for (int j = 0; j < n; j++) {
+            target[subset[j]] = row.out0[j];
+        }
+    };
+
+    switch (type) {
+        case TerrainType::ISLAND:
+            sampleFbm(row.inland, 0.04f, 6, false, row.base);
+            break;
+        case TerrainType::RIDGED:
+            sampleFbm(row.inland, 0.03f, 6, true, row.base);
+            break;
+        case TerrainType::VORONOI:
+            for (int i : row.inland) row.base[i] = voronoi(xs[i], y);
+            break;
+        case TerrainType::CANYON:
+            sampleFbm(row.inland, 0.02f, 4, false, row.base);
+            sampleFbm(row.inland, 0.1f, 3, false, row.extra);
+            for (int i : row.inland) row.base[i] = canyonShape(xs[i], row.base[i], row.extra[i]);
+            break;
+        case TerrainType::PLATEAUS:
+            sampleFbm(row.inland, 0.03f, 5, false, row.base);
+            sampleFbm(row.inland, 0.2f, 2, false, row.extra);
+            for (int i : row.inland) row.base[i] = plateauShape(row.base[i], row.extra[i]);
+            break;
+    }
+
+    sampleFbm(row.cliffs, 0.25f, 3, false, row.rock);
+    sampleFbm(row.inland, 0.12f, 3, false, row.detail);
+
+    for (int i = 0; i < count; i++) {
+        out[i] = composeHeight(xs[i], y, row.shape[i], row.coast[i], row.base[i], row.rock[i], row.detail[i]);
+    }
+}
+
+void Terrain::sampleHeightRow(const float *xs, float worldZ, float *out, int count) {
+    // Every thread keeps its own scratch row so callers can sample in parallel
+    static thread_local NoiseRow row;
+    finalHeightRow(xs, worldZ, out, count, row);
+}
+
+void Terrain::NoiseRow::resize(int count) {
+    for (auto *v : {&in0, &in1, &in2, &in3, &zero, &hundred, &out0, &out1, &out2, &out3,
+                    &shape, &coast, &base, &rock, &detail, &extra}) {
+        v->resize(count);
+    }
+}
+
+float Terrain::measureNoiseError(int sampleRows) {
+    const int rowSize = resolution + 1;
+    std::vector<float> xs(rowSize), heights(rowSize);
+    NoiseRow row;
+
+    for (int x = 0; x <= resolution; x++) {
+        xs[x] = ((float)x / resolution - 0.5f) * size;
+    }
+
+    float maxError = 0.0f;
+    for (int r = 0; r < sampleRows; r++) {
+        int z = r * resolution / std::max(sampleRows - 1, 1);
+        float wz = ((float)z / resolution - 0.5f) * size;
+
+        finalHeightRow(xs.data(), wz, heights.data(), rowSize, row);
+        for (int x = 0; x <= resolution; x++) {
+            maxError = std::max(maxError, std::abs(heights[x] - finalHeight(xs[x], wz)));
+        }
+    }
+
+    return maxError;
+}
+
 float Terrain::getHeightAt(float worldX, float worldZ) const {
     float fx = (worldX / size + 0.5f) * resolution;
     float fz = (worldZ / size + 0.5f) * resolution;
@@ -400,80 +560,151 @@ float Terrain::getHeightAt(float worldX, float worldZ) const {
 // ===================== Mesh Generation =========================
 
 void Terrain::generateGrid() {
-    positions.clear();
-    normals.clear();
-    uvs.clear();
-    indices.clear();
+    const int rowSize = resolution + 1;
+    const int vertexCount = rowSize * rowSize;
 
+    positions.resize(vertexCount);
+    uvs.resize(vertexCount);
+    normals.resize(vertexCount);
+
+    // Static layout - x/z coordinates and UVs never change after construction
+    #pragma omp parallel for if(parallelGeneration)
     for (int z = 0; z <= resolution; z++) {
+        float fz = (float)z / resolution;
+        float wz = (fz - 0.5f) * size;
+
         for (int x = 0; x <= resolution; x++) {
             float fx = (float)x / resolution;
-            float fz = (float)z / resolution;
-            float wx = (fx - 0.5f) * size;
-            float wz = (fz - 0.5f) * size;
-            float wy = finalHeight(wx, wz);
-
-            positions.push_back({wx, wy, wz});
-            uvs.push_back({fx, fz});
+            int idx = z * rowSize + x;
+            positions[idx] = {(fx - 0.5f) * size, 0.0f, wz};
+            uvs[idx] = {fx, fz};
         }
     }
 
-    for (int z = 0; z < resolution; z++) {
-        for (int x = 0; x < resolution; x++) {
-            int i0 = z * (resolution + 1) + x;
-            int i1 = i0 + 1;
-            int i2 = i0 + (resolution + 1);
-            int i3 = i2 + 1;
+    generateHeights(0, 0, resolution, resolution);
+}
+
+void Terrain::generateHeights(int x0, int z0, int x1, int z1) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    const int rowSize = resolution + 1;
+    const int count = x1 - x0 + 1;
+    const int rows = z1 - z0 + 1;
+
+    // World-space x coordinates are shared by every row
+    std::vector<float> xs(count);
+    for (int i = 0; i < count; i++) {
+        xs[i] = positions[x0 + i].x;
+    }
+
+    // Rows are evaluated with the batched noise kernels, every row is
+    // independent, so row tiles can run on any thread and give the same result
+    const int tileCount = (rows + TILE_ROWS - 1) / TILE_ROWS;
 
-            indices.push_back(i0); indices.push_back(i2); indices.push_back(i1);
-            indices.push_back(i1); indices.push_back(i2); indices.push_back(i3);
+    #pragma omp parallel for schedule(dynamic) if(parallelGeneration)
+    for (int tile = 0; tile < tileCount; tile++) {
+        int zEnd = std::min(z0 + (tile + 1) * TILE_ROWS, z1 + 1);
+        std::vector<float> heights(count);
+        NoiseRow row;
+
+        for (int z = z0 + tile * TILE_ROWS; z < zEnd; z++) {
+            glm::vec3 *rowPositions = &positions[(size_t)z * rowSize + x0];
+            finalHeightRow(xs.data(), rowPositions[0].z, heights.data(), count, row);
+
+            for (int i = 0; i < count; i++) {
+                rowPositions[i].y = heights[i];
+            }
         }
     }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    lastGenerationTime = std::chrono::duration<float, std::milli>(end - start).count();
 }
 
-void Terrain::computeNormals() {
-    normals.resize(positions.size(), glm::vec3(0.f));
+void Terrain::computeNormals(int x0, int z0, int x1, int z1) {
+    gridnormals::compute(normalGrid(), normals.data(), x0, z0, x1, z1, parallelGeneration);
+}
 
-    for (size_t i = 0; i < indices.size(); i += 3) {
-        int i0 = indices[i];
-        int i1 = indices[i + 1];
-        int i2 = indices[i + 2];
+gridnormals::Grid Terrain::normalGrid() const {
+    const float spacing = size / resolution;
+    return gridnormals::fromPositions(positions.data(), resolution + 1, resolution + 1, spacing, spacing);
+}
 
-        glm::vec3 edge1 = positions[i1] - positions[i0];
-        glm::vec3 edge2 = positions[i2] - positions[i0];
-        glm::vec3 n = glm::cross(edge1, edge2);
+float Terrain::measureNormalError() const {
+    return gridnormals::measureError(normalGrid());
+}
 
-        normals[i0] += n;
-        normals[i1] += n;
-        normals[i2] += n;
-    }
+void Terrain::uploadRegion(int x0, int z0, int x1, int z1) {
+    const int rowSize = resolution + 1;
 
-    for (auto &n : normals) {
-        float len = glm::length(n);
-        n = len > 0.0001f ? n / len : glm::vec3(0, 1, 0);
-    }
+    auto uploadRows = [&](GLuint buffer, const std::vector<glm::vec3> &data) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+        if (x0 == 0 && x1 == resolution) {
+            // Full rows are contiguous, one upload covers the whole band
+            size_t first = (size_t)z0 * rowSize;
+            size_t count = (size_t)(z1 - z0 + 1) * rowSize;
+            glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(glm::vec3),
+                            count * sizeof(glm::vec3), &data[first]);
+            return;
+        }
+
+        for (int z = z0; z <= z1; z++) {
+            size_t first = (size_t)z * rowSize + x0;
+            glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(glm::vec3),
+                            (x1 - x0 + 1) * sizeof(glm::vec3), &data[first]);
+        }
+    };
+
+    uploadRows(vbo, positions);
+    uploadRows(nbo, normals);
 }
 
-void Terrain::updateBuffers() {
-    glBindVertexArray(vao);
+void Terrain::acquireIndexBuffer() {
+    SharedIndexBuffer &shared = indexBuffers[resolution];
 
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec3),
-                 positions.data(), GL_STATIC_DRAW);
+    if (shared.users == 0) {
+        const int rowSize = resolution + 1;
+        std::vector<unsigned int> indices((size_t)resolution * resolution * 6);
 
-    glBindBuffer(GL_ARRAY_BUFFER, nbo);
-    glBufferData(GL_ARRAY_BUFFER, normals.size() * sizeof(glm::vec3),
-                 normals.data(), GL_STATIC_DRAW);
+        #pragma omp parallel for if(parallelGeneration)
+        for (int z = 0; z < resolution; z++) {
+            for (int x = 0; x < resolution; x++) {
+                int i0 = z * rowSize + x;
+                int i1 = i0 + 1;
+                int i2 = i0 + rowSize;
+                int i3 = i2 + 1;
 
-    glBindBuffer(GL_ARRAY_BUFFER, tbo);
-    glBufferData(GL_ARRAY_BUFFER, uvs.size() * sizeof(glm::vec2),
-                 uvs.data(), GL_STATIC_DRAW);
+                size_t base = ((size_t)z * resolution + x) * 6;
+                indices[base + 0] = i0; indices[base + 1] = i2; indices[base + 2] = i1;
+                indices[base + 3] = i1; indices[base + 4] = i2; indices[base + 5] = i3;
+            }
+        }
+
+        glGenBuffers(1, &shared.ebo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, shared.ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int),
+                     indices.data(), GL_STATIC_DRAW);
+        shared.count = indices.size();
+    }
+
+    shared.users++;
+    ebo = shared.ebo;
+    indexCount = shared.count;
 
+    // Attach to this terrain's VAO (bound by the caller)
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int),
-                 indices.data(), GL_STATIC_DRAW);
+}
+
+void Terrain::releaseIndexBuffer() {
+    auto it = indexBuffers.find(resolution);
+    if (it == indexBuffers.end()) return;
 
-    indexCount = indices.size();
+    if (--it->second.users == 0) {
+        glDeleteBuffers(1, &it->second.ebo);
+        indexBuffers.erase(it);
+    }
+    ebo = 0;
 }
 
 // ===================== Public API =========================
@@ -495,7 +726,55 @@ void Terrain::setNoiseFrequency(float freq) {
 }
 
 void Terrain::regenerate() {
-    generateGrid();
-    computeNormals();
-    updateBuffers();
-}
\ No newline at end of file
+    revision++;
+    regenerateRegion(0, 0, resolution, resolution);
+
+    std::cout << "Terrain regenerated in " << lastGenerationTime << " ms"
+              << (parallelGeneration ? " (parallel)" : " (serial)") << "\n";
+}
+void Terrain::regenerateRegion(int x0, int z0, int x1, int z1) {
+    x0 = std::max(x0, 0);
+    z0 = std::max(z0, 0);
+    x1 = std::min(x1, resolution);
+    z1 = std::min(z1, resolution);
+    if (x0 > x1 || z0 > z1) return;
+
+    generateHeights(x0, z0, x1, z1);
+    heightsChanged(x0, z0, x1, z1);
+}
+
+void Terrain::setHeights(int x0, int z0, int x1, int z1, const float *heights) {
+    const int width = x1 - x0 + 1;
+    int cx0 = std::max(x0, 0), cz0 = std::max(z0, 0);
+    int cx1 = std::min(x1, resolution), cz1 = std::min(z1, resolution);
+    if (cx0 > cx1 || cz0 > cz1) return;
+
+    const int rowSize = resolution + 1;
+    for (int z = cz0; z <= cz1; z++) {
+        const float *src = heights + (size_t)(z - z0) * width + (cx0 - x0);
+        glm::vec3 *dst = &positions[(size_t)z * rowSize + cx0];
+        for (int x = 0; x <= cx1 - cx0; x++) {
+            dst[x].y = src[x];
+        }
+    }
+
+    heightsChanged(cx0, cz0, cx1, cz1);
+}
+
+void Terrain::heightsChanged(int x0, int z0, int x1, int z1) {
+    // Normals one vertex outside the rectangle see the changed heights too
+    int nx0 = std::max(x0 - 1, 0), nz0 = std::max(z0 - 1, 0);
+    int nx1 = std::min(x1 + 1, resolution), nz1 = std::min(z1 + 1, resolution);
+    computeNormals(nx0, nz0, nx1, nz1);
+    uploadRegion(nx0, nz0, nx1, nz1);
+
+    gridRevision++;
+    lastChange = {x0, z0, x1, z1};
+}
+
+void Terrain::regenerateArea(float minX, float minZ, float maxX, float maxZ) {
+    auto toGrid = [&](float world) { return (world / size + 0.5f) * resolution; };
+
+    regenerateRegion((int)std::floor(toGrid(minX)), (int)std::floor(toGrid(minZ)),
+                     (int)std::ceil(toGrid(maxX)), (int)std::ceil(toGrid(maxZ)));
+}
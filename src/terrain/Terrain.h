@@ -3,7 +3,9 @@
 #include <ppgso/ppgso.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/noise.hpp>
+#include "GridNormals.h"
 #include <vector>
+#include <map>
 #include <memory>
 
 enum class TerrainType {
@@ -36,17 +38,66 @@ public:
     void setNoiseFrequency(float freq);
     void regenerate();
 
+    // Re-evaluates heights and normals inside a rectangle of grid vertices
+    // (inclusive, clamped to the grid) and uploads only the touched rows
+    void regenerateRegion(int x0, int z0, int x1, int z1);
+
+    // Same as regenerateRegion for a rectangle given in world coordinates
+    void regenerateArea(float minX, float minZ, float maxX, float maxZ);
+
+    // Writes the heights of a rectangle of grid vertices (inclusive) from a row major array
+    // of (x1 - x0 + 1) * (z1 - z0 + 1) values, for editing tools. Parts outside the grid are
+    // skipped. Only the grid changes: sampleHeightRow (and ChunkedTerrain) keep the height
+    // function, and the next regenerate overwrites the edit.
+    void setHeights(int x0, int z0, int x1, int z1, const float *heights);
+
+    // Generation mode (row tiles are spread across OpenMP threads when enabled)
+    void setParallelGeneration(bool enabled) { parallelGeneration = enabled; }
+    bool isParallelGeneration() const { return parallelGeneration; }
+
+    // Duration of the last grid generation in milliseconds
+    float getLastGenerationTime() const { return lastGenerationTime; }
+
     // Height query for collision detection
     float getHeightAt(float worldX, float worldZ) const;
 
+    // Evaluates the height function along one row of arbitrary world positions,
+    // independent of the mesh resolution. Safe to call from several threads.
+    void sampleHeightRow(const float *xs, float worldZ, float *out, int count);
+
+    float getSize() const { return size; }
+    int getResolution() const { return resolution; }
+
+    // Grid vertices, (resolution + 1)^2 row major in z (used by HeightfieldCollider)
+    const std::vector<glm::vec3> &getPositions() const { return positions; }
+
+    // Incremented every time the height function changes (type, scale, frequency)
+    unsigned int getRevision() const { return revision; }
+
+    // Incremented by every change of the grid heights (regenerate, regenerateRegion,
+    // setHeights), getLastChange is the vertex rectangle (inclusive) of the latest one.
+    // Consumers one revision behind update that rectangle, others the whole grid.
+    struct GridRegion {
+        int x0, z0, x1, z1;
+    };
+    unsigned int getGridRevision() const { return gridRevision; }
+    const GridRegion &getLastChange() const { return lastChange; }
+
+    // Largest height difference between the batched row kernels and the scalar
+    // reference path, measured over a few evenly spaced rows
+    float measureNoiseError(int sampleRows = 8);
+    static constexpr float NOISE_TOLERANCE = 1e-3f;
+
+    // Largest difference between the grid normals and face averaged mesh normals
+    float measureNormalError() const;
+
 private:
     // Mesh data
     std::vector<glm::vec3> positions;
     std::vector<glm::vec3> normals;
     std::vector<glm::vec2> uvs;
-    std::vector<unsigned int> indices;
 
-    // OpenGL buffers
+    // OpenGL buffers (ebo is shared with every terrain of the same resolution)
     GLuint vao = 0, vbo = 0, nbo = 0, tbo = 0, ebo = 0;
     size_t indexCount = 0;
 
@@ -57,6 +108,14 @@ private:
     float noiseFrequency = 1.0f;
     TerrainType type;
 
+    // Generation settings and statistics
+    bool parallelGeneration = true;
+    float lastGenerationTime = 0.0f;
+    unsigned int revision = 0;
+    unsigned int gridRevision = 0;
+    GridRegion lastChange = {0, 0, 0, 0};
+    static const int TILE_ROWS = 16;
+
     // Voronoi cell cache for consistency
     std::vector<glm::vec2> voronoiCells;
     void initVoronoiCells();
@@ -73,22 +132,52 @@ private:
     float voronoi(float x, float y);
     float canyon(float x, float y);
     float plateaus(float x, float y);
+    float canyonShape(float x, float base, float detail);
+    float plateauShape(float h, float detail);
 
-    // Masks and filters
+    // Masks and filters (the *Shape variants take precomputed noise samples)
     float islandMask(float x, float y);
+    float islandMaskShape(float x, float y, float shapeLow, float shapeHigh);
     float coastlineVariation(float x, float y);
+    float coastlineShape(float coastLow, float coastHigh);
     float erosionFilter(float height, float slope);
 
     // Permutation table for Perlin noise
     static std::vector<int> permutation;
 
-    // Final height computation
+    // Scratch arrays for evaluating one grid row with the batched noise kernels
+    struct NoiseRow {
+        std::vector<float> in0, in1, in2, in3, zero, hundred;
+        std::vector<float> out0, out1, out2, out3;
+        std::vector<float> shape, coast, base, rock, detail, extra;
+        std::vector<int> inland, cliffs;
+        void resize(int count);
+    };
+
+    // Final height computation (scalar reference and batched row version)
     float finalHeight(float x, float y);
+    void finalHeightRow(const float *xs, float y, float *out, int count, NoiseRow &row);
+    float composeHeight(float x, float y, float islandShape, float coastType,
+                        float baseNoise, float rockNoise, float detailNoise);
 
-    // Mesh generation
+    // Mesh generation. The grid topology and UVs are built once, parameter changes
+    // only re-evaluate heights and normals inside a vertex rectangle.
     void generateGrid();
-    void computeNormals();
-    void updateBuffers();
+    void generateHeights(int x0, int z0, int x1, int z1);
+    void computeNormals(int x0, int z0, int x1, int z1);
+    void heightsChanged(int x0, int z0, int x1, int z1);
+    gridnormals::Grid normalGrid() const;
+    void uploadRegion(int x0, int z0, int x1, int z1);
+
+    // Index buffers depend only on the resolution and are shared between instances
+    struct SharedIndexBuffer {
+        GLuint ebo = 0;
+        size_t count = 0;
+        int users = 0;
+    };
+    static std::map<int, SharedIndexBuffer> indexBuffers;
+    void acquireIndexBuffer();
+    void releaseIndexBuffer();
 
     // Shader (shared across all terrain instances)
     static std::unique_ptr<ppgso::Shader> shader;